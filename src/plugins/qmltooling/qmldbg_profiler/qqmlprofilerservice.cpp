@@ -410,6 +410,11 @@ void QQmlProfilerServiceImpl::messageReceived(const QByteArray &message)
         stream >> engineId;
     if (!stream.atEnd())
         stream >> features;
+
+    // Instrumenting lookups slows the application down considerably. Clients that ask for features
+    // they don't know about, and thus for everything, don't get it.
+    if (features >> MaximumProfileFeature)
+        features &= ~(quint64(1) << ProfileLookups);
     if (!stream.atEnd()) {
         stream >> flushInterval;
         m_flushTimer.setInterval(
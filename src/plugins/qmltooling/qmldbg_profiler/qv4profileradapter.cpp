@@ -7,7 +7,7 @@
 QT_BEGIN_NAMESPACE
 
 QV4ProfilerAdapter::QV4ProfilerAdapter(QQmlProfilerService *service, QV4::ExecutionEngine *engine) :
-    m_functionCallPos(0), m_memoryPos(0)
+    m_functionCallPos(0), m_memoryPos(0), m_lookupPos(0)
 {
     setService(service);
     engine->setProfiler(new QV4::Profiling::Profiler(engine));
@@ -40,7 +40,12 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
 
     while (memoryData.size() > m_memoryPos && memoryData[m_memoryPos].timestamp <= until) {
         const QV4::Profiling::MemoryAllocationProperties &props = memoryData[m_memoryPos];
-        d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
+        // GC pauses get their own message, so that clients that don't know about them don't
+        // mistake the durations for allocations.
+        if (props.type == QV4::Profiling::GarbageCollectionPause)
+            d << props.timestamp << int(GarbageCollection) << int(FullGarbageCollection) << props.size;
+        else
+            d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
         ++m_memoryPos;
         messages.append(d.squeezedData());
         d.clear();
@@ -48,27 +53,81 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
     return memoryData.size() == m_memoryPos ? -1 : memoryData[m_memoryPos].timestamp;
 }
 
+qint64 QV4ProfilerAdapter::appendLookupEvents(qint64 until, QList<QByteArray> &messages,
+                                              QQmlDebugPacket &d)
+{
+    // Make it const, so that we cannot accidentally detach it.
+    const QVector<QV4::Profiling::LookupProperties> &lookupData = m_lookupData;
+
+    while (lookupData.size() > m_lookupPos && lookupData[m_lookupPos].timestamp <= until) {
+        const QV4::Profiling::LookupProperties &props = lookupData[m_lookupPos];
+        d << props.timestamp << int(PropertyLookup) << int(props.result) << props.count
+          << static_cast<qint64>(props.id);
+
+        // The location is only sent with the first event of each lookup.
+        auto location = m_lookupLocations.find(props.id);
+        if (location != m_lookupLocations.end()) {
+            d << location->file << location->line << location->column << location->name;
+            m_lookupLocations.erase(location);
+        }
+
+        ++m_lookupPos;
+        messages.append(d.squeezedData());
+        d.clear();
+    }
+    return lookupData.size() == m_lookupPos ? -1 : lookupData[m_lookupPos].timestamp;
+}
+
+qint64 QV4ProfilerAdapter::appendEvents(qint64 until, QList<QByteArray> &messages,
+                                        QQmlDebugPacket &d)
+{
+    // Interleave memory and lookup events, so that the messages stay sorted by timestamp.
+    qint64 memoryNext = m_memoryData.size() == m_memoryPos
+            ? -1 : m_memoryData.at(m_memoryPos).timestamp;
+    qint64 lookupNext = m_lookupData.size() == m_lookupPos
+            ? -1 : m_lookupData.at(m_lookupPos).timestamp;
+
+    while ((memoryNext != -1 && memoryNext <= until) || (lookupNext != -1 && lookupNext <= until)) {
+        memoryNext = appendMemoryEvents(lookupNext == -1 ? until : qMin(lookupNext, until),
+                                        messages, d);
+        lookupNext = appendLookupEvents(memoryNext == -1 ? until : qMin(memoryNext, until),
+                                        messages, d);
+    }
+
+    if (memoryNext == -1)
+        return lookupNext;
+    return lookupNext == -1 ? memoryNext : qMin(memoryNext, lookupNext);
+}
+
 qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &messages,
                                             qint64 callNext, QQmlDebugPacket &d)
 {
-    qint64 memoryNext = -1;
+    qint64 eventNext = -1;
 
     if (callNext == -1) {
         m_functionLocations.clear();
         m_functionCallData.clear();
         m_functionCallPos = 0;
-        memoryNext = appendMemoryEvents(until, messages, d);
+        eventNext = appendEvents(until, messages, d);
     } else {
-        memoryNext = appendMemoryEvents(qMin(callNext, until), messages, d);
+        eventNext = appendEvents(qMin(callNext, until), messages, d);
     }
 
-    if (memoryNext == -1) {
+    if (m_memoryData.size() == m_memoryPos) {
         m_memoryData.clear();
         m_memoryPos = 0;
-        return callNext;
     }
 
-    return callNext == -1 ? memoryNext : qMin(callNext, memoryNext);
+    if (m_lookupData.size() == m_lookupPos) {
+        m_lookupLocations.clear();
+        m_lookupData.clear();
+        m_lookupPos = 0;
+    }
+
+    if (eventNext == -1)
+        return callNext;
+
+    return callNext == -1 ? eventNext : qMin(callNext, eventNext);
 }
 
 qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &messages)
@@ -85,7 +144,7 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
             if (m_stack.top() > until || messages.size() > s_numMessagesPerBatch)
                 return finalizeMessages(until, messages, m_stack.top(), d);
 
-            appendMemoryEvents(m_stack.top(), messages, d);
+            appendEvents(m_stack.top(), messages, d);
             d << m_stack.pop() << int(RangeEnd) << int(Javascript);
             messages.append(d.squeezedData());
             d.clear();
@@ -97,7 +156,7 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
             if (props.start > until || messages.size() > s_numMessagesPerBatch)
                 return finalizeMessages(until, messages, props.start, d);
 
-            appendMemoryEvents(props.start, messages, d);
+            appendEvents(props.start, messages, d);
             auto location = m_functionLocations.find(props.id);
 
             d << props.start << int(RangeStart) << int(Javascript) << static_cast<qint64>(props.id);
@@ -125,7 +184,9 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
 void QV4ProfilerAdapter::receiveData(
         const QV4::Profiling::FunctionLocationHash &locations,
         const QVector<QV4::Profiling::FunctionCallProperties> &functionCallData,
-        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData)
+        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData,
+        const QV4::Profiling::FunctionLocationHash &lookupLocations,
+        const QVector<QV4::Profiling::LookupProperties> &lookupData)
 {
     // In rare cases it could be that another flush or stop event is processed while data from
     // the previous one is still pending. In that case we just append the data.
@@ -144,6 +205,16 @@ void QV4ProfilerAdapter::receiveData(
     else
         m_memoryData.append(memoryData);
 
+    if (m_lookupLocations.isEmpty())
+        m_lookupLocations = lookupLocations;
+    else
+        m_lookupLocations.insert(lookupLocations);
+
+    if (m_lookupData.isEmpty())
+        m_lookupData = lookupData;
+    else
+        m_lookupData.append(lookupData);
+
     service->dataReady(this);
 }
 
@@ -155,6 +226,8 @@ quint64 QV4ProfilerAdapter::translateFeatures(quint64 qmlFeatures)
         v4Features |= (one << QV4::Profiling::FeatureFunctionCall);
     if (qmlFeatures & (one << ProfileMemory))
         v4Features |= (one << QV4::Profiling::FeatureMemoryAllocation);
+    if (qmlFeatures & (one << ProfileLookups))
+        v4Features |= (one << QV4::Profiling::FeatureLookups);
     return v4Features;
 }
 
@@ -36,7 +36,9 @@ public:
 
     void receiveData(const QV4::Profiling::FunctionLocationHash &,
                      const QVector<QV4::Profiling::FunctionCallProperties> &,
-                     const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                     const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                     const QV4::Profiling::FunctionLocationHash &,
+                     const QVector<QV4::Profiling::LookupProperties> &);
 
 Q_SIGNALS:
     void v4ProfilingEnabled(quint64 v4Features);
@@ -46,10 +48,15 @@ private:
     QV4::Profiling::FunctionLocationHash m_functionLocations;
     QVector<QV4::Profiling::FunctionCallProperties> m_functionCallData;
     QVector<QV4::Profiling::MemoryAllocationProperties> m_memoryData;
+    QV4::Profiling::FunctionLocationHash m_lookupLocations;
+    QVector<QV4::Profiling::LookupProperties> m_lookupData;
     int m_functionCallPos;
     int m_memoryPos;
+    int m_lookupPos;
     QStack<qint64> m_stack;
     qint64 appendMemoryEvents(qint64 until, QList<QByteArray> &messages, QQmlDebugPacket &d);
+    qint64 appendLookupEvents(qint64 until, QList<QByteArray> &messages, QQmlDebugPacket &d);
+    qint64 appendEvents(qint64 until, QList<QByteArray> &messages, QQmlDebugPacket &d);
     qint64 finalizeMessages(qint64 until, QList<QByteArray> &messages, qint64 callNext,
                             QQmlDebugPacket &d);
     void forwardEnabled(quint64 features);
@@ -0,0 +1,69 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4COMPILATIONUNITBUNDLE_P_H
+#define QV4COMPILATIONUNITBUNDLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4compileddata_p.h>
+
+#include <QtCore/qcryptographichash.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+namespace CompiledData {
+
+// A bundle holds the compilation units of all QML and JavaScript files in a
+// directory, so that they can be mapped with a single file. It is found by its
+// file name next to the sources.
+//
+// The file consists of the header, the index, the UTF-8 encoded file names the
+// index refers to, and the units, each starting on a page boundary. Units are
+// stored the way they would be stored in a single .qmlc file.
+static const char bundle_magic_str[] = "qv4cbndl";
+static const char bundleFileName[] = "qmlcache.qmlcb";
+static const quint32 BundleUnitAlignment = 4096;
+
+struct BundleHeader
+{
+    char magic[8];
+    quint32_le version; // QV4_DATA_STRUCTURE_VERSION of the units
+    quint32_le qtVersion;
+    quint32_le unitCount;
+    quint32_le indexOffset; // of unitCount BundleEntry, sorted by file name
+    quint64_le size; // of the whole bundle
+};
+static_assert(sizeof(BundleHeader) == 32, "BundleHeader structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+
+struct BundleEntry
+{
+    quint32_le nameOffset;
+    quint32_le nameSize;
+    quint64_le unitOffset;
+    quint32_le unitSize;
+    char checksum[20]; // SHA-1 of the unit as stored, checked before it is first used
+
+    static QByteArray calculateChecksum(const char *unit, quint32 size)
+    {
+        return QCryptographicHash::hash(QByteArrayView(unit, size), QCryptographicHash::Sha1);
+    }
+};
+static_assert(sizeof(BundleEntry) == 40, "BundleEntry structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+
+} // CompiledData namespace
+} // QV4 namespace
+
+QT_END_NAMESPACE
+
+#endif // QV4COMPILATIONUNITBUNDLE_P_H
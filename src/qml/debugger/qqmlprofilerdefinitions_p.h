@@ -35,6 +35,8 @@ struct QQmlProfilerDefinitions {
         MemoryAllocation,
         DebugMessage,
         Quick3DFrame,
+        PropertyLookup,
+        GarbageCollection,
 
         MaximumMessage
     };
@@ -105,6 +107,13 @@ struct QQmlProfilerDefinitions {
         MaximumQuick3DFrameType,
     };
 
+    // Pauses of the JavaScript engine's garbage collector. The event is sent when the pause
+    // starts and carries its duration in ns.
+    enum GarbageCollectionType {
+        FullGarbageCollection,
+        MaximumGarbageCollectionType
+    };
+
     enum ProfileFeature {
         ProfileJavaScript,
         ProfileMemory,
@@ -119,6 +128,7 @@ struct QQmlProfilerDefinitions {
         ProfileInputEvents,
         ProfileDebugMessages,
         ProfileQuick3D,
+        ProfileLookups,
 
         MaximumProfileFeature
     };
@@ -7,6 +7,7 @@
 
 #include "qv4engine_p.h"
 #include "qv4assemblercommon_p.h"
+#include "qv4jitcodecache_p.h"
 #include <private/qv4function_p.h>
 #include <private/qv4functiontable_p.h>
 #include <private/qv4runtime_p.h>
@@ -89,7 +90,8 @@ static void printDisassembledOutputWithCalls(QByteArray processedOutput,
 JIT::PlatformAssemblerCommon::~PlatformAssemblerCommon()
 {}
 
-void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
+void PlatformAssemblerCommon::link(Function *function, const char *jitKind,
+                                   CachedCode *cachedCode)
 {
     for (const auto &jumpTarget : jumpsToLink)
         jumpTarget.jump.linkTo(labelForOffset[jumpTarget.offset], this);
@@ -102,6 +104,34 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         linkBuffer.patch(ehTarget.label, linkBuffer.locationOf(targetLabel));
     }
 
+    if (cachedCode) {
+        const quintptr start = reinterpret_cast<quintptr>(linkBuffer.debugAddress());
+        auto offsetOf = [&](void *address) {
+            return quint32(reinterpret_cast<quintptr>(address) - start);
+        };
+
+        cachedCode->code = QByteArray(static_cast<const char *>(linkBuffer.debugAddress()),
+                                      qsizetype(linkBuffer.debugSize()));
+        const auto symbols = Runtime::symbolTable();
+        for (const auto &relocation : relocations) {
+            const char *name = functions.value(relocation.target);
+            cachedCode->relocations.append({
+                offsetOf(linkBuffer.locationOf(relocation.label).dataLocation()), 0,
+                QByteArray(name ? name : symbols.value(relocation.target))
+            });
+        }
+        for (const auto &ehTarget : ehTargets) {
+            const auto targetLabel = labelForOffset.value(ehTarget.offset);
+            cachedCode->relocations.append({
+                offsetOf(linkBuffer.locationOf(ehTarget.label).dataLocation()),
+                offsetOf(linkBuffer.locationOf(targetLabel).executableAddress()),
+                QByteArray()
+            });
+        }
+        for (const auto &loopEntry : loopEntries)
+            cachedCode->loopEntries.append({ loopEntry.offset, linkBuffer.offsetOf(loopEntry.label) });
+    }
+
     JSC::MacroAssemblerCodeRef codeRef;
 
     static const bool showCode = lcAsm().isDebugEnabled();
@@ -128,6 +158,65 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
 
     if (Q_UNLIKELY(!linkBuffer.makeExecutable()))
         function->jittedCode = nullptr; // The function is not executable, but the coderef exists.
+
+    function->loopEntryPoints.clear();
+    if (function->jittedCode) {
+        const quintptr entry = reinterpret_cast<quintptr>(function->jittedCode);
+        for (const auto &loopEntry : loopEntries) {
+            function->loopEntryPoints.insert(
+                        loopEntry.offset, reinterpret_cast<Function::JittedCode>(
+                            entry + linkBuffer.offsetOf(loopEntry.label)));
+        }
+    }
+}
+
+bool PlatformAssemblerCommon::link(Function *function, const CachedCode &cachedCode,
+                                   const QList<const void *> &symbolAddresses)
+{
+    Q_ASSERT(symbolAddresses.size() == cachedCode.relocations.size());
+    if (cachedCode.code.isEmpty())
+        return false;
+
+    JSC::JSGlobalData dummy(function->internalClass->engine->executableAllocator);
+    RefPtr<JSC::ExecutableMemoryHandle> memory = dummy.executableAllocator.allocate(
+                dummy, size_t(cachedCode.code.size()), nullptr, JSC::JITCompilationCanFail);
+    if (Q_UNLIKELY(!JSC::ExecutableAllocator::makeWritable(memory->memoryStart(),
+                                                           memory->memorySize()))) {
+        return false;
+    }
+
+    char *code = static_cast<char *>(memory->codeStart());
+    memcpy(code, cachedCode.code.constData(), size_t(cachedCode.code.size()));
+
+    // Everything else in the generated code is position independent: constants, strings and
+    // lookups are loaded through the function and the compilation unit at run time.
+    for (qsizetype i = 0, end = cachedCode.relocations.size(); i < end; ++i) {
+        const CachedCode::Relocation &relocation = cachedCode.relocations.at(i);
+        void *value = relocation.symbol.isEmpty()
+                ? code + relocation.target
+                : const_cast<void *>(symbolAddresses.at(i));
+        linkPointer(code, JSC::AssemblerLabel(relocation.offset), value);
+    }
+    cacheFlush(code, size_t(cachedCode.code.size()));
+
+    JSC::MacroAssemblerCodeRef codeRef(memory.get());
+    function->codeRef = new JSC::MacroAssemblerCodeRef(codeRef);
+    function->jittedCode = reinterpret_cast<Function::JittedCode>(code);
+
+    generateFunctionTable(function, &codeRef);
+
+    if (Q_UNLIKELY(!JSC::ExecutableAllocator::makeExecutable(memory->memoryStart(),
+                                                             memory->memorySize()))) {
+        function->jittedCode = nullptr;
+        return false;
+    }
+
+    function->loopEntryPoints.clear();
+    for (const auto &loopEntry : cachedCode.loopEntries) {
+        function->loopEntryPoints.insert(
+                    loopEntry.first, reinterpret_cast<Function::JittedCode>(code + loopEntry.second));
+    }
+    return true;
 }
 
 void PlatformAssemblerCommon::prepareCallWithArgCount(int argc)
@@ -290,7 +379,7 @@ void PlatformAssemblerCommon::callRuntimeUnchecked(const void *funcPtr, const ch
 {
     Q_ASSERT(functionName || Runtime::symbolTable().contains(funcPtr));
     functions.insert(funcPtr, functionName);
-    callAbsolute(funcPtr);
+    relocations.push_back({ callAbsolute(funcPtr), funcPtr });
 }
 
 void PlatformAssemblerCommon::tailCallRuntime(const void *funcPtr, const char *functionName)
@@ -301,7 +390,7 @@ void PlatformAssemblerCommon::tailCallRuntime(const void *funcPtr, const char *f
     setTailCallArg(CppStackFrameRegister, 0);
     freeStackSpace();
     generatePlatformFunctionExit(/*tailCall =*/ true);
-    jumpAbsolute(funcPtr);
+    relocations.push_back({ jumpAbsolute(funcPtr), funcPtr });
 }
 
 void PlatformAssemblerCommon::setTailCallArg(RegisterID src, int arg)
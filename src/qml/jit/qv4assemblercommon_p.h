@@ -29,6 +29,8 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 namespace JIT {
 
+struct CachedCode;
+
 #if defined(Q_PROCESSOR_X86_64) || defined(ENABLE_ALL_ASSEMBLERS_FOR_REFACTORING_PURPOSES)
 #if defined(Q_OS_LINUX) || defined(Q_OS_QNX) || defined(Q_OS_FREEBSD) || defined(Q_OS_DARWIN) || defined(Q_OS_SOLARIS)
 
@@ -91,16 +93,19 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    // Returns the label of the pointer to the function, so that it can be relocated.
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -138,6 +143,7 @@ public:
     static const RegisterID StackPointerRegister  = RegisterID::esp;
     static const RegisterID FramePointerRegister  = RegisterID::ebp;
     static const FPRegisterID FPScratchRegister   = FPRegisterID::xmm1;
+    static const FPRegisterID FPScratchRegister2  = FPRegisterID::xmm2;
 
     static const RegisterID Arg0Reg = RegisterID::ecx;
     static const RegisterID Arg1Reg = RegisterID::edx;
@@ -177,18 +183,21 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    // Returns the label of the pointer to the function, so that it can be relocated.
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         subPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
         call(ScratchRegister);
         addPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -270,16 +279,19 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    // Returns the label of the pointer to the function, so that it can be relocated.
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -318,6 +330,7 @@ public:
     static const RegisterID StackPointerRegister  = JSC::ARM64Registers::sp;
     static const RegisterID FramePointerRegister  = JSC::ARM64Registers::fp;
     static const FPRegisterID FPScratchRegister   = JSC::ARM64Registers::q1;
+    static const FPRegisterID FPScratchRegister2  = JSC::ARM64Registers::q2;
 
     static const RegisterID Arg0Reg = JSC::ARM64Registers::x0;
     static const RegisterID Arg1Reg = JSC::ARM64Registers::x1;
@@ -371,16 +384,19 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    // Returns the label of the pointer to the function, so that it can be relocated.
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -475,16 +491,19 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    // Returns the label of the pointer to the function, so that it can be relocated.
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), dataTempRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), dataTempRegister);
         call(dataTempRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), dataTempRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), dataTempRegister);
         jump(dataTempRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -654,7 +673,14 @@ public:
         ehTargets.push_back({ label, offset });
     }
 
-    void link(Function *function, const char *jitKind);
+    void addLoopEntry(int offset)
+    {
+        loopEntries.push_back({ label(), offset });
+    }
+
+    void link(Function *function, const char *jitKind, CachedCode *cachedCode = nullptr);
+    static bool link(Function *function, const CachedCode &cachedCode,
+                     const QList<const void *> &symbolAddresses);
 
     Value constant(int idx) const
     { return constantTable[idx]; }
@@ -688,6 +714,10 @@ private:
     std::vector<JumpTarget> jumpsToLink;
     struct ExceptionHanlderTarget { JSC::MacroAssemblerBase::DataLabelPtr label; int offset; };
     std::vector<ExceptionHanlderTarget> ehTargets;
+    struct LoopEntry { JSC::MacroAssemblerBase::Label label; int offset; };
+    std::vector<LoopEntry> loopEntries;
+    struct Relocation { JSC::MacroAssemblerBase::DataLabelPtr label; const void *target; };
+    std::vector<Relocation> relocations;
     QHash<int, JSC::MacroAssemblerBase::Label> labelForOffset;
     QHash<const void *, const char *> functions;
     std::vector<Jump> catchyJumps;
@@ -50,9 +50,10 @@ public:
         : PlatformAssemblerCommon(constantTable)
     {}
 
-    void callRuntime(const void *funcPtr, CallResultDestination dest)
+    void callRuntime(const void *funcPtr, CallResultDestination dest,
+                     const char *functionName = nullptr)
     {
-        PlatformAssemblerCommon::callRuntime(funcPtr);
+        PlatformAssemblerCommon::callRuntime(funcPtr, functionName);
         if (dest == CallResultDestination::InAccumulator)
             saveReturnValueInAccumulator();
         else if (AccumulatorRegister == ReturnValueRegister)
@@ -338,6 +339,65 @@ public:
         return done;
     }
 
+    // Used by the optimizing tier where the type feedback says that the operands tend to be
+    // numbers that aren't both integers. If they are numbers, the fast path gets the lhs and the
+    // accumulator converted to doubles. Otherwise we fall through to the generic path.
+    Jump binopBothNumberPath(Address lhsAddr,
+                             std::function<void(FPRegisterID, FPRegisterID)> fastPath)
+    {
+        Jump accNotNumber = branchNotNumber(AccumulatorRegister);
+        load64(lhsAddr, ScratchRegister);
+        Jump lhsNotNumber = branchNotNumber(ScratchRegister);
+
+        numberToDouble(ScratchRegister, FPScratchRegister);
+        numberToDouble(AccumulatorRegister, FPScratchRegister2);
+        fastPath(FPScratchRegister, FPScratchRegister2);
+        Jump done = jump();
+
+        accNotNumber.link(this);
+        lhsNotNumber.link(this);
+        return done;
+    }
+
+    Jump branchNotNumber(RegisterID src)
+    {
+        move(TrustedImm64(Value::NumberMask), ScratchRegister2);
+        and64(src, ScratchRegister2);
+        return branch64(LessThan, ScratchRegister2, TrustedImm64(Value::NumberDiscriminator));
+    }
+
+    // src has to hold an integer or a double
+    void numberToDouble(RegisterID src, FPRegisterID dest)
+    {
+        urshift64(src, TrustedImm32(32), ScratchRegister2);
+        Jump isInt = branch32(Equal, TrustedImm32(int(IntegerTag)), ScratchRegister2);
+        move(TrustedImm64(Value::EncodeMask), ScratchRegister2);
+        xor64(src, ScratchRegister2);
+        move64ToDouble(ScratchRegister2, dest);
+        Jump done = jump();
+        isInt.link(this);
+        convertInt32ToDouble(src, dest);
+        done.link(this);
+    }
+
+    // Like encodeDoubleIntoAccumulator(), but also handles the NaNs arithmetic can produce.
+    void encodeArithmeticResultIntoAccumulator(FPRegisterID src)
+    {
+        Jump isNaN = branchDouble(DoubleNotEqualOrUnordered, src, src);
+        encodeDoubleIntoAccumulator(src);
+        Jump done = jump();
+        isNaN.link(this);
+        loadValue(Encode(qt_qnan()));
+        done.link(this);
+    }
+
+    // The byte isn't written by the interpreter anymore once the function is jitted, so we can
+    // store the flags it has recorded along with ours.
+    void recordTypeFeedback(quint8 *feedback, quint8 flags)
+    {
+        store8(TrustedImm32(*feedback | flags), feedback);
+    }
+
     void callWithAccumulatorByValueAsFirstArgument(std::function<void()> doCall)
     {
         passAsArg(AccumulatorRegister, 0);
@@ -356,9 +416,10 @@ public:
         : PlatformAssemblerCommon(constantTable)
     {}
 
-    void callRuntime(const void *funcPtr, CallResultDestination dest)
+    void callRuntime(const void *funcPtr, CallResultDestination dest,
+                     const char *functionName = nullptr)
     {
-        PlatformAssemblerCommon::callRuntime(funcPtr);
+        PlatformAssemblerCommon::callRuntime(funcPtr, functionName);
         if (dest == CallResultDestination::InAccumulator)
             saveReturnValueInAccumulator();
         else if (AccumulatorRegisterValue == ReturnValueRegisterValue)
@@ -768,6 +829,23 @@ public:
         return done;
     }
 
+    // The optimizing tier is only available on 64 bit platforms, see
+    // ExecutionEngine::canOptimizeJIT().
+    Jump binopBothNumberPath(Address, std::function<void(FPRegisterID, FPRegisterID)>)
+    {
+        Q_UNREACHABLE_RETURN(Jump());
+    }
+
+    void encodeArithmeticResultIntoAccumulator(FPRegisterID)
+    {
+        Q_UNREACHABLE();
+    }
+
+    void recordTypeFeedback(quint8 *, quint8)
+    {
+        Q_UNREACHABLE();
+    }
+
     void callWithAccumulatorByValueAsFirstArgument(std::function<void()> doCall)
     {
         if (ArgInRegCount < 2) {
@@ -801,6 +879,22 @@ static Address regAddr(int reg)
     return Address(PlatformAssembler::JSStackFrameRegister, reg * int(sizeof(QV4::Value)));
 }
 
+using DoubleOp = std::function<void(PlatformAssembler::FPRegisterID lhs,
+                                    PlatformAssembler::FPRegisterID rhs)>;
+
+// Emits the double fast path of the optimizing tier, or records in the type feedback that the
+// integer fast path didn't apply. The returned jump, if set, skips the generic path.
+static PlatformAssembler::Jump numberPathOrFeedback(PlatformAssembler *as, int lhs,
+                                                    BaselineAssembler::NumericSite site,
+                                                    DoubleOp op)
+{
+    if (site.speculateDouble)
+        return as->binopBothNumberPath(regAddr(lhs), op);
+    if (site.feedback)
+        as->recordTypeFeedback(site.feedback, Function::SawNonInt);
+    return PlatformAssembler::Jump();
+}
+
 BaselineAssembler::BaselineAssembler(const Value *constantTable)
     : d(new PlatformAssembler(constantTable))
 {
@@ -821,9 +915,24 @@ void BaselineAssembler::generateEpilogue()
     pasm()->generateCatchTrampoline();
 }
 
-void BaselineAssembler::link(Function *function)
+// An additional entry point that continues an interpreted frame at the loop header at offset.
+void BaselineAssembler::generateLoopEntry(int offset)
+{
+    pasm()->addLoopEntry(offset);
+    pasm()->generateFunctionEntry();
+    loadAccumulatorFromFrame();
+    pasm()->addJumpToOffset(pasm()->jump(), offset);
+}
+
+void BaselineAssembler::link(Function *function, const char *jitKind, CachedCode *cachedCode)
 {
-    pasm()->link(function, "BaselineJIT");
+    pasm()->link(function, jitKind, cachedCode);
+}
+
+bool BaselineAssembler::link(Function *function, const CachedCode &cachedCode,
+                             const QList<const void *> &symbolAddresses)
+{
+    return PlatformAssembler::link(function, cachedCode, symbolAddresses);
 }
 
 void BaselineAssembler::addLabel(int offset)
@@ -1004,7 +1113,7 @@ void BaselineAssembler::unot()
     });
 }
 
-void BaselineAssembler::add(int lhs)
+void BaselineAssembler::add(int lhs, NumericSite site)
 {
     auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
         auto overflowed = pasm()->branchAdd32(PlatformAssembler::Overflow,
@@ -1014,6 +1123,10 @@ void BaselineAssembler::add(int lhs)
                                   PlatformAssembler::ScratchRegister);
         return overflowed;
     });
+    auto doubleDone = numberPathOrFeedback(pasm(), lhs, site, [this](auto l, auto r) {
+        pasm()->addDouble(r, l);
+        pasm()->encodeArithmeticResultIntoAccumulator(l);
+    });
 
     // slow path:
     saveAccumulatorInFrame();
@@ -1026,6 +1139,8 @@ void BaselineAssembler::add(int lhs)
 
     // done.
     done.link(pasm());
+    if (doubleDone.isSet())
+        doubleDone.link(pasm());
 }
 
 void BaselineAssembler::bitAnd(int lhs)
@@ -1157,7 +1272,7 @@ void BaselineAssembler::shlConst(int rhs)
     pasm()->setAccumulatorTag(IntegerTag);
 }
 
-void BaselineAssembler::mul(int lhs)
+void BaselineAssembler::mul(int lhs, NumericSite site)
 {
     auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
         auto overflowed = pasm()->branchMul32(PlatformAssembler::Overflow,
@@ -1167,6 +1282,10 @@ void BaselineAssembler::mul(int lhs)
                                   PlatformAssembler::ScratchRegister);
         return overflowed;
     });
+    auto doubleDone = numberPathOrFeedback(pasm(), lhs, site, [this](auto l, auto r) {
+        pasm()->mulDouble(r, l);
+        pasm()->encodeArithmeticResultIntoAccumulator(l);
+    });
 
     // slow path:
     saveAccumulatorInFrame();
@@ -1178,16 +1297,45 @@ void BaselineAssembler::mul(int lhs)
 
     // done.
     done.link(pasm());
+    if (doubleDone.isSet())
+        doubleDone.link(pasm());
+}
+
+static ReturnedValue divWithFeedbackHelper(const Value &left, const Value &right, quint8 *feedback)
+{
+    *feedback |= Function::divisionFeedback(left, right);
+    return Runtime::Div::call(left, right);
 }
 
-void BaselineAssembler::div(int lhs)
+void BaselineAssembler::div(int lhs, NumericSite site)
 {
+    // There is no integer fast path for division, which would tell the feedback apart cheaply,
+    // so the baseline code classifies the operands in the runtime call it makes anyway.
+    quint8 *feedback = site.feedback;
+    site.feedback = nullptr;
+    auto doubleDone = numberPathOrFeedback(pasm(), lhs, site, [this](auto l, auto r) {
+        pasm()->divDouble(r, l);
+        pasm()->encodeArithmeticResultIntoAccumulator(l);
+    });
+
     saveAccumulatorInFrame();
-    pasm()->prepareCallWithArgCount(2);
-    pasm()->passAccumulatorAsArg(1);
-    pasm()->passJSSlotAsArg(lhs, 0);
-    ASM_GENERATE_RUNTIME_CALL(Div, CallResultDestination::InAccumulator);
+    if (feedback) {
+        pasm()->prepareCallWithArgCount(3);
+        pasm()->passPointerAsArg(feedback, 2);
+        pasm()->passAccumulatorAsArg(1);
+        pasm()->passJSSlotAsArg(lhs, 0);
+        pasm()->callRuntime(reinterpret_cast<void *>(divWithFeedbackHelper),
+                            CallResultDestination::InAccumulator, "divWithFeedbackHelper");
+    } else {
+        pasm()->prepareCallWithArgCount(2);
+        pasm()->passAccumulatorAsArg(1);
+        pasm()->passJSSlotAsArg(lhs, 0);
+        ASM_GENERATE_RUNTIME_CALL(Div, CallResultDestination::InAccumulator);
+    }
     checkException();
+
+    if (doubleDone.isSet())
+        doubleDone.link(pasm());
 }
 
 void BaselineAssembler::mod(int lhs)
@@ -1200,7 +1348,7 @@ void BaselineAssembler::mod(int lhs)
     checkException();
 }
 
-void BaselineAssembler::sub(int lhs)
+void BaselineAssembler::sub(int lhs, NumericSite site)
 {
     auto done = pasm()->binopBothIntPath(regAddr(lhs), [this](){
         auto overflowed = pasm()->branchSub32(PlatformAssembler::Overflow,
@@ -1210,6 +1358,10 @@ void BaselineAssembler::sub(int lhs)
                                   PlatformAssembler::ScratchRegister);
         return overflowed;
     });
+    auto doubleDone = numberPathOrFeedback(pasm(), lhs, site, [this](auto l, auto r) {
+        pasm()->subDouble(r, l);
+        pasm()->encodeArithmeticResultIntoAccumulator(l);
+    });
 
     // slow path:
     saveAccumulatorInFrame();
@@ -1221,6 +1373,8 @@ void BaselineAssembler::sub(int lhs)
 
     // done.
     done.link(pasm());
+    if (doubleDone.isSet())
+        doubleDone.link(pasm());
 }
 
 void BaselineAssembler::cmpeqNull()
@@ -1284,7 +1438,7 @@ void BaselineAssembler::cmpneInt(int lhs)
     done.link(pasm());
 }
 
-void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
+void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs, NumericSite site, int doubleCond)
 {
     auto c = static_cast<PlatformAssembler::RelationalCondition>(cond);
     auto done = pasm()->binopBothIntPath(regAddr(lhs), [this, c](){
@@ -1293,6 +1447,15 @@ void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
                           PlatformAssembler::AccumulatorRegisterValue);
         return PlatformAssembler::Jump();
     });
+    auto dc = static_cast<PlatformAssembler::DoubleCondition>(doubleCond);
+    auto doubleDone = numberPathOrFeedback(pasm(), lhs, site, [this, dc](auto l, auto r) {
+        auto isTrue = pasm()->branchDouble(dc, l, r);
+        pasm()->move(TrustedImm32(0), PlatformAssembler::AccumulatorRegisterValue);
+        auto isFalse = pasm()->jump();
+        isTrue.link(pasm());
+        pasm()->move(TrustedImm32(1), PlatformAssembler::AccumulatorRegisterValue);
+        isFalse.link(pasm());
+    });
 
     // slow path:
     saveAccumulatorInFrame();
@@ -1305,6 +1468,8 @@ void BaselineAssembler::cmp(int cond, CmpFunc function, int lhs)
 
     // done.
     done.link(pasm());
+    if (doubleDone.isSet())
+        doubleDone.link(pasm());
     pasm()->setAccumulatorTag(QV4::Value::ValueTypeInternal::Boolean);
 }
 
@@ -1318,24 +1483,28 @@ void BaselineAssembler::cmpne(int lhs)
     cmp(PlatformAssembler::NotEqual, &Runtime::CompareNotEqual::call, lhs);
 }
 
-void BaselineAssembler::cmpgt(int lhs)
+void BaselineAssembler::cmpgt(int lhs, NumericSite site)
 {
-    cmp(PlatformAssembler::GreaterThan, &Runtime::CompareGreaterThan::call, lhs);
+    cmp(PlatformAssembler::GreaterThan, &Runtime::CompareGreaterThan::call, lhs, site,
+        PlatformAssembler::DoubleGreaterThan);
 }
 
-void BaselineAssembler::cmpge(int lhs)
+void BaselineAssembler::cmpge(int lhs, NumericSite site)
 {
-    cmp(PlatformAssembler::GreaterThanOrEqual, &Runtime::CompareGreaterEqual::call, lhs);
+    cmp(PlatformAssembler::GreaterThanOrEqual, &Runtime::CompareGreaterEqual::call, lhs, site,
+        PlatformAssembler::DoubleGreaterThanOrEqual);
 }
 
-void BaselineAssembler::cmplt(int lhs)
+void BaselineAssembler::cmplt(int lhs, NumericSite site)
 {
-    cmp(PlatformAssembler::LessThan, &Runtime::CompareLessThan::call, lhs);
+    cmp(PlatformAssembler::LessThan, &Runtime::CompareLessThan::call, lhs, site,
+        PlatformAssembler::DoubleLessThan);
 }
 
-void BaselineAssembler::cmple(int lhs)
+void BaselineAssembler::cmple(int lhs, NumericSite site)
 {
-    cmp(PlatformAssembler::LessThanOrEqual, &Runtime::CompareLessEqual::call, lhs);
+    cmp(PlatformAssembler::LessThanOrEqual, &Runtime::CompareLessEqual::call, lhs, site,
+        PlatformAssembler::DoubleLessThanOrEqual);
 }
 
 void BaselineAssembler::cmpStrictEqual(int lhs)
@@ -1451,9 +1620,10 @@ void BaselineAssembler::passPointerAsArg(void *ptr, int arg)
     pasm()->passPointerAsArg(ptr, arg);
 }
 
-void BaselineAssembler::callRuntime(const void *funcPtr, CallResultDestination dest)
+void BaselineAssembler::callRuntime(const void *funcPtr, CallResultDestination dest,
+                                    const char *functionName)
 {
-    pasm()->callRuntime(funcPtr, dest);
+    pasm()->callRuntime(funcPtr, dest, functionName);
 }
 
 void BaselineAssembler::saveAccumulatorInFrame()
@@ -1608,6 +1778,22 @@ void BaselineAssembler::ret()
     pasm()->generateFunctionExit();
 }
 
+QHash<const void *, const char *> BaselineAssembler::symbolTable()
+{
+    static const QHash<const void *, const char *> symbols({
+            { reinterpret_cast<const void *>(&Value::toBooleanImpl), "Value::toBooleanImpl" },
+            { reinterpret_cast<const void *>(&toNumberHelper), "toNumberHelper" },
+            { reinterpret_cast<const void *>(&toInt32Helper), "toInt32Helper" },
+            { reinterpret_cast<const void *>(&incHelper), "incHelper" },
+            { reinterpret_cast<const void *>(&decHelper), "decHelper" },
+            { reinterpret_cast<const void *>(
+                      &TheJitIs__Tail_Calling__ToTheRuntimeSoTheJitFrameIsMissing),
+              "TheJitIs__Tail_Calling__ToTheRuntimeSoTheJitFrameIsMissing" },
+    });
+
+    return symbols;
+}
+
 } // JIT namespace
 } // QV4 namepsace
 
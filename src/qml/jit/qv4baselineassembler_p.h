@@ -26,6 +26,8 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 namespace JIT {
 
+struct CachedCode;
+
 #define GENERATE_RUNTIME_CALL(function, destination) \
     callRuntime(reinterpret_cast<void *>(&Runtime::function::call), \
                 destination)
@@ -37,10 +39,25 @@ public:
     BaselineAssembler(const Value* constantTable);
     ~BaselineAssembler();
 
+    // The helper functions called by the generated code, in addition to Runtime::symbolTable().
+    static QHash<const void *, const char *> symbolTable();
+
+    // Type feedback for an arithmetic or relational operation. The baseline tier records in
+    // feedback when the integer fast path doesn't apply, the optimizing tier instead adds a
+    // fast path for doubles if speculateDouble is set.
+    struct NumericSite
+    {
+        quint8 *feedback = nullptr;
+        bool speculateDouble = false;
+    };
+
     // codegen infrastructure
     void generatePrologue();
     void generateEpilogue();
-    void link(Function *function);
+    void generateLoopEntry(int offset);
+    void link(Function *function, const char *jitKind, CachedCode *cachedCode = nullptr);
+    static bool link(Function *function, const CachedCode &cachedCode,
+                     const QList<const void *> &symbolAddresses);
     void addLabel(int offset);
 
     // loads/stores/moves
@@ -63,7 +80,7 @@ public:
     void ucompl();
     void inc();
     void dec();
-    void add(int lhs);
+    void add(int lhs, NumericSite site = {});
     void bitAnd(int lhs);
     void bitOr(int lhs);
     void bitXor(int lhs);
@@ -76,10 +93,10 @@ public:
     void ushrConst(int rhs);
     void shrConst(int rhs);
     void shlConst(int rhs);
-    void mul(int lhs);
-    void div(int lhs);
+    void mul(int lhs, NumericSite site = {});
+    void div(int lhs, NumericSite site = {});
     void mod(int lhs);
-    void sub(int lhs);
+    void sub(int lhs, NumericSite site = {});
 
     // comparissons
     void cmpeqNull();
@@ -88,10 +105,10 @@ public:
     void cmpneInt(int lhs);
     void cmpeq(int lhs);
     void cmpne(int lhs);
-    void cmpgt(int lhs);
-    void cmpge(int lhs);
-    void cmplt(int lhs);
-    void cmple(int lhs);
+    void cmpgt(int lhs, NumericSite site = {});
+    void cmpge(int lhs, NumericSite site = {});
+    void cmplt(int lhs, NumericSite site = {});
+    void cmple(int lhs, NumericSite site = {});
     void cmpStrictEqual(int lhs);
     void cmpStrictNotEqual(int lhs);
 
@@ -113,7 +130,8 @@ public:
     void passCppFrameAsArg(int arg);
     void passInt32AsArg(int value, int arg);
     void passPointerAsArg(void *ptr, int arg);
-    void callRuntime(const void *funcPtr, CallResultDestination dest);
+    void callRuntime(const void *funcPtr, CallResultDestination dest,
+                     const char *functionName = nullptr);
     void saveAccumulatorInFrame();
     void loadAccumulatorFromFrame();
     void jsTailCall(int func, int thisObject, int argc, int argv);
@@ -139,7 +157,7 @@ protected:
 
 private:
     typedef unsigned(*CmpFunc)(const Value&,const Value&);
-    void cmp(int cond, CmpFunc function, int lhs);
+    void cmp(int cond, CmpFunc function, int lhs, NumericSite site = {}, int doubleCond = 0);
 };
 
 } // namespace JIT
@@ -3,6 +3,7 @@
 
 #include "qv4baselinejit_p.h"
 #include "qv4baselineassembler_p.h"
+#include "qv4jitcodecache_p.h"
 #include <private/qv4lookup_p.h>
 #include <private/qv4generatorobject_p.h>
 
@@ -13,8 +14,9 @@ using namespace QV4;
 using namespace QV4::JIT;
 using namespace QV4::Moth;
 
-BaselineJIT::BaselineJIT(Function *function)
+BaselineJIT::BaselineJIT(Function *function, Mode mode)
     : function(function)
+      , mode(mode)
       , as(new BaselineAssembler(&(function->compilationUnit->constants->asValue<Value>())))
 {}
 
@@ -35,11 +37,51 @@ void BaselineJIT::generate()
     as->loadAccumulatorFromFrame();
     decode(code, len);
     as->generateEpilogue();
-
-    as->link(function);
+    for (int offset : std::as_const(loopHeaders))
+        as->generateLoopEntry(offset);
+
+    if (mode == Optimizing) {
+        // Frames still running the baseline code may return into it.
+        Q_ASSERT(!function->baselineCodeRef);
+        function->baselineCodeRef = function->codeRef;
+        function->codeRef = nullptr;
+    }
+
+    JitCodeCache *cache = mode == Baseline
+            ? function->executableCompilationUnit()->jitCodeCache.get()
+            : nullptr;
+    if (cache && cache->isWritable()) {
+        CachedCode cachedCode;
+        as->link(function, "BaselineJIT", &cachedCode);
+        if (function->jittedCode)
+            cache->store(function, std::move(cachedCode));
+    } else {
+        as->link(function, mode == Optimizing ? "OptimizingJIT" : "BaselineJIT");
+    }
 //    qDebug()<<"done";
 }
 
+static BaselineAssembler::NumericSite numericSite(Function *function, BaselineJIT::Mode mode,
+                                                  int offset)
+{
+    BaselineAssembler::NumericSite site;
+    if (!function->typeFeedback)
+        return site;
+    quint8 *feedback = &function->typeFeedback[offset];
+    if (mode == BaselineJIT::Optimizing) {
+        site.speculateDouble
+                = (*feedback & (Function::SawDouble | Function::SawNonInt | Function::SawInt))
+                && !(*feedback & Function::SawOther);
+    } else {
+        // Code that is written to the JIT code cache must not contain heap addresses.
+        const JitCodeCache *cache = function->executableCompilationUnit()->jitCodeCache.get();
+        if (!cache || !cache->isWritable())
+            site.feedback = feedback;
+    }
+    return site;
+}
+
+#define NUMERIC_SITE() numericSite(function, mode, nextInstructionOffset())
 #define STORE_IP() as->storeInstructionPointer(nextInstructionOffset())
 #define STORE_ACC() as->saveAccumulatorInFrame()
 #define LOAD_ACC() as->loadAccumulatorFromFrame()
@@ -758,16 +800,22 @@ void BaselineJIT::generate_ToObject()
 
 void BaselineJIT::generate_Jump(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jump(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpTrue(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jumpTrue(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpFalse(int offset)
 {
+    if (offset < 0)
+        loopHeaders.insert(absoluteOffset(offset));
     labels.insert(as->jumpFalse(absoluteOffset(offset)));
 }
 
@@ -792,10 +840,10 @@ void BaselineJIT::generate_CmpEqInt(int lhs) { as->cmpeqInt(lhs); }
 void BaselineJIT::generate_CmpNeInt(int lhs) { as->cmpneInt(lhs); }
 void BaselineJIT::generate_CmpEq(int lhs) { as->cmpeq(lhs); }
 void BaselineJIT::generate_CmpNe(int lhs) { as->cmpne(lhs); }
-void BaselineJIT::generate_CmpGt(int lhs) { as->cmpgt(lhs); }
-void BaselineJIT::generate_CmpGe(int lhs) { as->cmpge(lhs); }
-void BaselineJIT::generate_CmpLt(int lhs) { as->cmplt(lhs); }
-void BaselineJIT::generate_CmpLe(int lhs) { as->cmple(lhs); }
+void BaselineJIT::generate_CmpGt(int lhs) { as->cmpgt(lhs, NUMERIC_SITE()); }
+void BaselineJIT::generate_CmpGe(int lhs) { as->cmpge(lhs, NUMERIC_SITE()); }
+void BaselineJIT::generate_CmpLt(int lhs) { as->cmplt(lhs, NUMERIC_SITE()); }
+void BaselineJIT::generate_CmpLe(int lhs) { as->cmple(lhs, NUMERIC_SITE()); }
 void BaselineJIT::generate_CmpStrictEqual(int lhs) { as->cmpStrictEqual(lhs); }
 void BaselineJIT::generate_CmpStrictNotEqual(int lhs) { as->cmpStrictNotEqual(lhs); }
 
@@ -836,7 +884,7 @@ void BaselineJIT::generate_UMinus() { as->uminus(); }
 void BaselineJIT::generate_UCompl() { as->ucompl(); }
 void BaselineJIT::generate_Increment() { as->inc(); }
 void BaselineJIT::generate_Decrement() { as->dec(); }
-void BaselineJIT::generate_Add(int lhs) { as->add(lhs); }
+void BaselineJIT::generate_Add(int lhs) { as->add(lhs, NUMERIC_SITE()); }
 
 void BaselineJIT::generate_BitAnd(int lhs) { as->bitAnd(lhs); }
 void BaselineJIT::generate_BitOr(int lhs) { as->bitOr(lhs); }
@@ -860,10 +908,10 @@ void BaselineJIT::generate_Exp(int lhs) {
     as->passJSSlotAsArg(lhs, 0);
     BASELINEJIT_GENERATE_RUNTIME_CALL(Exp, CallResultDestination::InAccumulator);
 }
-void BaselineJIT::generate_Mul(int lhs) { as->mul(lhs); }
-void BaselineJIT::generate_Div(int lhs) { as->div(lhs); }
+void BaselineJIT::generate_Mul(int lhs) { as->mul(lhs, NUMERIC_SITE()); }
+void BaselineJIT::generate_Div(int lhs) { as->div(lhs, NUMERIC_SITE()); }
 void BaselineJIT::generate_Mod(int lhs) { as->mod(lhs); }
-void BaselineJIT::generate_Sub(int lhs) { as->sub(lhs); }
+void BaselineJIT::generate_Sub(int lhs) { as->sub(lhs, NUMERIC_SITE()); }
 
 //void BaselineJIT::generate_BinopContext(int alu, int lhs)
 //{
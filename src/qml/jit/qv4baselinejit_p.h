@@ -33,7 +33,11 @@ class BaselineAssembler;
 class BaselineJIT final: public Moth::ByteCodeHandler
 {
 public:
-    BaselineJIT(QV4::Function *);
+    // The optimizing tier uses the type feedback collected by the interpreter and the baseline
+    // tier to add fast paths for the types actually seen.
+    enum Mode { Baseline, Optimizing };
+
+    BaselineJIT(QV4::Function *, Mode mode = Baseline);
     ~BaselineJIT() override;
 
     void generate();
@@ -178,8 +182,10 @@ public:
 
 private:
     QV4::Function *function;
+    Mode mode;
     QScopedPointer<BaselineAssembler> as;
     QSet<int> labels;
+    QSet<int> loopHeaders;
 };
 
 } // namespace JIT
@@ -0,0 +1,221 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4jitcodecache_p.h"
+#include "qv4baselineassembler_p.h"
+
+#include <private/qv4compileddata_p.h>
+#include <private/qv4function_p.h>
+#include <private/qv4runtimeapi_p.h>
+#include <private/qsimd_p.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
+
+#if QT_CONFIG(qml_jit)
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+namespace JIT {
+
+static const char jitCacheMagic[] = "qv4jcode";
+static const quint32 jitCacheFormatVersion = 2;
+static const QCryptographicHash::Algorithm jitCacheChecksumAlgorithm = QCryptographicHash::Sha256;
+
+static QDataStream &operator<<(QDataStream &stream, const CachedCode::Relocation &relocation)
+{
+    return stream << relocation.offset << relocation.target << relocation.symbol;
+}
+
+static QDataStream &operator>>(QDataStream &stream, CachedCode::Relocation &relocation)
+{
+    return stream >> relocation.offset >> relocation.target >> relocation.symbol;
+}
+
+static QDataStream &operator<<(QDataStream &stream, const CachedCode &code)
+{
+    return stream << code.code << code.relocations << code.loopEntries;
+}
+
+static QDataStream &operator>>(QDataStream &stream, CachedCode &code)
+{
+    return stream >> code.code >> code.relocations >> code.loopEntries;
+}
+
+static const void *symbolAddress(const QByteArray &name)
+{
+    static const QHash<QByteArray, const void *> addresses = []() {
+        QHash<QByteArray, const void *> result;
+        const auto runtimeSymbols = Runtime::symbolTable();
+        for (auto it = runtimeSymbols.cbegin(), end = runtimeSymbols.cend(); it != end; ++it)
+            result.insert(QByteArray(it.value()), it.key());
+        const auto helperSymbols = BaselineAssembler::symbolTable();
+        for (auto it = helperSymbols.cbegin(), end = helperSymbols.cend(); it != end; ++it)
+            result.insert(QByteArray(it.value()), it.key());
+        return result;
+    }();
+
+    return addresses.value(name);
+}
+
+JitCodeCache::JitCodeCache(const QString &filePath, const CompiledData::Unit *unit,
+                           bool readable, bool writable)
+    : m_filePath(filePath)
+    , m_unit(unit)
+    , m_readable(readable)
+    , m_writable(writable)
+{
+}
+
+JitCodeCache::~JitCodeCache() = default;
+
+QString JitCodeCache::filePath(const QString &unitCacheFilePath)
+{
+    // foo.qmlc becomes foo.qmljit, foo.jsc foo.jsjit, and so on.
+    return unitCacheFilePath.chopped(1) + QLatin1String("jit");
+}
+
+quint32 JitCodeCache::key(const Function *function) const
+{
+    return quint32(reinterpret_cast<const char *>(function->compiledFunction)
+                   - reinterpret_cast<const char *>(m_unit));
+}
+
+// Code from a different build of Qt, or for a different CPU, may call into the wrong places or
+// use instructions that aren't available. The checksum of the unit ties the code to the bytecode
+// it was generated from.
+QByteArray JitCodeCache::header() const
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.writeRawData(jitCacheMagic, sizeof(jitCacheMagic) - 1);
+    stream << jitCacheFormatVersion << quint32(QT_VERSION) << quint32(QV4_DATA_STRUCTURE_VERSION)
+           << quint32(QT_POINTER_SIZE) << quint64(qCpuFeatures());
+    stream.writeRawData(m_unit->md5Checksum, sizeof(m_unit->md5Checksum));
+    stream.writeRawData(m_unit->libraryVersionHash, sizeof(m_unit->libraryVersionHash));
+    return result;
+}
+
+// The file is followed by a checksum of the code it contains, so that a file that was truncated
+// or modified after it was written is not turned into executable memory. Files that others than
+// their owner may write to are not loaded at all.
+void JitCodeCache::load()
+{
+    m_loaded = true;
+
+    QFile file(m_filePath);
+    if (file.permissions() & (QFileDevice::WriteGroup | QFileDevice::WriteOther))
+        return;
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QByteArray expectedHeader = header();
+    if (file.read(expectedHeader.size()) != expectedHeader)
+        return;
+
+    const QByteArray checksum
+            = file.read(QCryptographicHash::hashLength(jitCacheChecksumAlgorithm));
+    const QByteArray payload = file.readAll();
+    if (QCryptographicHash::hash(payload, jitCacheChecksumAlgorithm) != checksum)
+        return;
+
+    QDataStream stream(payload);
+    QHash<quint32, CachedCode> entries;
+    stream >> entries;
+    if (stream.status() == QDataStream::Ok && stream.atEnd())
+        m_entries = std::move(entries);
+}
+
+static bool isConsistent(const CachedCode &code)
+{
+    const qsizetype size = code.code.size();
+    for (const CachedCode::Relocation &relocation : code.relocations) {
+        if (qsizetype(relocation.offset) + qsizetype(sizeof(void *)) > size)
+            return false;
+        if (relocation.symbol.isEmpty() && qsizetype(relocation.target) >= size)
+            return false;
+    }
+    for (const auto &loopEntry : code.loopEntries) {
+        if (qsizetype(loopEntry.second) >= size)
+            return false;
+    }
+    return true;
+}
+
+bool JitCodeCache::install(Function *function)
+{
+    Q_ASSERT(!function->codeRef);
+
+    // Without jit-read, the file is only read to keep the code of the functions that are not
+    // jitted in this run when saving it again.
+    if (!m_readable)
+        return false;
+    if (!m_loaded)
+        load();
+
+    auto it = m_entries.constFind(key(function));
+    if (it == m_entries.constEnd())
+        return false;
+
+    const CachedCode &code = it.value();
+    if (!isConsistent(code))
+        return false;
+
+    QList<const void *> symbolAddresses;
+    symbolAddresses.reserve(code.relocations.size());
+    for (const CachedCode::Relocation &relocation : code.relocations) {
+        if (relocation.symbol.isEmpty()) {
+            symbolAddresses.append(nullptr);
+            continue;
+        }
+        const void *address = symbolAddress(relocation.symbol);
+        if (!address)
+            return false;
+        symbolAddresses.append(address);
+    }
+
+    return BaselineAssembler::link(function, code, symbolAddresses);
+}
+
+void JitCodeCache::store(Function *function, CachedCode &&code)
+{
+    Q_ASSERT(m_writable);
+    if (!m_loaded)
+        load();
+
+    m_entries.insert(key(function), std::move(code));
+    m_dirty = true;
+}
+
+bool JitCodeCache::save(QString *errorString)
+{
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << m_entries;
+    }
+
+    const QByteArray data = header() + QCryptographicHash::hash(payload, jitCacheChecksumAlgorithm)
+            + payload;
+    if (!CompiledData::SaveableUnitPointer::writeDataToFile(
+                m_filePath, data.constData(), quint32(data.size()), errorString)) {
+        return false;
+    }
+
+    // load() refuses files that others may write to.
+    QFile::setPermissions(m_filePath, QFileDevice::ReadOwner | QFileDevice::WriteOwner
+                                      | QFileDevice::ReadUser | QFileDevice::WriteUser
+                                      | QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+    m_dirty = false;
+    return true;
+}
+
+} // namespace JIT
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QT_CONFIG(qml_jit)
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4JITCODECACHE_P_H
+#define QV4JITCODECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+#if QT_CONFIG(qml_jit)
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+struct Function;
+
+namespace CompiledData {
+struct Unit;
+}
+
+namespace JIT {
+
+// The machine code of one function together with everything that has to be patched when it is
+// copied into executable memory again.
+struct CachedCode
+{
+    struct Relocation
+    {
+        quint32 offset = 0; // of the pointer to patch, relative to the start of the code
+        quint32 target = 0; // code relative target, used if symbol is empty
+        QByteArray symbol; // name of the runtime function to call
+    };
+
+    QByteArray code;
+    QList<Relocation> relocations;
+    QList<QPair<int, quint32>> loopEntries; // bytecode offset of the loop header, code offset
+};
+
+// Stores the baseline JIT code of the functions of one compilation unit next to its .qmlc file,
+// so that it does not have to be generated again on the next run.
+class JitCodeCache
+{
+    Q_DISABLE_COPY_MOVE(JitCodeCache)
+public:
+    JitCodeCache(const QString &filePath, const CompiledData::Unit *unit, bool readable,
+                 bool writable);
+    ~JitCodeCache();
+
+    static QString filePath(const QString &unitCacheFilePath);
+
+    bool isWritable() const { return m_writable; }
+
+    bool install(Function *function);
+    void store(Function *function, CachedCode &&code);
+
+    bool isDirty() const { return m_dirty; }
+    bool save(QString *errorString);
+
+private:
+    quint32 key(const Function *function) const;
+    void load();
+    QByteArray header() const;
+
+    QString m_filePath;
+    const CompiledData::Unit *m_unit;
+    QHash<quint32, CachedCode> m_entries;
+    bool m_readable;
+    bool m_writable;
+    bool m_loaded = false;
+    bool m_dirty = false;
+};
+
+} // namespace JIT
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QT_CONFIG(qml_jit)
+
+#endif // QV4JITCODECACHE_P_H
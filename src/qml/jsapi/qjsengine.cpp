@@ -397,6 +397,68 @@ void QJSEngine::collectGarbage()
     m_v4Engine->memoryManager->runGC();
 }
 
+/*!
+    \class QJSEngine::GarbageCollectionStatistics
+    \inmodule QtQml
+    \since 6.6
+    \brief Holds statistics about the garbage collector of a QJSEngine.
+
+    All durations are in nanoseconds and only count the time spent on the thread running the
+    engine, not the time spent sweeping on worker threads.
+
+    \list
+    \li \c collections is the number of full garbage collection cycles.
+    \li \c totalMarkTime and \c totalSweepTime are the accumulated time spent marking live
+        objects and freeing dead ones.
+    \li \c longestPause is the duration of the longest single pause, and \c pauseHistogram
+        counts the pauses by duration: entry 0 holds the pauses shorter than 100 microseconds,
+        and each following entry covers twice the range of the previous one, so entry 1 holds
+        the pauses from 100 to 200 microseconds, entry 2 those from 200 to 400, and so on. The
+        last entry also holds all longer pauses.
+    \li \c allocatedBytesPerSizeClass holds the total number of bytes allocated for objects of
+        each size class. Entry \e n holds the objects taking up \e n 32 byte slots, the last
+        entry all larger objects that still fit into a heap chunk.
+    \li \c hugeItemAllocations is the number of objects too large for a heap chunk that have
+        been allocated, \c liveHugeItems the number of those that are still alive.
+    \li \c heapSize is the memory held by the chunks for regular sized objects, and
+        \c usedHeapSize the part of it that is occupied by objects. The difference is free
+        memory fragmented across the chunks.
+    \endlist
+
+    \sa QJSEngine::garbageCollectionStatistics()
+*/
+
+/*!
+    \since 6.6
+
+    Returns statistics about the garbage collector of this engine. Collecting the statistics
+    is cheap, and they are always enabled.
+
+    \sa collectGarbage()
+*/
+QJSEngine::GarbageCollectionStatistics QJSEngine::garbageCollectionStatistics() const
+{
+    QV4::MemoryManager *mm = m_v4Engine->memoryManager;
+
+    // The chunks can only be inspected once any pending sweep is done.
+    mm->finishBackgroundSweep();
+
+    GarbageCollectionStatistics result;
+    result.collections = mm->statistics.fullGCs;
+    result.totalMarkTime = mm->statistics.totalMarkTime;
+    result.totalSweepTime = mm->statistics.totalSweepTime;
+    result.longestPause = mm->statistics.longestPause;
+    result.pauseHistogram = QList<quint64>(std::begin(mm->statistics.pauseHistogram),
+                                           std::end(mm->statistics.pauseHistogram));
+    result.allocatedBytesPerSizeClass = QList<quint64>(std::begin(mm->statistics.allocatedBytes),
+                                                       std::end(mm->statistics.allocatedBytes));
+    result.hugeItemAllocations = mm->statistics.hugeItemAllocations;
+    result.liveHugeItems = mm->hugeItemAllocator.chunks.size();
+    result.heapSize = mm->blockAllocator.allocatedMem() + mm->icAllocator.allocatedMem();
+    result.usedHeapSize = mm->getUsedMem();
+    return result;
+}
+
 /*!
     \since 5.6
 
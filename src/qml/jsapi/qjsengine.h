@@ -272,6 +272,21 @@ public:
 
     void collectGarbage();
 
+    struct GarbageCollectionStatistics
+    {
+        quint64 collections = 0;
+        qint64 totalMarkTime = 0;
+        qint64 totalSweepTime = 0;
+        qint64 longestPause = 0;
+        QList<quint64> pauseHistogram;
+        QList<quint64> allocatedBytesPerSizeClass;
+        quint64 hugeItemAllocations = 0;
+        quint64 liveHugeItems = 0;
+        quint64 heapSize = 0;
+        quint64 usedHeapSize = 0;
+    };
+    GarbageCollectionStatistics garbageCollectionStatistics() const;
+
     enum ObjectOwnership { CppOwnership, JavaScriptOwnership };
     static void setObjectOwnership(QObject *, ObjectOwnership);
     static ObjectOwnership objectOwnership(QObject *);
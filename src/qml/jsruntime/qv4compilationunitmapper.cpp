@@ -3,6 +3,7 @@
 
 #include "qv4compilationunitmapper_p.h"
 
+#include <private/qv4compilationunitbundle_p.h>
 #include <private/qv4compileddata_p.h>
 #include <private/qv4executablecompilationunit_p.h>
 
@@ -10,6 +11,10 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qhash.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 using namespace QV4;
@@ -47,6 +52,191 @@ private:
 QHash<QString, CompilationUnitMapper> StaticUnitCache::s_staticUnits;
 QMutex StaticUnitCache::s_mutex;
 
+// The units of all the files in a directory, mapped once from a bundle.
+class UnitBundle
+{
+public:
+    bool open(const QString &filePath);
+    CompiledData::Unit *unit(QByteArrayView fileName, QString *errorString);
+
+private:
+    QByteArrayView nameAt(quint32 index) const
+    {
+        const CompiledData::BundleEntry &entry = m_entries[index];
+        return QByteArrayView(m_data + entry.nameOffset, entry.nameSize);
+    }
+
+    enum UnitState : quint8 { Unchecked, Valid, Corrupt };
+
+    QFile m_file;
+    const char *m_data = nullptr;
+    const CompiledData::BundleEntry *m_entries = nullptr;
+    quint32 m_count = 0;
+    std::unique_ptr<std::atomic<quint8>[]> m_states;
+};
+
+bool UnitBundle::open(const QString &filePath)
+{
+    using namespace CompiledData;
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+
+    const qint64 size = m_file.size();
+    if (size < qint64(sizeof(BundleHeader)))
+        return false;
+
+    const uchar *data = m_file.map(0, size);
+    if (!data)
+        return false;
+    m_data = reinterpret_cast<const char *>(data);
+
+    // Only the header and the index are checked here, so that the units of
+    // files that are never loaded are not read at all.
+    const BundleHeader *header = reinterpret_cast<const BundleHeader *>(m_data);
+    if (strncmp(header->magic, bundle_magic_str, sizeof(header->magic))
+            || header->version != quint32(QV4_DATA_STRUCTURE_VERSION)
+            || header->qtVersion != quint32(QT_VERSION)
+            || header->size != quint64(size)) {
+        return false;
+    }
+
+    const quint64 indexEnd = quint64(header->indexOffset)
+            + quint64(header->unitCount) * sizeof(BundleEntry);
+    if (header->indexOffset % alignof(BundleEntry) || indexEnd > quint64(size))
+        return false;
+
+    m_entries = reinterpret_cast<const BundleEntry *>(m_data + header->indexOffset);
+    m_count = header->unitCount;
+    for (quint32 i = 0; i < m_count; ++i) {
+        const BundleEntry &entry = m_entries[i];
+        if (quint64(entry.nameOffset) + entry.nameSize > quint64(size)
+                || entry.unitOffset % BundleUnitAlignment
+                || entry.unitSize < sizeof(Unit)
+                || quint64(entry.unitOffset) + entry.unitSize > quint64(size)) {
+            return false;
+        }
+        if (i > 0 && nameAt(i - 1).compare(nameAt(i)) >= 0)
+            return false;
+    }
+
+    m_states = std::make_unique<std::atomic<quint8>[]>(m_count);
+    return true;
+}
+
+CompiledData::Unit *UnitBundle::unit(QByteArrayView fileName, QString *errorString)
+{
+    quint32 low = 0;
+    quint32 high = m_count;
+    while (low < high) {
+        const quint32 middle = low + (high - low) / 2;
+        if (nameAt(middle).compare(fileName) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == m_count || nameAt(low) != fileName) {
+        *errorString = QStringLiteral("File is not in the cache bundle");
+        return nullptr;
+    }
+
+    const CompiledData::BundleEntry &entry = m_entries[low];
+    const char *unitData = m_data + quint64(entry.unitOffset);
+
+    // Checking the unit reads all of it, which is going to happen anyway once
+    // it is used. Concurrent first uses may both check it, to the same result.
+    std::atomic<quint8> &state = m_states[low];
+    if (state.load(std::memory_order_acquire) == Unchecked) {
+        const QByteArray checksum
+                = CompiledData::BundleEntry::calculateChecksum(unitData, entry.unitSize);
+        const bool valid = checksum == QByteArrayView(entry.checksum, sizeof(entry.checksum));
+        state.store(valid ? Valid : Corrupt, std::memory_order_release);
+    }
+    if (state.load(std::memory_order_acquire) != Valid) {
+        *errorString = QStringLiteral("Checksum mismatch in the cache bundle");
+        return nullptr;
+    }
+
+    // The checksum only covers the entry, so a unit claiming to be larger
+    // would have its tables read past it, into the next unit or off the map.
+    auto unit = reinterpret_cast<CompiledData::Unit *>(const_cast<char *>(unitData));
+    if (unit->unitSize > entry.unitSize) {
+        *errorString = QStringLiteral("Unit size exceeds its entry in the cache bundle");
+        return nullptr;
+    }
+
+    return unit;
+}
+
+class UnitBundleCache
+{
+public:
+    UnitBundleCache() : m_lock(&s_mutex) {}
+
+    // Returns the bundle for the directory, or nullptr if it has none. Either
+    // way, the file system is only asked once per directory.
+    UnitBundle *get(const QString &directory)
+    {
+        const auto it = s_bundles.constFind(directory);
+        if (it != s_bundles.constEnd())
+            return *it;
+
+        auto bundle = std::make_unique<UnitBundle>();
+        if (!bundle->open(directory + QLatin1Char('/')
+                          + QLatin1String(CompiledData::bundleFileName))) {
+            bundle.reset();
+        }
+        return *s_bundles.insert(directory, bundle.release());
+    }
+
+private:
+    QMutexLocker<QMutex> m_lock;
+
+    static QMutex s_mutex;
+
+    // Like static units, bundles are never unmapped.
+    static QHash<QString, UnitBundle *> s_bundles;
+};
+
+QHash<QString, UnitBundle *> UnitBundleCache::s_bundles;
+QMutex UnitBundleCache::s_mutex;
+
+CompiledData::Unit *CompilationUnitMapper::getFromBundle(
+        const QString &sourcePath, const QDateTime &sourceTimeStamp, QString *errorString)
+{
+    const qsizetype slash = sourcePath.lastIndexOf(QLatin1Char('/'));
+    if (slash < 0) {
+        *errorString = QStringLiteral("No directory for the cache bundle");
+        return nullptr;
+    }
+
+    UnitBundle *bundle = UnitBundleCache().get(sourcePath.left(slash));
+    if (!bundle) {
+        *errorString = QStringLiteral("No cache bundle");
+        return nullptr;
+    }
+
+    CompiledData::Unit *unit = bundle->unit(
+                QStringView(sourcePath).mid(slash + 1).toUtf8(), errorString);
+    if (!unit)
+        return nullptr;
+
+    if (!(unit->flags & CompiledData::Unit::StaticData)) {
+        *errorString = QStringLiteral("Unit in the cache bundle is not static data");
+        return nullptr;
+    }
+
+    if (!ExecutableCompilationUnit::verifyHeader(unit, sourceTimeStamp, errorString))
+        return nullptr;
+
+    // Static data is never unmapped by close(), so the unit can be handed out
+    // like one mapped from its own file.
+    close();
+    dataPtr = unit;
+    return unit;
+}
+
 CompiledData::Unit *CompilationUnitMapper::get(
         const QString &cacheFilePath, const QDateTime &sourceTimeStamp, QString *errorString)
 {
@@ -31,6 +31,8 @@ class CompilationUnitMapper
 public:
     CompiledData::Unit *get(
             const QString &cacheFilePath, const QDateTime &sourceTimeStamp, QString *errorString);
+    CompiledData::Unit *getFromBundle(
+            const QString &sourcePath, const QDateTime &sourceTimeStamp, QString *errorString);
     static void invalidate(const QString &cacheFilePath);
 
 private:
@@ -108,6 +108,8 @@ using namespace QV4;
 static QBasicAtomicInt engineSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
 int ExecutionEngine::s_maxCallDepth = -1;
 int ExecutionEngine::s_jitCallCountThreshold = 3;
+int ExecutionEngine::s_jitOptimizeCallCountThreshold = 50;
+int ExecutionEngine::s_jitBackEdgeCountThreshold = 1000;
 int ExecutionEngine::s_maxJSStackSize = 4 * 1024 * 1024;
 int ExecutionEngine::s_maxGCStackSize = 2 * 1024 * 1024;
 
@@ -313,8 +315,22 @@ void ExecutionEngine::initializeStaticMembers()
     s_jitCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_CALL_THRESHOLD", &ok);
     if (!ok)
         s_jitCallCountThreshold = 3;
-    if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER"))
+    ok = false;
+    s_jitBackEdgeCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_LOOP_THRESHOLD", &ok);
+    if (!ok)
+        s_jitBackEdgeCountThreshold = 1000;
+    ok = false;
+    s_jitOptimizeCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_OPTIMIZE_THRESHOLD",
+                                                                   &ok);
+    if (!ok)
+        s_jitOptimizeCallCountThreshold = 50;
+    else if (s_jitOptimizeCallCountThreshold < 0)
+        s_jitOptimizeCallCountThreshold = std::numeric_limits<int>::max();
+    if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER")) {
         s_jitCallCountThreshold = std::numeric_limits<int>::max();
+        s_jitBackEdgeCountThreshold = std::numeric_limits<int>::max();
+        s_jitOptimizeCallCountThreshold = std::numeric_limits<int>::max();
+    }
 
     qMetaTypeId<QJSValue>();
     qMetaTypeId<QList<int> >();
@@ -2203,6 +2219,12 @@ static ExecutionEngine::DiskCacheOptions transFormDiskCache(const char *v)
             result |= DiskCache::QmlcWrite;
         else if (option == "qmlc")
             result |= DiskCache::Qmlc;
+        else if (option == "jit-read")
+            result |= DiskCache::JitRead;
+        else if (option == "jit-write")
+            result |= DiskCache::JitWrite;
+        else if (option == "jit")
+            result |= DiskCache::Jit;
         else
             qWarning() << "Ignoring unknown option to QML_DISK_CACHE:" << option;
     }
@@ -145,8 +145,11 @@ public:
         AotNative   = 1 << 1,
         QmlcRead    = 1 << 2,
         QmlcWrite   = 1 << 3,
+        JitRead     = 1 << 4, // opt-in, not part of Enabled
+        JitWrite    = 1 << 5, // opt-in, not part of Enabled
         Aot         = AotByteCode | AotNative,
         Qmlc        = QmlcRead | QmlcWrite,
+        Jit         = JitRead | JitWrite,
         Enabled     = Aot | Qmlc,
 
     };
@@ -690,6 +693,36 @@ public:
 #endif
     }
 
+    // Counts a loop iteration run by the interpreter. Returns true every
+    // s_jitBackEdgeCountThreshold iterations if f can be jitted.
+    bool countBackEdge(Function *f)
+    {
+        if (++f->interpreterBackEdgeCount < s_jitBackEdgeCountThreshold)
+            return false;
+        f->interpreterBackEdgeCount = 0;
+        return canJIT() && f->kind != Function::AotCompiled && !f->isGenerator();
+    }
+
+    // Whether f should collect type feedback so that it can later be recompiled by the
+    // optimizing tier of the JIT. That tier relies on 64 bit values fitting into a register.
+    bool canCollectTypeFeedback(Function *f)
+    {
+#if QT_CONFIG(qml_jit) && QT_POINTER_SIZE == 8
+        return m_canAllocateExecutableMemory
+                && s_jitOptimizeCallCountThreshold != std::numeric_limits<int>::max()
+                && f->kind != Function::AotCompiled
+                && !f->isGenerator();
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
+    bool canOptimizeJIT(Function *f)
+    {
+        return f->typeFeedback && f->jittedCallCount >= s_jitOptimizeCallCountThreshold;
+    }
+
     QV4::ReturnedValue global();
     void initQmlGlobalObject();
     void initializeGlobal();
@@ -827,6 +860,8 @@ private:
 
     static int s_maxCallDepth;
     static int s_jitCallCountThreshold;
+    static int s_jitOptimizeCallCountThreshold;
+    static int s_jitBackEdgeCountThreshold;
     static int s_maxJSStackSize;
     static int s_maxGCStackSize;
 
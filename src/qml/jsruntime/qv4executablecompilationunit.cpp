@@ -15,6 +15,7 @@
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qqmlvaluetypewrapper_p.h>
 #include <private/qqmlscriptdata_p.h>
+#include <private/qqmlliteralplan_p.h>
 #include <private/qv4module_p.h>
 #include <private/qv4compilationunitmapper_p.h>
 #include <private/qml_compile_hash_p.h>
@@ -22,6 +23,9 @@
 #include <private/inlinecomponentutils_p.h>
 #include <private/qv4resolvedtypereference_p.h>
 #include <private/qv4objectiterator_p.h>
+#if QT_CONFIG(qml_jit)
+#include <private/qv4jitcodecache_p.h>
+#endif
 
 #include <QtQml/qqmlfile.h>
 #include <QtQml/qqmlpropertymap.h>
@@ -32,9 +36,12 @@
 #include <QtCore/qscopeguard.h>
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/qloggingcategory.h>
 
 static_assert(QV4::CompiledData::QmlCompileHashSpace > QML_COMPILE_HASH_LENGTH);
 
+Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
+
 #if defined(QML_COMPILE_HASH) && defined(QML_COMPILE_HASH_LENGTH) && QML_COMPILE_HASH_LENGTH > 0
 #  ifdef Q_OS_LINUX
 // Place on a separate section on Linux so it's easier to check from outside
@@ -173,6 +180,20 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
         }
     }
 
+#if QT_CONFIG(qml_jit)
+    // The JIT code is stored next to the cache file of the unit, so only units for local files
+    // that are read from or written to the disk cache get one.
+    const ExecutionEngine::DiskCacheOptions diskCacheOptions = engine->diskCacheOptions();
+    if ((diskCacheOptions & ExecutionEngine::DiskCache::Jit) && !jitCodeCache
+            && (backingFile || (diskCacheOptions & ExecutionEngine::DiskCache::QmlcWrite))
+            && url().isLocalFile()) {
+        jitCodeCache = std::make_unique<JIT::JitCodeCache>(
+                    JIT::JitCodeCache::filePath(localCacheFilePath(url())), data,
+                    diskCacheOptions.testFlag(ExecutionEngine::DiskCache::JitRead),
+                    diskCacheOptions.testFlag(ExecutionEngine::DiskCache::JitWrite));
+    }
+#endif
+
     runtimeFunctions.resize(data->functionTableSize);
     static bool ignoreAotCompiledFunctions
             = qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER")
@@ -269,6 +290,17 @@ Heap::Object *ExecutableCompilationUnit::templateObjectAt(int index) const
 
 void ExecutableCompilationUnit::unlink()
 {
+    static const bool showLookupStatistics
+            = qEnvironmentVariableIsSet("QV4_SHOW_LOOKUP_STATISTICS");
+    if (showLookupStatistics && runtimeLookups && data->lookupTableSize) {
+        const LookupStatistics statistics = lookupStatistics();
+        qDebug().nospace() << "Lookups of " << fileName() << ": "
+                           << statistics.unresolved << " unresolved, "
+                           << statistics.monomorphic << " monomorphic, "
+                           << statistics.polymorphic << " polymorphic, "
+                           << statistics.megamorphic << " megamorphic";
+    }
+
     if (engine)
         nextCompilationUnit.remove();
 
@@ -297,6 +329,14 @@ void ExecutableCompilationUnit::unlink()
     delete [] runtimeLookups;
     runtimeLookups = nullptr;
 
+#if QT_CONFIG(qml_jit)
+    if (jitCodeCache && jitCodeCache->isDirty()) {
+        QString errorString;
+        if (!jitCodeCache->save(&errorString))
+            qCDebug(DBG_DISK_CACHE) << "Error saving JIT code of" << fileName() << "to disk:" << errorString;
+    }
+#endif
+
     for (QV4::Function *f : std::as_const(runtimeFunctions))
         f->destroy();
     runtimeFunctions.clear();
@@ -309,6 +349,31 @@ void ExecutableCompilationUnit::unlink()
     runtimeClasses = nullptr;
 }
 
+ExecutableCompilationUnit::LookupStatistics ExecutableCompilationUnit::lookupStatistics() const
+{
+    LookupStatistics statistics;
+    if (!runtimeLookups)
+        return statistics;
+
+    for (uint i = 0; i < data->lookupTableSize; ++i) {
+        switch (runtimeLookups[i].state()) {
+        case Lookup::State::Unresolved:
+            ++statistics.unresolved;
+            break;
+        case Lookup::State::Monomorphic:
+            ++statistics.monomorphic;
+            break;
+        case Lookup::State::Polymorphic:
+            ++statistics.polymorphic;
+            break;
+        case Lookup::State::Megamorphic:
+            ++statistics.megamorphic;
+            break;
+        }
+    }
+    return statistics;
+}
+
 void ExecutableCompilationUnit::markObjects(QV4::MarkStack *markStack)
 {
     if (runtimeStrings) {
@@ -827,11 +892,9 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
     const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(url);
     auto cacheFile = std::make_unique<CompilationUnitMapper>();
 
-    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
-    for (const QString &cachePath : cachePaths) {
-        CompiledData::Unit *mappedUnit = cacheFile->get(cachePath, sourceTimeStamp, errorString);
+    const auto useMappedUnit = [&](CompiledData::Unit *mappedUnit) {
         if (!mappedUnit)
-            continue;
+            return false;
 
         const CompiledData::Unit * const oldDataPtr
                 = (data && !(data->flags & QV4::CompiledData::Unit::StaticData)) ? data
@@ -845,11 +908,11 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         if (data->sourceFileIndex != 0) {
             if (data->sourceFileIndex >= data->stringTableSize + dynamicStrings.size()) {
                 *errorString = QStringLiteral("QML source file index is invalid.");
-                continue;
+                return false;
             }
             if (sourcePath != QQmlFile::urlToLocalFileOrQrc(stringAt(data->sourceFileIndex))) {
                 *errorString = QStringLiteral("QML source file has moved to a different location.");
-                continue;
+                return false;
             }
         }
 
@@ -857,6 +920,16 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         free(const_cast<CompiledData::Unit*>(oldDataPtr));
         backingFile = std::move(cacheFile);
         return true;
+    };
+
+    // A bundle of the units of the whole directory saves opening a file per unit.
+    if (useMappedUnit(cacheFile->getFromBundle(sourcePath, sourceTimeStamp, errorString)))
+        return true;
+
+    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
+    for (const QString &cachePath : cachePaths) {
+        if (useMappedUnit(cacheFile->get(cachePath, sourceTimeStamp, errorString)))
+            return true;
     }
 
     return false;
@@ -30,6 +30,7 @@ QT_BEGIN_NAMESPACE
 
 class QQmlScriptData;
 class QQmlEnginePrivate;
+class QQmlLiteralPlan;
 
 struct InlineComponentData {
 
@@ -57,6 +58,9 @@ typedef QVector<const QQmlPropertyData *> BindingPropertyData;
 
 class CompilationUnitMapper;
 class ResolvedTypeReference;
+#if QT_CONFIG(qml_jit)
+namespace JIT { class JitCodeCache; }
+#endif
 // map from name index
 struct ResolvedTypeReferenceMap: public QHash<int, ResolvedTypeReference*>
 {
@@ -152,6 +156,10 @@ public:
     QHash<int, InlineComponentData> inlineComponentData;
 
     std::unique_ptr<CompilationUnitMapper> backingFile;
+    std::unique_ptr<QQmlLiteralPlan> literalPlan;
+#if QT_CONFIG(qml_jit)
+    std::unique_ptr<JIT::JitCodeCache> jitCodeCache;
+#endif
 
     // --- interface for QQmlPropertyCacheCreator
     using CompiledObject = const CompiledData::Object;
@@ -278,6 +286,16 @@ public:
 
     void markObjects(MarkStack *markStack);
 
+    // How many of the lookups are in which state, see Lookup::State.
+    struct LookupStatistics
+    {
+        uint unresolved = 0;
+        uint monomorphic = 0;
+        uint polymorphic = 0;
+        uint megamorphic = 0;
+    };
+    LookupStatistics lookupStatistics() const;
+
     bool loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString);
 
     static QString localCacheFilePath(const QUrl &url);
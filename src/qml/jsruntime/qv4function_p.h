@@ -20,6 +20,8 @@
 #include <private/qv4context_p.h>
 #include <private/qv4string_p.h>
 
+#include <limits>
+
 namespace JSC {
 class MacroAssemblerCodeRef;
 }
@@ -79,10 +81,47 @@ public:
     // first nArguments names in internalClass are the actual arguments
     Heap::InternalClass *internalClass;
     int interpreterCallCount = 0;
+
+    // Entry points into the jitted code at loop headers, by bytecode offset, used to move an
+    // interpreted frame into the jitted code while it is running a loop.
+    QHash<int, JittedCode> loopEntryPoints;
+    int interpreterBackEdgeCount = 0;
+
+    // Per instruction type feedback for the optimizing JIT, indexed by the offset of the
+    // instruction following the one the feedback is for.
+    enum TypeFeedback : quint8 {
+        SawDouble = 0x1, // saw numbers that weren't both integers
+        SawOther = 0x2,  // saw operands that weren't numbers
+        SawNonInt = 0x4, // missed the integer fast path of the baseline JIT
+        SawInt = 0x8     // saw integers with an integral result, for Div which has no fast path
+    };
+    std::unique_ptr<quint8[]> typeFeedback;
+
+    static quint8 divisionFeedback(const Value &lhs, const Value &rhs)
+    {
+        if (!lhs.isNumber() || !rhs.isNumber())
+            return SawOther;
+        if (lhs.isInteger() && rhs.isInteger()) {
+            const int l = lhs.int_32();
+            const int r = rhs.int_32();
+            // Exclude the results that can't be represented as int: fractions, -0 and 2^31
+            if (r != 0 && !(l == std::numeric_limits<int>::min() && r == -1) && l % r == 0
+                    && !(l == 0 && r < 0)) {
+                return SawInt;
+            }
+        }
+        return SawDouble;
+    }
+
+    // Baseline code that frames still running may return into after optimizing the function.
+    JSC::MacroAssemblerCodeRef *baselineCodeRef = nullptr;
+    int jittedCallCount = 0;
+
     quint16 nFormals;
     enum Kind : quint8 { JsUntyped, JsTyped, AotCompiled, Eval };
     Kind kind = JsUntyped;
     bool detectedInjectedParameters = false;
+    bool lookedUpCachedCode = false; // in the JIT code cache of the compilation unit
 
     static Function *create(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
                             const CompiledData::Function *function,
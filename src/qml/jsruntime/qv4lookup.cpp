@@ -5,6 +5,7 @@
 #include <private/qv4identifiertable_p.h>
 #include <QtQml/private/qv4runtime_p.h>
 #include <QtQml/private/qv4qobjectwrapper_p.h>
+#include <QtQml/private/qv4profiling_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -109,6 +110,7 @@ ReturnedValue Lookup::resolveGlobalGetter(ExecutionEngine *engine)
 
 ReturnedValue Lookup::getterGeneric(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupUnresolved);
     if (const Object *o = object.as<Object>())
         return l->resolveGetter(engine, o);
     return l->resolvePrimitiveGetter(engine, object);
@@ -140,15 +142,68 @@ static inline void setupProtoLookupTwoClasses(Lookup *l, const Lookup &first, co
     l->protoLookupTwoClasses.data2 = data2;
 }
 
+static inline void initializeEntry(Lookup *entry, const Lookup &l)
+{
+    memset(entry, 0, sizeof(Lookup));
+    entry->nameIndex = l.nameIndex;
+    entry->forCall = l.forCall;
+}
+
+// Takes over the state of first and second, including their references to property caches.
+static void setupPolymorphicLookup(Lookup *l, const Lookup &first, const Lookup &second)
+{
+    PolymorphicLookup *polymorphic = new PolymorphicLookup;
+    polymorphic->entries[0] = first;
+    polymorphic->entries[1] = second;
+    polymorphic->count = 2;
+
+    l->clear();
+    l->polymorphicLookup.polymorphic = polymorphic;
+}
+
+static bool isPolymorphicGetterEntry(const Lookup &entry)
+{
+    return entry.getter == Lookup::getter0Inline
+            || entry.getter == Lookup::getter0MemberData
+            || entry.getter == Lookup::getterAccessor
+            || entry.getter == Lookup::getterProto
+            || entry.getter == Lookup::getterProtoAccessor
+            || entry.getter == Lookup::getterQObject
+            || entry.getter == Lookup::getterQObjectMethod;
+}
+
+static bool isPolymorphicSetterEntry(const Lookup &entry)
+{
+    return entry.setter == Lookup::setter0Inline
+            || entry.setter == Lookup::setter0MemberData
+            || entry.setter == Lookup::setterInsert;
+}
+
+// The check the getter of the entry does itself. If it succeeds, the getter won't change the
+// entry, unless a QObject has lost its QQmlData.
+static bool polymorphicGetterEntryMatches(const Lookup &entry, const Heap::Object *o)
+{
+    if (entry.getter == Lookup::getterProto || entry.getter == Lookup::getterProtoAccessor)
+        return entry.protoLookup.protoId == o->internalClass->protoId;
+    if (entry.getter == Lookup::getterQObject)
+        return entry.qobjectLookup.ic == o->internalClass;
+    if (entry.getter == Lookup::getterQObjectMethod)
+        return entry.qobjectMethodLookup.ic == o->internalClass;
+    if (entry.getter == Lookup::getter0Inline || entry.getter == Lookup::getter0MemberData
+            || entry.getter == Lookup::getterAccessor) {
+        return entry.objectLookup.ic == o->internalClass;
+    }
+    return false;
+}
+
 ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
     if (const Object *o = object.as<Object>()) {
 
         // Do the resolution on a second lookup, then merge.
         Lookup second;
-        memset(&second, 0, sizeof(Lookup));
-        second.nameIndex = l->nameIndex;
-        second.forCall = l->forCall;
+        initializeEntry(&second, *l);
         second.getter = getterGeneric;
         const ReturnedValue result = second.resolveGetter(engine, o);
 
@@ -183,16 +238,112 @@ ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const
             return result;
         }
 
+        if (isPolymorphicGetterEntry(*l) && isPolymorphicGetterEntry(second)) {
+            setupPolymorphicLookup(l, *l, second);
+            l->getter = getterPolymorphic;
+            return result;
+        }
+
         // If any of the above options were true, the propertyCache was inactive.
+        Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+        l->megamorphic = true;
         second.releasePropertyCache();
+        l->releasePropertyCache();
+        l->getter = getterFallback;
+        return result;
+    }
+
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+    l->megamorphic = true;
+    l->releasePropertyCache();
+    l->getter = getterFallback;
+    return getterFallback(l, engine, object);
+}
+
+// Turns a lookup specialized for two classes into a polymorphic one, so that more classes can
+// be added.
+static ReturnedValue getterPolymorphicFromTwoClasses(
+        Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
+
+    Lookup first;
+    Lookup second;
+    memset(&first, 0, sizeof(Lookup));
+    memset(&second, 0, sizeof(Lookup));
+
+    if (l->getter == Lookup::getterProtoTwoClasses
+            || l->getter == Lookup::getterProtoAccessorTwoClasses) {
+        first.getter = second.getter = (l->getter == Lookup::getterProtoTwoClasses)
+                ? Lookup::getterProto
+                : Lookup::getterProtoAccessor;
+        first.protoLookup.protoId = l->protoLookupTwoClasses.protoId;
+        first.protoLookup.data = l->protoLookupTwoClasses.data;
+        second.protoLookup.protoId = l->protoLookupTwoClasses.protoId2;
+        second.protoLookup.data = l->protoLookupTwoClasses.data2;
+    } else {
+        first.getter = (l->getter == Lookup::getter0MemberDatagetter0MemberData)
+                ? Lookup::getter0MemberData
+                : Lookup::getter0Inline;
+        second.getter = (l->getter == Lookup::getter0Inlinegetter0Inline)
+                ? Lookup::getter0Inline
+                : Lookup::getter0MemberData;
+        first.objectLookup.ic = l->objectLookupTwoClasses.ic;
+        first.objectLookup.offset = l->objectLookupTwoClasses.offset;
+        second.objectLookup.ic = l->objectLookupTwoClasses.ic2;
+        second.objectLookup.offset = l->objectLookupTwoClasses.offset2;
+    }
+
+    setupPolymorphicLookup(l, first, second);
+    l->getter = Lookup::getterPolymorphic;
+    return Lookup::getterPolymorphic(l, engine, object);
+}
+
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    PolymorphicLookup *polymorphic = l->polymorphicLookup.polymorphic;
+
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    if (Heap::Object *o = static_cast<Heap::Object *>(object.heapObject())) {
+        for (uint i = 0; i < polymorphic->count; ++i) {
+            Lookup *entry = polymorphic->entries + i;
+            if (polymorphicGetterEntryMatches(*entry, o))
+                return entry->getter(entry, engine, object);
+        }
     }
 
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
+    if (const Object *o = object.as<Object>()) {
+        if (polymorphic->count < PolymorphicLookup::MaxEntries) {
+            Lookup *entry = polymorphic->entries + polymorphic->count;
+            initializeEntry(entry, *l);
+            entry->getter = getterGeneric;
+            const ReturnedValue result = entry->resolveGetter(engine, o);
+            if (isPolymorphicGetterEntry(*entry)) {
+                ++polymorphic->count;
+                return result;
+            }
+            Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+            l->megamorphic = true;
+            entry->releasePropertyCache();
+            l->releasePropertyCache();
+            l->getter = getterFallback;
+            return result;
+        }
+    }
+
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+    l->megamorphic = true;
+    l->releasePropertyCache();
     l->getter = getterFallback;
     return getterFallback(l, engine, object);
 }
 
 ReturnedValue Lookup::getterFallback(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
+    Q_V4_PROFILE_LOOKUP(engine, l->megamorphic ? Profiling::LookupMegamorphic
+                                               : Profiling::LookupFallback);
     QV4::Scope scope(engine);
     QV4::ScopedObject o(scope, object.toObject(scope.engine));
     if (!o)
@@ -266,8 +417,7 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicFromTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -281,8 +431,7 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicFromTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -296,8 +445,7 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicFromTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -313,10 +461,8 @@ ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine,
             return l->protoLookupTwoClasses.data->asReturnedValue();
         if (l->protoLookupTwoClasses.protoId2 == o->internalClass->protoId)
             return l->protoLookupTwoClasses.data2->asReturnedValue();
-        return getterFallback(l, engine, object);
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicFromTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -334,8 +480,7 @@ ReturnedValue Lookup::getterAccessor(Lookup *l, ExecutionEngine *engine, const V
                                      &object, nullptr, 0));
         }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -379,8 +524,7 @@ ReturnedValue Lookup::getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *
                                      &object, nullptr, 0));
         }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicFromTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getterIndexed(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -402,7 +546,15 @@ ReturnedValue Lookup::getterIndexed(Lookup *l, ExecutionEngine *engine, const Va
 
 ReturnedValue Lookup::getterQObject(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
+    // Objects of a different shape make the lookup polymorphic, rather than replacing it.
+    const Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o && o->internalClass != lookup->qobjectLookup.ic && object.isObject()
+            && lookup->getter == getterQObject) {
+        return getterTwoClasses(lookup, engine, object);
+    }
+
     const auto revertLookup = [lookup, engine, &object]() {
+        Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupQObjectReverted);
         lookup->qobjectLookup.propertyCache->release();
         lookup->qobjectLookup.propertyCache = nullptr;
         lookup->getter = Lookup::getterGeneric;
@@ -433,7 +585,14 @@ ReturnedValue Lookup::getterQObjectAsVariant(
 
 ReturnedValue Lookup::getterQObjectMethod(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
+    const Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o && o->internalClass != lookup->qobjectMethodLookup.ic && object.isObject()
+            && lookup->getter == getterQObjectMethod) {
+        return getterTwoClasses(lookup, engine, object);
+    }
+
     const auto revertLookup = [lookup, engine, &object]() {
+        Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupQObjectReverted);
         lookup->qobjectMethodLookup.propertyCache->release();
         lookup->qobjectMethodLookup.propertyCache = nullptr;
         lookup->getter = Lookup::getterGeneric;
@@ -532,6 +691,7 @@ bool Lookup::resolveSetter(ExecutionEngine *engine, Object *object, const Value
 
 bool Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupUnresolved);
     if (object.isObject())
         return l->resolveSetter(engine, static_cast<Object *>(&object), value);
 
@@ -548,38 +708,59 @@ bool Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, co
 
 bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
-    // A precondition of this method is that l->objectLookup is the active variant of the union.
-    Q_ASSERT(l->setter == setter0MemberData || l->setter == setter0Inline);
+    // A precondition of this method is that l is a monomorphic setter that can be an entry of a
+    // polymorphic one.
+    Q_ASSERT(isPolymorphicSetterEntry(*l));
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
 
     if (object.isObject()) {
 
-        // As l->objectLookup is active, we can stash some members here, before resolving.
-        Heap::InternalClass *ic = l->objectLookup.ic;
-        const uint index = l->objectLookup.index;
-
-        if (!l->resolveSetter(engine, static_cast<Object *>(&object), value)) {
+        // Do the resolution on a second lookup, then merge. This also stores the value.
+        Lookup second;
+        initializeEntry(&second, *l);
+        second.setter = setterGeneric;
+        if (!second.resolveSetter(engine, static_cast<Object *>(&object), value)) {
+            Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+            l->megamorphic = true;
+            second.releasePropertyCache();
             l->setter = setterFallback;
             return false;
         }
 
-        if (l->setter == Lookup::setter0MemberData || l->setter == Lookup::setter0Inline) {
-            l->objectLookupTwoClasses.ic = ic;
-            l->objectLookupTwoClasses.ic2 = ic;
+        if (l->setter != setterInsert
+                && (second.setter == setter0MemberData || second.setter == setter0Inline)) {
+            // setter0setter0 uses the indices of the properties, which objectLookup also has.
+            const uint index = l->objectLookup.index;
+            l->objectLookupTwoClasses.ic2 = second.objectLookup.ic;
             l->objectLookupTwoClasses.offset = index;
-            l->objectLookupTwoClasses.offset2 = index;
+            l->objectLookupTwoClasses.offset2 = second.objectLookup.index;
             l->setter = setter0setter0;
             return true;
         }
 
-        l->releasePropertyCache();
+        if (isPolymorphicSetterEntry(second)) {
+            setupPolymorphicLookup(l, *l, second);
+            l->setter = setterPolymorphic;
+            return true;
+        }
+
+        Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+        l->megamorphic = true;
+        second.releasePropertyCache();
+        l->setter = setterFallback;
+        return true;
     }
 
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+    l->megamorphic = true;
     l->setter = setterFallback;
     return setterFallback(l, engine, object, value);
 }
 
 bool Lookup::setterFallback(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
+    Q_V4_PROFILE_LOOKUP(engine, l->megamorphic ? Profiling::LookupMegamorphic
+                                               : Profiling::LookupFallback);
     QV4::Scope scope(engine);
     QV4::ScopedObject o(scope, object.toObject(scope.engine));
     if (!o)
@@ -633,6 +814,75 @@ bool Lookup::setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, c
         }
     }
 
+    // Split into two monomorphic entries, so that more classes can be added.
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
+    Lookup first;
+    Lookup second;
+    initializeEntry(&first, *l);
+    initializeEntry(&second, *l);
+    first.setter = second.setter = setter0MemberData;
+    first.objectLookup.ic = l->objectLookupTwoClasses.ic;
+    first.objectLookup.index = l->objectLookupTwoClasses.offset;
+    second.objectLookup.ic = l->objectLookupTwoClasses.ic2;
+    second.objectLookup.index = l->objectLookupTwoClasses.offset2;
+    setupPolymorphicLookup(l, first, second);
+    l->setter = setterPolymorphic;
+    return setterPolymorphic(l, engine, object, value);
+}
+
+bool Lookup::setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    // Otherwise we cannot trust the protoIds
+    Q_ASSERT(engine->isInitialized);
+
+    PolymorphicLookup *polymorphic = l->polymorphicLookup.polymorphic;
+    if (Heap::Object *o = static_cast<Heap::Object *>(object.heapObject())) {
+        // Only the class and the index of the property are used for the data entries, so
+        // that entries split off setter0setter0 work, too.
+        for (uint i = 0; i < polymorphic->count; ++i) {
+            const Lookup &entry = polymorphic->entries[i];
+            if (entry.setter == setterInsert) {
+                if (o->internalClass->protoId == entry.insertionLookup.protoId) {
+                    Object *obj = static_cast<Object *>(object.managed());
+                    obj->setInternalClass(entry.insertionLookup.newClass);
+                    o->setProperty(engine, entry.insertionLookup.offset, value);
+                    return true;
+                }
+            } else if (o->internalClass == entry.objectLookup.ic) {
+                o->setProperty(engine, entry.objectLookup.index, value);
+                return true;
+            }
+        }
+    }
+
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupShapeChanged);
+    if (object.isObject() && polymorphic->count < PolymorphicLookup::MaxEntries) {
+        Lookup *entry = polymorphic->entries + polymorphic->count;
+        initializeEntry(entry, *l);
+        entry->setter = setterGeneric;
+        if (!entry->resolveSetter(engine, static_cast<Object *>(&object), value)) {
+            Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+            l->megamorphic = true;
+            entry->releasePropertyCache();
+            l->releasePropertyCache();
+            l->setter = setterFallback;
+            return false;
+        }
+        if (isPolymorphicSetterEntry(*entry)) {
+            ++polymorphic->count;
+            return true;
+        }
+        Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+        l->megamorphic = true;
+        entry->releasePropertyCache();
+        l->releasePropertyCache();
+        l->setter = setterFallback;
+        return true;
+    }
+
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupMegamorphic);
+    l->megamorphic = true;
+    l->releasePropertyCache();
     l->setter = setterFallback;
     return setterFallback(l, engine, object, value);
 }
@@ -649,8 +899,7 @@ bool Lookup::setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, con
         return true;
     }
 
-    l->setter = setterFallback;
-    return setterFallback(l, engine, object, value);
+    return setterTwoClasses(l, engine, object, value);
 }
 
 bool Lookup::setterQObject(Lookup *l, ExecutionEngine *engine, Value &object, const Value &v)
@@ -684,4 +933,49 @@ bool Lookup::arrayLengthSetter(Lookup *, ExecutionEngine *engine, Value &object,
     return true;
 }
 
+Lookup::State Lookup::state() const
+{
+    if (getter == getterGeneric || setter == setterGeneric || globalGetter == globalGetterGeneric
+            || qmlContextPropertyGetter
+                == QQmlContextWrapper::resolveQmlContextPropertyLookupGetter) {
+        return State::Unresolved;
+    }
+
+    if (getter == getterFallback || getter == getterFallbackAsVariant
+            || setter == setterFallback || setter == setterFallbackAsVariant) {
+        return State::Megamorphic;
+    }
+
+    if (getter == getterPolymorphic || setter == setterPolymorphic
+            || getter == getter0Inlinegetter0Inline || getter == getter0Inlinegetter0MemberData
+            || getter == getter0MemberDatagetter0MemberData || getter == getterProtoTwoClasses
+            || getter == getterProtoAccessorTwoClasses || setter == setter0setter0) {
+        return State::Polymorphic;
+    }
+
+    return State::Monomorphic;
+}
+
+void Lookup::markPolymorphicEntries(MarkStack *stack)
+{
+    PolymorphicLookup *polymorphic = polymorphicLookup.polymorphic;
+    for (uint i = 0; i < polymorphic->count; ++i)
+        polymorphic->entries[i].markObjects(stack);
+}
+
+void Lookup::releasePolymorphicEntries()
+{
+    PolymorphicLookup *polymorphic = polymorphicLookup.polymorphic;
+    for (uint i = 0; i < polymorphic->count; ++i)
+        polymorphic->entries[i].releasePropertyCache();
+    delete polymorphic;
+
+    // Don't leave a dangling pointer behind. The caller sets up a new state.
+    clear();
+    if (getter == getterPolymorphic)
+        getter = getterGeneric;
+    else
+        setter = setterGeneric;
+}
+
 QT_END_NAMESPACE
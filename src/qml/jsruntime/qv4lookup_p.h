@@ -28,6 +28,8 @@ namespace Heap {
     struct QObjectMethod;
 }
 
+struct PolymorphicLookup;
+
 // Note: We cannot hide the copy ctor and assignment operator of this class because it needs to
 //       be trivially copyable. But you should never ever copy it. There are refcounted members
 //       in there.
@@ -151,11 +153,22 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             Heap::InternalClass *ic;
             Heap::Object *qmlScopedEnumWrapper;
         } qmlScopedEnumWrapperLookup;
+        struct {
+            quintptr unused1; // null, the entries are marked by markObjects()
+            quintptr unused2; // null
+            PolymorphicLookup *polymorphic;
+        } polymorphicLookup;
     };
 
     uint nameIndex: 28; // Same number of bits we store in the compilation unit for name indices
     uint forCall: 1;    // Whether we are looking up a value in order to call it right away
-    uint reserved: 3;
+    uint megamorphic: 1; // Whether the fallback is used because there were too many shapes
+    uint reserved: 2;
+
+    // How many different shapes of objects a lookup has seen so far. Megamorphic lookups have
+    // given up on caching and use the generic fallback.
+    enum class State { Unresolved, Monomorphic, Polymorphic, Megamorphic };
+    State state() const;
 
     ReturnedValue resolveGetter(ExecutionEngine *engine, const Object *object);
     ReturnedValue resolvePrimitiveGetter(ExecutionEngine *engine, const Value &object);
@@ -181,6 +194,7 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static ReturnedValue getterQObject(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObjectAsVariant(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObjectMethod(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
 
     static ReturnedValue primitiveGetterProto(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue primitiveGetterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -199,6 +213,7 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static bool setter0Inline(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static bool setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterQObject(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterQObjectAsVariant(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool arrayLengthSetter(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
@@ -208,6 +223,8 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             markDef.h1->mark(stack);
         if (markDef.h2 && !(reinterpret_cast<quintptr>(markDef.h2) & 1))
             markDef.h2->mark(stack);
+        if (getter == getterPolymorphic || setter == setterPolymorphic)
+            markPolymorphicEntries(stack);
     }
 
     void clear() {
@@ -216,6 +233,11 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
 
     void releasePropertyCache()
     {
+        if (getter == getterPolymorphic || setter == setterPolymorphic) {
+            releasePolymorphicEntries();
+            return;
+        }
+
         if (getter == getterQObject
                 || getter == QQmlTypeWrapper::lookupSingletonProperty
                 || setter == setterQObject
@@ -233,6 +255,20 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
                 pc->release();
         }
     }
+
+private:
+    void markPolymorphicEntries(MarkStack *stack);
+    void releasePolymorphicEntries();
+};
+
+// Out of line storage of a lookup that has seen objects of more than one shape. Each entry is a
+// monomorphic lookup for one of them.
+struct PolymorphicLookup
+{
+    enum { MaxEntries = 4 };
+
+    Lookup entries[MaxEntries];
+    uint count;
 };
 
 Q_STATIC_ASSERT(std::is_standard_layout<Lookup>::value);
@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qv4profiling_p.h"
+#include <private/qv4lookup_p.h>
 #include <private/qv4mm_p.h>
+#include <private/qv4stackframe_p.h>
 #include <private/qv4string_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -33,6 +35,7 @@ Profiler::Profiler(QV4::ExecutionEngine *engine) : featuresEnabled(0), m_engine(
     static const int metatypes[] = {
         qRegisterMetaType<QVector<QV4::Profiling::FunctionCallProperties> >(),
         qRegisterMetaType<QVector<QV4::Profiling::MemoryAllocationProperties> >(),
+        qRegisterMetaType<QVector<QV4::Profiling::LookupProperties> >(),
         qRegisterMetaType<FunctionLocationHash>()
     };
     Q_UNUSED(metatypes);
@@ -44,6 +47,37 @@ void Profiler::stopProfiling()
     featuresEnabled = 0;
     reportData();
     m_sentLocations.clear();
+    m_sentLookupLocations.clear();
+}
+
+void Profiler::trackLookup(const Lookup *lookup, Function *function, LookupResult result)
+{
+    const quintptr id = reinterpret_cast<quintptr>(lookup);
+    const auto last = m_lastLookupEvents.constFind(id);
+    if (last != m_lastLookupEvents.constEnd()) {
+        LookupProperties &event = m_lookup_data[*last];
+        if (event.result == result) {
+            ++event.count;
+            return;
+        }
+    }
+
+    LookupProperties event = {m_timer.nsecsElapsed(), id, result, 1};
+    m_lastLookupEvents.insert(id, m_lookup_data.size());
+    m_lookup_data.append(event);
+
+    // Each lookup belongs to exactly one instruction, so the location of the first access is the
+    // location of the lookup. The marker keeps the compilation unit alive, so that the address of
+    // the lookup can't be reused for a different one while we are profiling.
+    SentMarker &marker = m_sentLookupLocations[id];
+    if (!marker.isValid()) {
+        m_lookupLocations.insert(
+                id, FunctionLocation(
+                        function->compilationUnit->runtimeStrings[lookup->nameIndex]->toQString(),
+                        function->executableCompilationUnit()->fileName(),
+                        m_engine->currentStackFrame->lineNumber(), -1));
+        marker.setFunction(function);
+    }
 }
 
 bool operator<(const FunctionCall &call1, const FunctionCall &call2)
@@ -73,15 +107,20 @@ void Profiler::reportData()
         }
     }
 
-    emit dataReady(locations, properties, m_memory_data);
+    emit dataReady(locations, properties, m_memory_data, m_lookupLocations, m_lookup_data);
     m_data.clear();
     m_memory_data.clear();
+    m_lookupLocations.clear();
+    m_lookup_data.clear();
+    m_lastLookupEvents.clear();
 }
 
 void Profiler::startProfiling(quint64 features)
 {
     if (featuresEnabled == 0) {
         if (features & (1 << FeatureMemoryAllocation)) {
+            // The chunks can only be inspected once any pending sweep is done.
+            m_engine->memoryManager->finishBackgroundSweep();
             qint64 timestamp = m_timer.nsecsElapsed();
             MemoryAllocationProperties heap = {timestamp,
                                                (qint64)m_engine->memoryManager->getAllocatedMem() -
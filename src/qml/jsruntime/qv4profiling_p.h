@@ -25,6 +25,9 @@
 
 #define Q_V4_PROFILE_ALLOC(engine, size, type) (!engine)
 #define Q_V4_PROFILE_DEALLOC(engine, size, type) (!engine)
+#define Q_V4_PROFILE_GC_START(engine) ((void)engine, -1)
+#define Q_V4_PROFILE_GC_END(engine, index) ((void)engine, (void)index)
+#define Q_V4_PROFILE_LOOKUP(engine, result) ((void)engine)
 
 QT_BEGIN_NAMESPACE
 
@@ -35,6 +38,10 @@ class FunctionCallProfiler {
 public:
     FunctionCallProfiler(ExecutionEngine *, Function *) {}
 };
+class LookupProfiler {
+public:
+    LookupProfiler(ExecutionEngine *, Function *, const Lookup *) {}
+};
 }
 }
 
@@ -52,6 +59,18 @@ QT_END_NAMESPACE
             (engine->profiler()->featuresEnabled & (1 << Profiling::FeatureMemoryAllocation)) ?\
         engine->profiler()->trackDealloc(size, type) : false)
 
+#define Q_V4_PROFILE_GC_START(engine) \
+    (engine->profiler() &&\
+            (engine->profiler()->featuresEnabled & (1 << Profiling::FeatureMemoryAllocation)) ?\
+        engine->profiler()->trackGarbageCollectionStart() : -1)
+
+#define Q_V4_PROFILE_GC_END(engine, index) \
+    ((index) >= 0 && engine->profiler() ? engine->profiler()->trackGarbageCollectionEnd(index) : void())
+
+// Records why the lookup currently being profiled by a LookupProfiler left its fast path.
+#define Q_V4_PROFILE_LOOKUP(engine, result) \
+    (engine->profiler() ? engine->profiler()->trackLookupResult(result) : void())
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -60,13 +79,26 @@ namespace Profiling {
 
 enum Features {
     FeatureFunctionCall,
-    FeatureMemoryAllocation
+    FeatureMemoryAllocation,
+    FeatureLookups
 };
 
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    GarbageCollectionPause // not a memory event, size is the duration of the pause in ns
+};
+
+// Why an access through a lookup didn't take the cached fast path. If several apply to the same
+// access, the last one in this list is reported.
+enum LookupResult {
+    LookupHit,
+    LookupUnresolved,       // first access, or the lookup had been reset
+    LookupShapeChanged,     // the object had a shape the lookup wasn't specialized for
+    LookupQObjectReverted,  // a QObject lookup had to be resolved again
+    LookupFallback,         // the property can't be cached, the generic path was taken
+    LookupMegamorphic       // too many different shapes, the lookup gave up on caching
 };
 
 struct FunctionCallProperties {
@@ -100,6 +132,14 @@ struct MemoryAllocationProperties {
     MemoryType type;
 };
 
+// Consecutive accesses through the same lookup with the same result are folded into one event.
+struct LookupProperties {
+    qint64 timestamp; // of the first access
+    quintptr id;
+    LookupResult result;
+    qint64 count;
+};
+
 class FunctionCall {
 public:
     FunctionCall() : m_function(nullptr), m_start(0), m_end(0) {}
@@ -229,6 +269,30 @@ public:
         }
     }
 
+    // The pause is reported when it starts, so that the events stay sorted by timestamp, and
+    // its duration is filled in once it's over.
+    int trackGarbageCollectionStart()
+    {
+        MemoryAllocationProperties pause = {m_timer.nsecsElapsed(), 0, GarbageCollectionPause};
+        m_memory_data.append(pause);
+        return m_memory_data.size() - 1;
+    }
+
+    void trackGarbageCollectionEnd(int index)
+    {
+        if (index < m_memory_data.size() && m_memory_data[index].type == GarbageCollectionPause) {
+            MemoryAllocationProperties &pause = m_memory_data[index];
+            pause.size = m_timer.nsecsElapsed() - pause.timestamp;
+        }
+    }
+
+    void trackLookupResult(LookupResult result)
+    {
+        m_lookupResult = qMax(m_lookupResult, result);
+    }
+
+    void trackLookup(const Lookup *lookup, Function *function, LookupResult result);
+
     quint64 featuresEnabled;
 
     void stopProfiling();
@@ -239,7 +303,9 @@ public:
 Q_SIGNALS:
     void dataReady(const QV4::Profiling::FunctionLocationHash &,
                    const QVector<QV4::Profiling::FunctionCallProperties> &,
-                   const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                   const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                   const QV4::Profiling::FunctionLocationHash &,
+                   const QVector<QV4::Profiling::LookupProperties> &);
 
 private:
     QV4::ExecutionEngine *m_engine;
@@ -247,8 +313,14 @@ private:
     QVector<FunctionCall> m_data;
     QVector<MemoryAllocationProperties> m_memory_data;
     QHash<quintptr, SentMarker> m_sentLocations;
+    QVector<LookupProperties> m_lookup_data;
+    QHash<quintptr, qsizetype> m_lastLookupEvents;
+    FunctionLocationHash m_lookupLocations;
+    QHash<quintptr, SentMarker> m_sentLookupLocations;
+    LookupResult m_lookupResult = LookupHit;
 
     friend class FunctionCallProfiler;
+    friend class LookupProfiler;
 };
 
 class FunctionCallProfiler {
@@ -278,12 +350,44 @@ public:
     qint64 startTime = 0;
 };
 
+// Wraps one access through a lookup. The slow paths of the lookup report via
+// Q_V4_PROFILE_LOOKUP why they were taken. Lookups used by nested calls, for example of accessors,
+// are profiled separately.
+class LookupProfiler {
+    Q_DISABLE_COPY(LookupProfiler)
+public:
+    LookupProfiler(ExecutionEngine *engine, Function *f, const Lookup *l)
+    {
+        Profiler *p = engine->profiler();
+        if (Q_UNLIKELY(p) && (p->featuresEnabled & (1 << Profiling::FeatureLookups))) {
+            profiler = p;
+            function = f;
+            lookup = l;
+            outerResult = std::exchange(p->m_lookupResult, LookupHit);
+        }
+    }
+
+    ~LookupProfiler()
+    {
+        if (profiler) {
+            profiler->trackLookup(lookup, function, profiler->m_lookupResult);
+            profiler->m_lookupResult = outerResult;
+        }
+    }
+
+    Profiler *profiler = nullptr;
+    Function *function = nullptr;
+    const Lookup *lookup = nullptr;
+    LookupResult outerResult = LookupHit;
+};
+
 
 } // namespace Profiling
 } // namespace QV4
 
 Q_DECLARE_TYPEINFO(QV4::Profiling::MemoryAllocationProperties, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCallProperties, Q_RELOCATABLE_TYPE);
+Q_DECLARE_TYPEINFO(QV4::Profiling::LookupProperties, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCall, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionLocation, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::Profiler::SentMarker, Q_RELOCATABLE_TYPE);
@@ -292,6 +396,7 @@ QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QV4::Profiling::FunctionLocationHash)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionCallProperties>)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::MemoryAllocationProperties>)
+Q_DECLARE_METATYPE(QVector<QV4::Profiling::LookupProperties>)
 
 #endif // QT_CONFIG(qml_debug)
 
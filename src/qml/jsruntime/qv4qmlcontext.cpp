@@ -18,6 +18,7 @@
 #include <private/qv4mm_p.h>
 #include <private/qv4module_p.h>
 #include <private/qv4objectproto_p.h>
+#include <private/qv4profiling_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qv4value_p.h>
 
@@ -473,6 +474,7 @@ bool QQmlContextWrapper::virtualPut(Managed *m, PropertyKey id, const Value &val
 
 ReturnedValue QQmlContextWrapper::resolveQmlContextPropertyLookupGetter(Lookup *l, ExecutionEngine *engine, Value *base)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupUnresolved);
     Scope scope(engine);
     auto *func = engine->currentStackFrame->v4Function;
     PropertyKey name =engine->identifierTable->asPropertyKey(
@@ -594,6 +596,7 @@ ReturnedValue QQmlContextWrapper::lookupIdObjectInParentContext(
 
 static ReturnedValue revertObjectPropertyLookup(Lookup *l, ExecutionEngine *engine, Value *base)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupQObjectReverted);
     l->qobjectLookup.propertyCache->release();
     l->qobjectLookup.propertyCache = nullptr;
     l->qmlContextPropertyGetter = QQmlContextWrapper::resolveQmlContextPropertyLookupGetter;
@@ -602,6 +605,7 @@ static ReturnedValue revertObjectPropertyLookup(Lookup *l, ExecutionEngine *engi
 
 static ReturnedValue revertObjectMethodLookup(Lookup *l, ExecutionEngine *engine, Value *base)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupQObjectReverted);
     l->qobjectMethodLookup.propertyCache->release();
     l->qobjectMethodLookup.propertyCache = nullptr;
     l->qmlContextPropertyGetter = QQmlContextWrapper::resolveQmlContextPropertyLookupGetter;
@@ -710,6 +714,7 @@ ReturnedValue QQmlContextWrapper::lookupContextObjectMethod(
 
 ReturnedValue QQmlContextWrapper::lookupScopeFallbackProperty(Lookup *l, ExecutionEngine *engine, Value *base)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupFallback);
     return resolveQmlContextPropertyLookupGetter(l, engine, base);
 }
 
@@ -727,6 +732,7 @@ ReturnedValue QQmlContextWrapper::lookupInGlobalObject(Lookup *l, ExecutionEngin
 
 ReturnedValue QQmlContextWrapper::lookupInParentContextHierarchy(Lookup *l, ExecutionEngine *engine, Value *base)
 {
+    Q_V4_PROFILE_LOOKUP(engine, Profiling::LookupFallback);
     Scope scope(engine);
     Scoped<QmlContext> qmlContext(scope, engine->qmlContext());
     if (!qmlContext)
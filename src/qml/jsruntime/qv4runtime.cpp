@@ -23,6 +23,7 @@
 #include "qv4qobjectwrapper_p.h"
 #include "qv4symbol_p.h"
 #include "qv4generatorobject_p.h"
+#include "qv4profiling_p.h"
 #include <QtQml/private/qv4math_p.h>
 
 #include <QtCore/QDebug>
@@ -1140,13 +1141,16 @@ ReturnedValue Runtime::LoadGlobalLookup::call(ExecutionEngine *engine, Function
 
 ReturnedValue Runtime::LoadQmlContextPropertyLookup::call(ExecutionEngine *engine, uint index)
 {
-    Lookup *l = runtimeLookup(engine->currentStackFrame->v4Function, index);
+    Function *function = engine->currentStackFrame->v4Function;
+    Lookup *l = runtimeLookup(function, index);
+    Profiling::LookupProfiler profiler(engine, function, l);
     return l->qmlContextPropertyGetter(l, engine, nullptr);
 }
 
 ReturnedValue Runtime::GetLookup::call(ExecutionEngine *engine, Function *f, const Value &base, int index)
 {
     Lookup *l = runtimeLookup(f, index);
+    Profiling::LookupProfiler profiler(engine, f, l);
     return l->getter(l, engine, base);
 }
 
@@ -1154,6 +1158,7 @@ void Runtime::SetLookupSloppy::call(Function *f, const Value &base, int index, c
 {
     ExecutionEngine *engine = f->internalClass->engine;
     QV4::Lookup *l = runtimeLookup(f, index);
+    Profiling::LookupProfiler profiler(engine, f, l);
     l->setter(l, engine, const_cast<Value &>(base), value);
 }
 
@@ -1161,7 +1166,12 @@ void Runtime::SetLookupStrict::call(Function *f, const Value &base, int index, c
 {
     ExecutionEngine *engine = f->internalClass->engine;
     QV4::Lookup *l = runtimeLookup(f, index);
-    if (!l->setter(l, engine, const_cast<Value &>(base), value))
+    bool stored;
+    {
+        Profiling::LookupProfiler profiler(engine, f, l);
+        stored = l->setter(l, engine, const_cast<Value &>(base), value);
+    }
+    if (!stored)
         engine->throwTypeError();
 }
 
@@ -1406,8 +1416,14 @@ ReturnedValue Runtime::CallQmlContextPropertyLookup::call(ExecutionEngine *engin
 {
     Scope scope(engine);
     ScopedValue thisObject(scope);
-    Lookup *l = runtimeLookup(engine->currentStackFrame->v4Function, index);
-    Value function = Value::fromReturnedValue(l->qmlContextPropertyGetter(l, engine, thisObject));
+    Function *v4Function = engine->currentStackFrame->v4Function;
+    Lookup *l = runtimeLookup(v4Function, index);
+    ReturnedValue value;
+    {
+        Profiling::LookupProfiler profiler(engine, v4Function, l);
+        value = l->qmlContextPropertyGetter(l, engine, thisObject);
+    }
+    Value function = Value::fromReturnedValue(value);
     if (!function.isFunctionObject()) {
         return throwPropertyIsNotAFunctionTypeError(engine, thisObject,
                                                     engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[l->nameIndex]->toQString());
@@ -1499,9 +1515,15 @@ ReturnedValue Runtime::CallProperty::call(ExecutionEngine *engine, const Value &
 
 ReturnedValue Runtime::CallPropertyLookup::call(ExecutionEngine *engine, const Value &base, uint index, Value *argv, int argc)
 {
-    Lookup *l = runtimeLookup(engine->currentStackFrame->v4Function, index);
+    Function *function = engine->currentStackFrame->v4Function;
+    Lookup *l = runtimeLookup(function, index);
+    ReturnedValue value;
+    {
+        Profiling::LookupProfiler profiler(engine, function, l);
+        value = l->getter(l, engine, base);
+    }
     // ok to have the value on the stack here
-    Value f = Value::fromReturnedValue(l->getter(l, engine, base));
+    Value f = Value::fromReturnedValue(value);
 
     if (!f.isFunctionObject())
         return engine->throwTypeError();
@@ -29,6 +29,7 @@
 
 #if QT_CONFIG(qml_jit)
 #include <private/qv4baselinejit_p.h>
+#include <private/qv4jitcodecache_p.h>
 #endif
 
 #include <qtqml_tracepoints_p.h>
@@ -347,6 +348,65 @@ static inline const QV4::Value &constant(Function *function, int index)
     return function->compilationUnit->constants[index].asValue<QV4::Value>();
 }
 
+// Collects the operand types seen by arithmetic and relational instructions for the optimizing
+// tier of the JIT. code points to the instruction following the one the feedback is for.
+static inline void recordTypeFeedback(Function *function, const char *code, quint8 flags)
+{
+    if (function->typeFeedback)
+        function->typeFeedback[code - function->codeData] |= flags;
+}
+
+#if QT_CONFIG(qml_jit)
+// Installs the code the baseline JIT generated for the function in an earlier run, if the
+// compilation unit has a JIT code cache. The cache is only consulted the first time, so that
+// functions without cached code don't pay for the lookup on every call until they are jitted.
+static bool installCachedCode(ExecutionEngine *engine, Function *function)
+{
+    if (Q_LIKELY(function->lookedUpCachedCode))
+        return false;
+    function->lookedUpCachedCode = true;
+    JIT::JitCodeCache *cache = function->executableCompilationUnit()->jitCodeCache.get();
+    return cache && engine->canJIT() && cache->install(function);
+}
+
+// Compiles the function with the baseline JIT. Only functions that get this far collect type
+// feedback, so that functions that are run only a few times don't pay for it.
+static void generateBaselineCode(ExecutionEngine *engine, Function *function)
+{
+    if (!function->typeFeedback && engine->canCollectTypeFeedback(function))
+        function->typeFeedback.reset(new quint8[function->compiledFunction->codeSize + 1]());
+    QV4::JIT::BaselineJIT(function).generate();
+}
+
+// Returns where to continue a frame that has been running a loop in the interpreter for a while
+// in jitted code, compiling the function if necessary. This is possible as the baseline JIT uses
+// the same stack frame layout as the interpreter.
+static Function::JittedCode loopEntryPoint(JSTypesStackFrame *frame, ExecutionEngine *engine,
+                                           const char *loopHeader)
+{
+    // The interpreter keeps unwind handlers as pointers into the byte code, the JIT as pointers
+    // into the machine code.
+    if (frame->unwindHandler || frame->unwindLabel || engine->debugger())
+        return nullptr;
+
+    Function *function = frame->v4Function;
+    if (function->codeRef == nullptr && !installCachedCode(engine, function))
+        generateBaselineCode(engine, function);
+    return function->loopEntryPoints.value(int(loopHeader - function->codeData));
+}
+
+#define MOTH_BACK_EDGE() do { \
+    if (Q_UNLIKELY(engine->countBackEdge(function))) { \
+        if (Function::JittedCode entry = loopEntryPoint(frame, engine, code)) { \
+            STORE_ACC(); \
+            return entry(frame, engine); \
+        } \
+    } \
+} while (false)
+#else
+#define MOTH_BACK_EDGE() do {} while (false)
+#endif
+
 static bool compareEqualInt(QV4::Value &accumulator, QV4::Value lhs, int rhs)
 {
   redo:
@@ -562,11 +622,16 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
         // Check for codeRef here. In rare cases the JIT compilation may fail, which leaves us
         // with a (useless) codeRef, but no jittedCode. In that case, don't try to JIT again every
         // time we execute the function, but just interpret instead.
-        if (function->codeRef == nullptr) {
+        if (function->codeRef == nullptr && !installCachedCode(engine, function)) {
             if (engine->canJIT(function))
-                QV4::JIT::BaselineJIT(function).generate();
+                generateBaselineCode(engine, function);
             else
                 ++function->interpreterCallCount;
+        } else if (function->typeFeedback && !function->baselineCodeRef
+                   && function->jittedCode != nullptr) {
+            ++function->jittedCallCount;
+            if (engine->canOptimizeJIT(function))
+                QV4::JIT::BaselineJIT(function, QV4::JIT::BaselineJIT::Optimizing).generate();
         }
     }
 #endif // QT_CONFIG(qml_jit)
@@ -703,7 +768,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
     MOTH_BEGIN_INSTR(LoadQmlContextPropertyLookup)
         STORE_IP();
         QV4::Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
-        acc = l->qmlContextPropertyGetter(l, engine, nullptr);
+        {
+            Profiling::LookupProfiler lookupProfiler(engine, function, l);
+            acc = l->qmlContextPropertyGetter(l, engine, nullptr);
+        }
         CHECK_EXCEPTION;
     MOTH_END_INSTR(LoadQmlContextPropertyLookup)
 
@@ -768,7 +836,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             goto handleUnwind;
         }
 
-        acc = l->getter(l, engine, accumulator);
+        {
+            Profiling::LookupProfiler lookupProfiler(engine, function, l);
+            acc = l->getter(l, engine, accumulator);
+        }
         CHECK_EXCEPTION;
     MOTH_END_INSTR(GetLookup)
 
@@ -782,6 +853,7 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             acc = Encode::undefined();
             code += offset;
         } else {
+            Profiling::LookupProfiler lookupProfiler(engine, function, l);
             acc = l->getter(l, engine, accumulator);
         }
     CHECK_EXCEPTION;
@@ -798,7 +870,12 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         STORE_IP();
         STORE_ACC();
         QV4::Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
-        if (!l->setter(l, engine, STACK_VALUE(base), accumulator) && function->isStrict())
+        bool stored;
+        {
+            Profiling::LookupProfiler lookupProfiler(engine, function, l);
+            stored = l->setter(l, engine, STACK_VALUE(base), accumulator);
+        }
+        if (!stored && function->isStrict())
             engine->throwTypeError();
         CHECK_EXCEPTION;
     MOTH_END_INSTR(SetLookup)
@@ -889,7 +966,12 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         }
 
         // ok to have the value on the stack here
-        Value f = Value::fromReturnedValue(l->getter(l, engine, STACK_VALUE(base)));
+        ReturnedValue value;
+        {
+            Profiling::LookupProfiler lookupProfiler(engine, function, l);
+            value = l->getter(l, engine, STACK_VALUE(base));
+        }
+        Value f = Value::fromReturnedValue(value);
 
         if (Q_UNLIKELY(!f.isFunctionObject())) {
             QString message = QStringLiteral("Property '%1' of object %2 is not a function")
@@ -1141,6 +1223,8 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
 
     MOTH_BEGIN_INSTR(Jump)
         code += offset;
+        if (offset < 0)
+            MOTH_BACK_EDGE();
     MOTH_END_INSTR(Jump)
 
     MOTH_BEGIN_INSTR(JumpTrue)
@@ -1149,8 +1233,11 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             takeJump = ACC.int_32();
         else
             takeJump = ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            if (offset < 0)
+                MOTH_BACK_EDGE();
+        }
     MOTH_END_INSTR(JumpTrue)
 
     MOTH_BEGIN_INSTR(JumpFalse)
@@ -1159,8 +1246,11 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
             takeJump = !ACC.int_32();
         else
             takeJump = !ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            if (offset < 0)
+                MOTH_BACK_EDGE();
+        }
     MOTH_END_INSTR(JumpFalse)
 
     MOTH_BEGIN_INSTR(JumpNoException)
@@ -1234,8 +1324,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
             acc = Encode(left.int_32() > ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() > ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Encode(bool(Runtime::CompareGreaterThan::call(left, accumulator)));
             CHECK_EXCEPTION;
@@ -1247,8 +1339,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
             acc = Encode(left.int_32() >= ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() >= ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Encode(bool(Runtime::CompareGreaterEqual::call(left, accumulator)));
             CHECK_EXCEPTION;
@@ -1260,8 +1354,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
             acc = Encode(left.int_32() < ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() < ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Encode(bool(Runtime::CompareLessThan::call(left, accumulator)));
             CHECK_EXCEPTION;
@@ -1273,8 +1369,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
             acc = Encode(left.int_32() <= ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() <= ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Encode(bool(Runtime::CompareLessEqual::call(left, accumulator)));
             CHECK_EXCEPTION;
@@ -1377,8 +1475,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(Value::integerCompatible(left, ACC))) {
             acc = add_int32(left.int_32(), ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() + ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Runtime::Add::call(engine, left, accumulator);
             CHECK_EXCEPTION;
@@ -1390,8 +1490,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(Value::integerCompatible(left, ACC))) {
             acc = sub_int32(left.int_32(), ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() - ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Runtime::Sub::call(left, accumulator);
             CHECK_EXCEPTION;
@@ -1416,8 +1518,10 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         if (Q_LIKELY(Value::integerCompatible(left, ACC))) {
             acc = mul_int32(left.int_32(), ACC.int_32());
         } else if (left.isNumber() && ACC.isNumber()) {
+            recordTypeFeedback(function, code, Function::SawDouble);
             acc = Encode(left.asDouble() * ACC.asDouble());
         } else {
+            recordTypeFeedback(function, code, Function::SawOther);
             STORE_ACC();
             acc = Runtime::Mul::call(left, accumulator);
             CHECK_EXCEPTION;
@@ -1425,6 +1529,7 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
     MOTH_END_INSTR(Mul)
 
     MOTH_BEGIN_INSTR(Div)
+        recordTypeFeedback(function, code, Function::divisionFeedback(STACK_VALUE(lhs), ACC));
         STORE_ACC();
         acc = Runtime::Div::call(STACK_VALUE(lhs), accumulator);
         CHECK_EXCEPTION;
@@ -17,6 +17,11 @@
 #include <QElapsedTimer>
 #include <QMap>
 #include <QScopedValueRollback>
+#if QT_CONFIG(thread)
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#endif
 
 #include <iostream>
 #include <cstdlib>
@@ -263,12 +268,42 @@ static void increaseFreedCountForClass(const char *className)
     (*freedObjectStatsGlobal())[className]++;
 }
 
-//bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
-bool Chunk::sweep(ExecutionEngine *engine)
+// Runs the destructors of all unmarked objects, leaving the bitmaps alone. This has to
+// happen on the engine's thread, as destructors may touch arbitrary engine data.
+void Chunk::destroyUnmarked()
+{
+    HeapItem *o = realBase();
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
+        Q_ASSERT((toFree & objectBitmap[i]) == toFree); // check all black objects are marked as being used
+        while (toFree) {
+            uint index = qCountTrailingZeroBits(toFree);
+            toFree ^= (static_cast<quintptr>(1) << index); // mask out freed slot
+
+            HeapItem *itemToFree = o + index;
+            Heap::Base *b = *itemToFree;
+            const VTable *v = b->internalClass->vtable;
+//            if (Q_UNLIKELY(classCountPtr))
+//                classCountPtr(v->className);
+            if (v->destroy) {
+                v->destroy(b);
+                b->_checkIsDestroyed();
+            }
+#ifdef V4_USE_HEAPTRACK
+            heaptrack_report_free(itemToFree);
+#endif
+        }
+        o += Chunk::Bits;
+    }
+}
+
+// Releases the slots of all unmarked objects and clears the black bits. Only touches the
+// chunk's bitmaps, so it is safe to run on a different thread once destroyUnmarked() is done
+// and as long as nobody allocates from the chunk in the meantime.
+bool Chunk::sweepBitmaps(uint *freedSlots)
 {
     bool hasUsedSlots = false;
     SDUMP() << "sweeping chunk" << this;
-    HeapItem *o = realBase();
     bool lastSlotFree = false;
     for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
         quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
@@ -296,31 +331,17 @@ bool Chunk::sweep(ExecutionEngine *engine)
             Q_ASSERT(qCountTrailingZeroBits(result) - index != 0); // ensure we freed something
             result |= mask; // ensure we don't clear stuff to the right of the current object
             e &= result;
-
-            HeapItem *itemToFree = o + index;
-            Heap::Base *b = *itemToFree;
-            const VTable *v = b->internalClass->vtable;
-//            if (Q_UNLIKELY(classCountPtr))
-//                classCountPtr(v->className);
-            if (v->destroy) {
-                v->destroy(b);
-                b->_checkIsDestroyed();
-            }
-#ifdef V4_USE_HEAPTRACK
-            heaptrack_report_free(itemToFree);
-#endif
         }
-        Q_V4_PROFILE_DEALLOC(engine, qPopulationCount((objectBitmap[i] | extendsBitmap[i])
-                                                      - (blackBitmap[i] | e)) * Chunk::SlotSize,
-                             Profiling::SmallItem);
+        *freedSlots += qPopulationCount(objectBitmap[i] | extendsBitmap[i])
+                - qPopulationCount(blackBitmap[i] | e);
         objectBitmap[i] = blackBitmap[i];
         hasUsedSlots |= (blackBitmap[i] != 0);
         extendsBitmap[i] = e;
+        blackBitmap[i] = 0;
         lastSlotFree = !((objectBitmap[i]|extendsBitmap[i]) >> (sizeof(quintptr)*8 - 1));
         SDUMP() << "        new extends =" << binary(e);
         SDUMP() << "        lastSlotFree" << lastSlotFree;
         Q_ASSERT((objectBitmap[i] & extendsBitmap[i]) == 0);
-        o += Chunk::Bits;
     }
     //    DEBUG << "swept chunk" << this << "freed" << slotsFreed << "slots.";
     return hasUsedSlots;
@@ -451,6 +472,8 @@ HeapItem *BlockAllocator::allocate(size_t size, bool forceAllocation) {
 
     HeapItem *m;
 
+retry:
+
     if (slotsRequired < NumBins - 1) {
         m = freeBins[slotsRequired];
         if (m) {
@@ -519,6 +542,15 @@ HeapItem *BlockAllocator::allocate(size_t size, bool forceAllocation) {
         }
     }
 
+    if (!m && hasPendingSweep()) {
+        // Memory is still waiting to be swept after the last GC, sweep a chunk ourselves
+        uint freedSlots = 0;
+        if (sweepPendingChunk(freeBins, &usedSlotsAfterLastSweep, &freedSlots)) {
+            Q_V4_PROFILE_DEALLOC(engine, freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+            goto retry;
+        }
+    }
+
     if (!m) {
         if (!forceAllocation)
             return nullptr;
@@ -559,8 +591,15 @@ void BlockAllocator::sweep()
 //    qDebug() << "BlockAlloc: sweep";
     usedSlotsAfterLastSweep = 0;
 
+    // Run all destructors before touching any bitmaps. InternalClass::destroy() looks at the
+    // mark bit of its parent, which may live in a chunk that has been swept already.
+    destroyUnmarked();
+
     auto firstEmptyChunk = std::partition(chunks.begin(), chunks.end(), [this](Chunk *c) {
-        return c->sweep(engine);
+        uint freedSlots = 0;
+        const bool hasUsedSlots = c->sweepBitmaps(&freedSlots);
+        Q_V4_PROFILE_DEALLOC(engine, freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+        return hasUsedSlots;
     });
 
     std::for_each(chunks.begin(), firstEmptyChunk, [this](Chunk *c) {
@@ -578,6 +617,102 @@ void BlockAllocator::sweep()
     chunks.erase(firstEmptyChunk, chunks.end());
 }
 
+void BlockAllocator::destroyUnmarked()
+{
+    for (auto c : chunks)
+        c->destroyUnmarked();
+}
+
+// Hands all chunks over for sweeping by sweepPendingChunk(). The destructors have to be run
+// before. Until finishBackgroundSweep() the allocator only gets memory from chunks it has
+// swept itself, or from new ones.
+void BlockAllocator::prepareBackgroundSweep()
+{
+    Q_ASSERT(chunksToSweep.empty());
+    nextFree = nullptr;
+    nFree = 0;
+    memset(freeBins, 0, sizeof(freeBins));
+    memset(backgroundBins, 0, sizeof(backgroundBins));
+    memset(backgroundBinTails, 0, sizeof(backgroundBinTails));
+    usedSlotsAfterLastSweep = 0;
+    backgroundUsedSlots = 0;
+    backgroundFreedSlots = 0;
+
+    chunksToSweep = chunks;
+    sweptChunkIsEmpty.assign(chunksToSweep.size(), false);
+    nextChunkToSweep.store(0, std::memory_order_relaxed);
+}
+
+// Can be called from any thread, each chunk is swept exactly once by whoever claims it first.
+bool BlockAllocator::sweepPendingChunk(HeapItem **bins, size_t *usedSlots, uint *freedSlots)
+{
+    const size_t index = nextChunkToSweep.fetch_add(1, std::memory_order_relaxed);
+    if (index >= chunksToSweep.size())
+        return false;
+
+    Chunk *c = chunksToSweep[index];
+    if (c->sweepBitmaps(freedSlots)) {
+        c->sortIntoBins(bins, NumBins);
+        *usedSlots += c->nUsedSlots();
+    } else {
+        sweptChunkIsEmpty[index] = true;
+    }
+    return true;
+}
+
+void BlockAllocator::sweepPendingChunksInBackground()
+{
+    while (sweepPendingChunk(backgroundBins, &backgroundUsedSlots, &backgroundFreedSlots)) {
+        // sortIntoBins() prepends, so the first item put into a bin stays its tail.
+        for (uint i = 0; i < NumBins; ++i) {
+            if (backgroundBinTails[i] || !backgroundBins[i])
+                continue;
+            HeapItem *tail = backgroundBins[i];
+            while (tail->freeData.next)
+                tail = tail->freeData.next;
+            backgroundBinTails[i] = tail;
+        }
+    }
+}
+
+// Needs to be called on the allocating thread, after the background sweeper has finished.
+void BlockAllocator::finishBackgroundSweep()
+{
+    uint freedSlots = 0;
+    while (sweepPendingChunk(freeBins, &usedSlotsAfterLastSweep, &freedSlots)) {}
+    freedSlots += backgroundFreedSlots;
+    Q_V4_PROFILE_DEALLOC(engine, freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+
+    for (uint i = 0; i < NumBins; ++i) {
+        if (!backgroundBinTails[i])
+            continue;
+        backgroundBinTails[i]->freeData.next = freeBins[i];
+        freeBins[i] = backgroundBins[i];
+    }
+    usedSlotsAfterLastSweep += backgroundUsedSlots;
+
+    std::vector<Chunk *> emptyChunks;
+    for (size_t i = 0, end = chunksToSweep.size(); i < end; ++i) {
+        if (sweptChunkIsEmpty[i])
+            emptyChunks.push_back(chunksToSweep[i]);
+    }
+
+    if (!emptyChunks.empty()) {
+        std::sort(emptyChunks.begin(), emptyChunks.end());
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [&emptyChunks](Chunk *c) {
+            return std::binary_search(emptyChunks.begin(), emptyChunks.end(), c);
+        }), chunks.end());
+
+        for (Chunk *c : emptyChunks) {
+            Q_V4_PROFILE_DEALLOC(engine, Chunk::DataSize, Profiling::HeapPage);
+            chunkAllocator->free(c);
+        }
+    }
+
+    chunksToSweep.clear();
+    sweptChunkIsEmpty.clear();
+}
+
 void BlockAllocator::freeAll()
 {
     for (auto c : chunks)
@@ -671,6 +806,24 @@ void HugeItemAllocator::freeAll()
     }
 }
 
+#if QT_CONFIG(thread)
+struct BackgroundSweeper : QRunnable
+{
+    BackgroundSweeper(MemoryManager *mm) : mm(mm) { setAutoDelete(false); }
+
+    void run() override
+    {
+        mm->blockAllocator.sweepPendingChunksInBackground();
+        mm->icAllocator.sweepPendingChunksInBackground();
+        done.release();
+    }
+
+    MemoryManager *mm;
+    QSemaphore done;
+};
+#else
+struct BackgroundSweeper {};
+#endif
 
 MemoryManager::MemoryManager(ExecutionEngine *engine)
     : engine(engine)
@@ -691,6 +844,9 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     memset(statistics.allocations, 0, sizeof(statistics.allocations));
     if (gcStats)
         blockAllocator.allocationStats = statistics.allocations;
+#if QT_CONFIG(thread)
+    m_backgroundSweeper = std::make_unique<BackgroundSweeper>(this);
+#endif
 }
 
 Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
@@ -848,7 +1004,8 @@ void MemoryManager::mark()
     // dtor of MarkStack drains
 }
 
-void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr)
+void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr,
+                          bool backgroundSweep)
 {
     for (PersistentValueStorage::Iterator it = m_weakValues->begin(); it != m_weakValues->end(); ++it) {
         Managed *m = (*it).managed();
@@ -917,12 +1074,64 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
     }
 
 
-    if (!lastSweep) {
-        engine->identifierTable->sweep();
-        blockAllocator.sweep(/*classCountPtr*/);
+    if (lastSweep)
+        return;
+
+    engine->identifierTable->sweep();
+
+#if QT_CONFIG(thread)
+    if (backgroundSweep) {
+        // Destructors have to run on this thread, and before any memory gets reused. Once they
+        // are done, nothing looks at the unmarked slots anymore, and updating the bitmaps and
+        // rebuilding the free lists can happen on a worker thread. The allocator sweeps
+        // chunks itself if it runs out of memory before the worker gets to them.
+        blockAllocator.destroyUnmarked();
         hugeItemAllocator.sweep(classCountPtr);
-        icAllocator.sweep(/*classCountPtr*/);
+        icAllocator.destroyUnmarked();
+
+        blockAllocator.prepareBackgroundSweep();
+        icAllocator.prepareBackgroundSweep();
+        m_backgroundSweepRunning = true;
+        ++statistics.backgroundSweeps;
+        QThreadPool::globalInstance()->start(m_backgroundSweeper.get());
+        return;
     }
+#else
+    Q_UNUSED(backgroundSweep);
+#endif
+
+    blockAllocator.sweep(/*classCountPtr*/);
+    hugeItemAllocator.sweep(classCountPtr);
+    icAllocator.sweep(/*classCountPtr*/);
+}
+
+bool MemoryManager::canSweepInBackground() const
+{
+    // The statistics, the profiler and the consistency checks need the heap to be swept
+    // right away.
+    return m_backgroundSweeper && !aggressiveGC && !gcStats && !gcCollectorStats && !engine->profiler()
+            && blockAllocator.chunks.size() + icAllocator.chunks.size() >= MinChunksForBackgroundSweep;
+}
+
+void MemoryManager::finishBackgroundSweep()
+{
+    if (!m_backgroundSweepRunning)
+        return;
+
+    QElapsedTimer t;
+    t.start();
+
+#if QT_CONFIG(thread)
+    // If the worker hasn't been started yet, we sweep the remaining chunks ourselves.
+    if (!QThreadPool::globalInstance()->tryTake(m_backgroundSweeper.get()))
+        m_backgroundSweeper->done.acquire();
+#endif
+
+    blockAllocator.finishBackgroundSweep();
+    icAllocator.finishBackgroundSweep();
+    statistics.totalSweepTime += t.nsecsElapsed();
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    m_backgroundSweepRunning = false;
 }
 
 bool MemoryManager::shouldRunGC() const
@@ -962,24 +1171,70 @@ static size_t dumpBins(BlockAllocator *b, const char *title)
     return totalSlotMem*Chunk::SlotSize;
 }
 
+namespace {
+// Measures a pause of the engine thread caused by the collector, and reports it to the
+// statistics and the profiler.
+struct GCPause
+{
+    GCPause(MemoryManager *mm)
+        : mm(mm), profilerIndex(Q_V4_PROFILE_GC_START(mm->engine))
+    {
+        timer.start();
+    }
+
+    ~GCPause()
+    {
+        Q_V4_PROFILE_GC_END(mm->engine, profilerIndex);
+
+        const qint64 duration = timer.nsecsElapsed();
+        mm->statistics.longestPause = qMax(mm->statistics.longestPause, duration);
+
+        // Bucket 0 holds pauses below 100us, each further bucket doubles the range.
+        const quint64 units = quint64(duration) / (100 * 1000);
+        const int bucket = units ? qMin(int(MemoryManager::PauseHistogramBuckets) - 1,
+                                        64 - int(qCountLeadingZeroBits(units)))
+                                 : 0;
+        ++mm->statistics.pauseHistogram[bucket];
+    }
+
+    MemoryManager *mm;
+    QElapsedTimer timer;
+    int profilerIndex;
+};
+}
+
 void MemoryManager::runGC()
+{
+    collectGarbage(false);
+}
+
+void MemoryManager::collectGarbage(bool backgroundSweep)
 {
     if (gcBlocked) {
 //        qDebug() << "Not running GC.";
         return;
     }
 
+    finishBackgroundSweep();
+
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
 
+    GCPause pause(this);
+
     if (gcStats) {
         statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
         statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
     }
 
     if (!gcCollectorStats) {
+        QElapsedTimer t;
+        t.start();
         mark();
-        sweep();
+        statistics.totalMarkTime += t.nsecsElapsed();
+        t.restart();
+        sweep(false, nullptr, backgroundSweep);
+        statistics.totalSweepTime += t.nsecsElapsed();
     } else {
         bool triggeredByUnmanagedHeap = (unmanagedHeapSize > unmanagedHeapSizeGCLimit);
         size_t oldUnmanagedSize = unmanagedHeapSize;
@@ -1004,9 +1259,11 @@ void MemoryManager::runGC()
         QElapsedTimer t;
         t.start();
         mark();
+        statistics.totalMarkTime += t.nsecsElapsed();
         qint64 markTime = t.nsecsElapsed()/1000;
         t.restart();
         sweep(false, increaseFreedCountForClass);
+        statistics.totalSweepTime += t.nsecsElapsed();
         const size_t usedAfter = getUsedMem();
         const size_t largeItemsAfter = getLargeItemsMem();
         qint64 sweepTime = t.nsecsElapsed()/1000;
@@ -1068,12 +1325,22 @@ void MemoryManager::runGC()
                  == icAllocator.usedMem() + dumpBins(&icAllocator, nullptr));
     }
 
-    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    if (!m_backgroundSweepRunning)
+        usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+
+    resetBlackBits();
+
+    ++statistics.fullGCs;
+}
 
-    // reset all black bits
-    blockAllocator.resetBlackBits();
+void MemoryManager::resetBlackBits()
+{
+    // A background sweep clears the black bits of the chunks it sweeps.
+    if (!m_backgroundSweepRunning) {
+        blockAllocator.resetBlackBits();
+        icAllocator.resetBlackBits();
+    }
     hugeItemAllocator.resetBlackBits();
-    icAllocator.resetBlackBits();
 }
 
 size_t MemoryManager::getUsedMem() const
@@ -1105,6 +1372,8 @@ void MemoryManager::registerWeakSet(Heap::SetObject *set)
 
 MemoryManager::~MemoryManager()
 {
+    finishBackgroundSweep();
+
     delete m_persistentValues;
 
     dumpStats();
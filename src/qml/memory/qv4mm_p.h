@@ -22,6 +22,9 @@
 #include <private/qv4mmdefs_p.h>
 #include <QVector>
 
+#include <atomic>
+#include <memory>
+
 #define MM_DEBUG 0
 
 QT_BEGIN_NAMESPACE
@@ -30,12 +33,15 @@ namespace QV4 {
 
 struct ChunkAllocator;
 struct MemorySegment;
+struct BackgroundSweeper;
 
 struct BlockAllocator {
     BlockAllocator(ChunkAllocator *chunkAllocator, ExecutionEngine *engine)
         : chunkAllocator(chunkAllocator), engine(engine)
     {
         memset(freeBins, 0, sizeof(freeBins));
+        memset(backgroundBins, 0, sizeof(backgroundBins));
+        memset(backgroundBinTails, 0, sizeof(backgroundBinTails));
     }
 
     enum { NumBins = 8 };
@@ -64,6 +70,13 @@ struct BlockAllocator {
     void freeAll();
     void resetBlackBits();
 
+    void destroyUnmarked();
+    void prepareBackgroundSweep();
+    bool sweepPendingChunk(HeapItem **bins, size_t *usedSlots, uint *freedSlots);
+    void sweepPendingChunksInBackground();
+    void finishBackgroundSweep();
+    bool hasPendingSweep() const { return !chunksToSweep.empty(); }
+
     // bump allocations
     HeapItem *nextFree = nullptr;
     size_t nFree = 0;
@@ -73,6 +86,17 @@ struct BlockAllocator {
     ExecutionEngine *engine;
     std::vector<Chunk *> chunks;
     uint *allocationStats = nullptr;
+
+    // Chunks that still need their bitmaps swept after a GC. They are claimed one at a time by
+    // either the background sweeper or the allocating thread, see MemoryManager::sweep().
+    std::vector<Chunk *> chunksToSweep;
+    std::vector<char> sweptChunkIsEmpty;
+    std::atomic<size_t> nextChunkToSweep{0};
+    // Free lists built by the background sweeper, merged into freeBins once it is done.
+    HeapItem *backgroundBins[NumBins];
+    HeapItem *backgroundBinTails[NumBins];
+    size_t backgroundUsedSlots = 0;
+    uint backgroundFreedSlots = 0;
 };
 
 struct HugeItemAllocator {
@@ -215,8 +239,17 @@ public:
 
     void runGC();
 
+    enum { PauseHistogramBuckets = 16 };
+
     void dumpStats() const;
 
+    // Whether a collection triggered by allocation would leave sweeping the chunks to a
+    // worker thread.
+    bool canSweepInBackground() const;
+    // Waits for the worker thread to finish sweeping, if a sweep is pending. The chunks can't
+    // be inspected before.
+    void finishBackgroundSweep();
+
     size_t getUsedMem() const;
     size_t getAllocatedMem() const;
     size_t getLargeItemsMem() const;
@@ -243,14 +276,19 @@ protected:
 
 private:
     enum {
-        MinUnmanagedHeapSizeGCLimit = 128 * 1024
+        MinUnmanagedHeapSizeGCLimit = 128 * 1024,
+        MinChunksForBackgroundSweep = 8
     };
 
     void collectFromJSStack(MarkStack *markStack) const;
     void mark();
-    void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
+    void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr,
+               bool backgroundSweep = false);
     bool shouldRunGC() const;
     void collectRoots(MarkStack *markStack);
+    void resetBlackBits();
+
+    void collectGarbage(bool backgroundSweep);
 
     HeapItem *allocate(BlockAllocator *allocator, std::size_t size)
     {
@@ -262,7 +300,7 @@ private:
 
         if (unmanagedHeapSize > unmanagedHeapSizeGCLimit) {
             if (!didGCRun)
-                runGC();
+                collectGarbage(canSweepInBackground());
 
             if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
                 // more than 75% full, raise limit
@@ -276,14 +314,25 @@ private:
             didGCRun = true;
         }
 
-        if (size > Chunk::DataSize)
+        if (size > Chunk::DataSize) {
+            ++statistics.hugeItemAllocations;
             return hugeItemAllocator.allocate(size);
+        }
+
+        statistics.allocatedBytes[BlockAllocator::binForSlots(size >> Chunk::SlotSizeShift)] += size;
 
         if (HeapItem *m = allocator->allocate(size))
             return m;
 
+        if (m_backgroundSweepRunning) {
+            // Wait for the memory freed by the last GC before considering another one
+            finishBackgroundSweep();
+            if (HeapItem *m = allocator->allocate(size))
+                return m;
+        }
+
         if (!didGCRun && shouldRunGC())
-            runGC();
+            collectGarbage(canSweepInBackground());
 
         return allocator->allocate(size, true);
     }
@@ -309,6 +358,9 @@ public:
     bool gcStats = false;
     bool gcCollectorStats = false;
 
+    std::unique_ptr<BackgroundSweeper> m_backgroundSweeper;
+    bool m_backgroundSweepRunning = false;
+
     int allocationCount = 0;
     size_t lastAllocRequestedSlots = 0;
 
@@ -317,6 +369,16 @@ public:
         size_t maxAllocatedMem = 0;
         size_t maxUsedMem = 0;
         uint allocations[BlockAllocator::NumBins];
+        uint fullGCs = 0;
+        uint backgroundSweeps = 0;
+
+        // Always collected, see QJSEngine::garbageCollectionStatistics()
+        qint64 totalMarkTime = 0; // in ns
+        qint64 totalSweepTime = 0; // in ns
+        qint64 longestPause = 0; // in ns
+        quint64 pauseHistogram[PauseHistogramBuckets] = {};
+        quint64 allocatedBytes[BlockAllocator::NumBins] = {};
+        quint64 hugeItemAllocations = 0;
     } statistics;
 };
 
@@ -151,7 +151,8 @@ struct Chunk {
 
     bool sweep(ClassDestroyStatsCallback classCountPtr);
     void resetBlackBits();
-    bool sweep(ExecutionEngine *engine);
+    void destroyUnmarked();
+    bool sweepBitmaps(uint *freedSlots);
     void freeAll(ExecutionEngine *engine);
 
     void sortIntoBins(HeapItem **bins, uint nBins);
@@ -64,7 +64,7 @@ Create a new QQmlDataBlob for \a url and of the provided \a type.
 */
 QQmlDataBlob::QQmlDataBlob(const QUrl &url, Type type, QQmlTypeLoader *manager)
 : m_typeLoader(manager), m_type(type), m_url(url), m_finalUrl(url), m_redirectCount(0),
-  m_inCallback(false), m_isDone(false)
+  m_inCallback(false), m_isDone(false), m_isParsing(false)
 {
     //Set here because we need to get the engine from the manager
     if (const QQmlEngine *qmlEngine = m_typeLoader->engine())
@@ -352,6 +352,55 @@ void QQmlDataBlob::done()
 {
 }
 
+/*!
+Calls parse() and then sourceParsed().
+
+If the type loader has worker threads for parsing, parse() is run on one of them
+and this returns right away. The blob then stays in the Loading state, the same as
+while waiting for a network reply, until sourceParsed() is invoked in the load
+thread. Other blobs are processed in the meantime.
+
+May only be called from within dataReceived().
+*/
+void QQmlDataBlob::parseSource()
+{
+    ASSERT_CALLBACK();
+
+    // Computed lazily, make sure parse() does not race with this thread doing so.
+    urlString();
+    finalUrlString();
+
+    if (m_typeLoader->m_thread->parseConcurrently(this))
+        return;
+
+    parse();
+    sourceParsed();
+}
+
+/*!
+Invoked by parseSource() to turn the source code into whatever representation the
+blob is processed in further.
+
+This may run on a worker thread, concurrently with callbacks of other blobs. It
+must only access the blob's own data and must neither call setError() nor
+addDependency(). Errors have to be stored and reported from sourceParsed().
+
+The default implementation does nothing.
+*/
+void QQmlDataBlob::parse()
+{
+}
+
+/*!
+Invoked in the load thread once parse() has finished. Like within dataReceived(),
+you may call setError() or addDependency() here.
+
+The default implementation does nothing.
+*/
+void QQmlDataBlob::sourceParsed()
+{
+}
+
 #if QT_CONFIG(qml_network)
 /*!
 Invoked if there is a network error while fetching this blob.
@@ -119,6 +119,11 @@ protected:
     virtual void dependencyComplete(QQmlDataBlob *);
     virtual void allDependenciesDone();
 
+    // Parsing started by parseSource(), may run on a worker thread
+    void parseSource();
+    virtual void parse();
+    virtual void sourceParsed();
+
     // Callbacks made in main thread
     virtual void downloadProgressChanged(qreal);
     virtual void completed();
@@ -222,9 +227,10 @@ private:
     // List of QQmlDataBlob's that I am waiting for to complete.
     QVector<QQmlRefPointer<QQmlDataBlob>> m_waitingFor;
 
-    int m_redirectCount:30;
+    int m_redirectCount:29;
     bool m_inCallback:1;
     bool m_isDone:1;
+    bool m_isParsing:1;
 };
 
 QT_END_NAMESPACE
@@ -166,6 +166,7 @@ public:
     };
     QIntrusiveList<Incubator, &Incubator::next> incubatorList;
     unsigned int incubatorCount = 0;
+    quint64 incubatedObjectCount = 0; // ever created by incubators, for statistics
     QQmlIncubationController *incubationController = nullptr;
     void incubate(QQmlIncubator &, const QQmlRefPointer<QQmlContextData> &);
 
@@ -277,7 +277,12 @@ void QQmlIncubatorPrivate::incubate(QQmlInstantiationInterrupt &i)
     if (progress == QQmlIncubatorPrivate::Execute) {
         enginePriv->referenceScarceResources();
         QObject *tresult = nullptr;
+        // Count the objects as they are created, so that the statistics
+        // attribute them to the time slice that created them, even if the
+        // incubation is completed in a later one.
+        const int createdObjectCount = creator->allCreatedObjects().count();
         tresult = creator->create(subComponentToCreate, /*parent*/nullptr, &i);
+        enginePriv->incubatedObjectCount += creator->allCreatedObjects().count() - createdObjectCount;
         if (!tresult)
             errors = creator->errors;
         else {
@@ -411,11 +416,24 @@ void QQmlIncubatorPrivate::incubateCppBasedComponent(QQmlComponent *component, Q
 Incubate objects for \a msecs, or until there are no more objects to incubate.
 */
 void QQmlIncubationController::incubateFor(int msecs)
+{
+    incubateUntil(QDeadlineTimer(msecs));
+}
+
+/*!
+\since 6.6
+
+Incubate objects until \a deadline expires, or until there are no more objects
+to incubate.
+
+Unlike incubateFor(), this allows to hand out time slices at a finer
+granularity than milliseconds, for example the time left until the next frame.
+*/
+void QQmlIncubationController::incubateUntil(QDeadlineTimer deadline)
 {
     if (!d || !d->incubatorCount)
         return;
 
-    QDeadlineTimer deadline(msecs);
     QQmlInstantiationInterrupt i(deadline);
     do {
         static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
@@ -6,6 +6,7 @@
 
 #include <QtQml/qtqmlglobal.h>
 #include <QtQml/qqmlerror.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <atomic>
 
 QT_BEGIN_NAMESPACE
@@ -76,6 +77,7 @@ public:
     int incubatingObjectCount() const;
 
     void incubateFor(int msecs);
+    void incubateUntil(QDeadlineTimer deadline);
     void incubateWhile(std::atomic<bool> *flag, int msecs = 0);
 
 protected:
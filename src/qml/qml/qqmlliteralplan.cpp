@@ -0,0 +1,269 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlliteralplan_p.h"
+
+#include <private/qqmlglobal_p.h>
+#include <private/qqmlproperty_p.h>
+#include <private/qqmlpropertydata_p.h>
+#include <private/qqmlstringconverters_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4resolvedtypereference_p.h>
+
+#include <QtCore/qurl.h>
+
+#if QT_CONFIG(thread)
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#endif
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+// Few enough literals are converted faster than a worker thread is woken up.
+static const int conversionsPerChunk = 32;
+
+static std::atomic<bool> &enabledFlag()
+{
+    static std::atomic<bool> enabled = qEnvironmentVariableIntValue("QML_PLAN_LITERALS") > 0;
+    return enabled;
+}
+
+namespace {
+
+struct LiteralConversion
+{
+    QQmlLiteralPlan *plan;
+    const QV4::CompiledData::Binding *binding;
+    QMetaType type;
+    QString string;
+    QUrl baseUrl; // empty if URLs are not resolved on assignment
+    QVariant value;
+};
+
+struct ConversionBatch
+{
+    std::vector<LiteralConversion> conversions;
+    int chunkCount = 0;
+    QAtomicInt nextChunk;
+#if QT_CONFIG(thread)
+    QSemaphore doneChunks;
+#endif
+};
+
+}
+
+/*
+    Returns whether setPropertyValue() converts literals of \a type from a
+    string in a way that does not depend on the object or the engine, and is
+    worth doing ahead of time.
+ */
+static bool isPlannable(QMetaType type)
+{
+    switch (type.id()) {
+    case QMetaType::QUrl:
+    case QMetaType::QColor:
+#if QT_CONFIG(datestring)
+    case QMetaType::QDate:
+    case QMetaType::QTime:
+    case QMetaType::QDateTime:
+#endif
+    case QMetaType::QPoint:
+    case QMetaType::QPointF:
+    case QMetaType::QSize:
+    case QMetaType::QSizeF:
+    case QMetaType::QRect:
+    case QMetaType::QRectF:
+    case QMetaType::QVector2D:
+    case QMetaType::QVector3D:
+    case QMetaType::QVector4D:
+    case QMetaType::QQuaternion:
+        return true;
+    default:
+        return type == QMetaType::fromType<QList<QUrl>>();
+    }
+}
+
+template<typename T>
+static QVariant ifOk(const T &value, bool ok)
+{
+    return ok ? QVariant::fromValue(value) : QVariant();
+}
+
+/*
+    Converts \a string the way QQmlObjectCreator::setPropertyValue() does for a
+    property of \a type. Returns an invalid QVariant if the conversion fails, in
+    which case setPropertyValue() reports the error as usual. Runs on any
+    thread.
+ */
+static QVariant convertLiteral(QMetaType type, const QString &string, const QUrl &baseUrl)
+{
+    bool ok = false;
+    switch (type.id()) {
+    case QMetaType::QUrl:
+        return QVariant::fromValue((!string.isEmpty() && !baseUrl.isEmpty())
+                                   ? baseUrl.resolved(QUrl(string))
+                                   : QUrl(string));
+    case QMetaType::QColor:
+    case QMetaType::QVector2D:
+    case QMetaType::QVector3D:
+    case QMetaType::QVector4D:
+    case QMetaType::QQuaternion:
+        return QQmlValueTypeProvider::createValueType(string, type);
+#if QT_CONFIG(datestring)
+    case QMetaType::QDate:
+        return ifOk(QQmlStringConverters::dateFromString(string, &ok), ok);
+    case QMetaType::QTime:
+        return ifOk(QQmlStringConverters::timeFromString(string, &ok), ok);
+    case QMetaType::QDateTime:
+        return ifOk(QQmlStringConverters::dateTimeFromString(string, &ok), ok);
+#endif
+    case QMetaType::QPoint:
+        return ifOk(QQmlStringConverters::pointFFromString(string, &ok).toPoint(), ok);
+    case QMetaType::QPointF:
+        return ifOk(QQmlStringConverters::pointFFromString(string, &ok), ok);
+    case QMetaType::QSize:
+        return ifOk(QQmlStringConverters::sizeFFromString(string, &ok).toSize(), ok);
+    case QMetaType::QSizeF:
+        return ifOk(QQmlStringConverters::sizeFFromString(string, &ok), ok);
+    case QMetaType::QRect:
+        return ifOk(QQmlStringConverters::rectFFromString(string, &ok).toRect(), ok);
+    case QMetaType::QRectF:
+        return ifOk(QQmlStringConverters::rectFFromString(string, &ok), ok);
+    default:
+        break;
+    }
+
+    if (type == QMetaType::fromType<QList<QUrl>>()) {
+        const QUrl url(string);
+        return QVariant::fromValue(QList<QUrl> { baseUrl.isEmpty() ? url : baseUrl.resolved(url) });
+    }
+
+    return QVariant();
+}
+
+static void convertChunks(ConversionBatch *batch)
+{
+    for (int chunk = batch->nextChunk.fetchAndAddRelaxed(1); chunk < batch->chunkCount;
+         chunk = batch->nextChunk.fetchAndAddRelaxed(1)) {
+        const qsizetype begin = qsizetype(chunk) * conversionsPerChunk;
+        const qsizetype end = qMin(begin + conversionsPerChunk, qsizetype(batch->conversions.size()));
+        for (qsizetype i = begin; i < end; ++i) {
+            LiteralConversion &conversion = batch->conversions[i];
+            conversion.value = convertLiteral(conversion.type, conversion.string, conversion.baseUrl);
+        }
+#if QT_CONFIG(thread)
+        batch->doneChunks.release();
+#endif
+    }
+}
+
+static void collectConversions(QV4::ExecutableCompilationUnit *unit,
+                               std::vector<LiteralConversion> *conversions)
+{
+    using namespace QV4::CompiledData;
+
+    const int objectCount = unit->objectCount();
+    if (unit->bindingPropertyDataPerObject.size() != objectCount)
+        return;
+
+    // finalUrl() is computed lazily, so it has to be done here rather than by
+    // the workers.
+    const QUrl baseUrl = QQmlPropertyPrivate::resolveUrlsOnAssignment() ? unit->finalUrl() : QUrl();
+    for (int i = 0; i < objectCount; ++i) {
+        const Object *object = unit->objectAt(i);
+        const QV4::BindingPropertyData &propertyData = unit->bindingPropertyDataPerObject.at(i);
+        const Binding *binding = object->bindingTable();
+        for (quint32 j = 0; j < object->nBindings; ++j, ++binding) {
+            if (binding->type() != Binding::Type_String || j >= quint32(propertyData.size()))
+                continue;
+            const QQmlPropertyData *property = propertyData.at(j);
+            if (!property || property->isEnum() || property->isQObject()
+                    || !isPlannable(property->propType())) {
+                continue;
+            }
+            conversions->push_back({ unit->literalPlan.get(), binding, property->propType(),
+                                      unit->bindingValueAsString(binding), baseUrl, QVariant() });
+        }
+    }
+}
+
+/*
+    QQmlLiteralPlan holds the values of the string literals in a compilation
+    unit that are assigned to properties of types such as color, url, point or
+    rect, converted once for all instances of the unit. Without it,
+    QQmlObjectCreator::setPropertyValue() parses the same strings again for
+    every object it creates.
+
+    The plan is experimental and enabled with the QML_PLAN_LITERALS environment
+    variable. It is prepared when a component is first created, for its own
+    compilation unit and those of all the types it uses, so that a page made of
+    many different types can convert all their literals in one go. The
+    conversions only depend on the strings and the property types, so they are
+    spread over the threads of the global thread pool. Creating the objects,
+    and writing and binding their properties, still happens on the thread that
+    creates the component.
+ */
+bool QQmlLiteralPlan::isEnabled()
+{
+    return enabledFlag().load(std::memory_order_relaxed);
+}
+
+void QQmlLiteralPlan::setEnabled(bool enabled)
+{
+    enabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+/*
+    Prepares the plans of \a unit and of the compilation units of all types it
+    uses, recursively, unless they have one already.
+ */
+void QQmlLiteralPlan::prepare(QV4::ExecutableCompilationUnit *unit)
+{
+    if (!unit || unit->literalPlan)
+        return;
+
+    auto batch = std::make_shared<ConversionBatch>();
+    QList<QV4::ExecutableCompilationUnit *> pending { unit };
+    while (!pending.isEmpty()) {
+        QV4::ExecutableCompilationUnit *current = pending.takeLast();
+        if (current->literalPlan)
+            continue;
+        current->literalPlan = std::make_unique<QQmlLiteralPlan>();
+        collectConversions(current, &batch->conversions);
+
+        for (QV4::ResolvedTypeReference *type : std::as_const(current->resolvedTypes)) {
+            if (QV4::ExecutableCompilationUnit *typeUnit = type->compilationUnit().data())
+                pending.append(typeUnit);
+        }
+    }
+
+    if (batch->conversions.empty())
+        return;
+
+    batch->chunkCount = int((batch->conversions.size() + conversionsPerChunk - 1)
+                            / conversionsPerChunk);
+
+#if QT_CONFIG(thread)
+    // This thread converts chunks, too, so that it does not depend on the pool
+    // having idle threads. Workers that start late find nothing left to do.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int workerCount = qMin(batch->chunkCount, pool->maxThreadCount()) - 1;
+    for (int i = 0; i < workerCount; ++i)
+        pool->start([batch]() { convertChunks(batch.get()); });
+    convertChunks(batch.get());
+    batch->doneChunks.acquire(batch->chunkCount);
+#else
+    convertChunks(batch.get());
+#endif
+
+    for (LiteralConversion &conversion : batch->conversions) {
+        if (conversion.value.isValid())
+            conversion.plan->m_values.insert(conversion.binding, std::move(conversion.value));
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,57 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLLITERALPLAN_P_H
+#define QQMLLITERALPLAN_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQml/qtqmlglobal.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qvariant.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+class ExecutableCompilationUnit;
+namespace CompiledData { struct Binding; }
+}
+
+class Q_QML_PRIVATE_EXPORT QQmlLiteralPlan
+{
+    Q_DISABLE_COPY_MOVE(QQmlLiteralPlan)
+public:
+    QQmlLiteralPlan() = default;
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    static void prepare(QV4::ExecutableCompilationUnit *unit);
+
+    // Returns the converted value of the literal \a binding if it was planned
+    // for a property of \a type, or nullptr if it has to be converted as usual.
+    const QVariant *value(const QV4::CompiledData::Binding *binding, QMetaType type) const
+    {
+        const auto it = m_values.constFind(binding);
+        return (it != m_values.constEnd() && it->metaType() == type) ? &*it : nullptr;
+    }
+
+    qsizetype count() const { return m_values.size(); }
+
+private:
+    QHash<const QV4::CompiledData::Binding *, QVariant> m_values;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLLITERALPLAN_P_H
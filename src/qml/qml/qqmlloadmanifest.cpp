@@ -0,0 +1,270 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlloadmanifest_p.h"
+
+#include <private/qqmltypeloader_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+#if QT_CONFIG(qml_jit)
+#include <private/qv4jitcodecache_p.h>
+#endif
+
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qurl.h>
+
+#if QT_CONFIG(thread)
+#include <QtCore/qthreadpool.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+static const char manifestHeader[] = "qmlmanifest 1";
+
+// The prefetch is bound by the storage rather than the CPU, but most storage
+// serves a few requests in parallel faster than one after the other.
+static const int prefetchThreadCount = 4;
+
+static const char *kindName(QQmlLoadManifest::Kind kind)
+{
+    switch (kind) {
+    case QQmlLoadManifest::Source:
+        return "source";
+    case QQmlLoadManifest::Qmldir:
+        return "qmldir";
+    case QQmlLoadManifest::Plugin:
+        return "plugin";
+    }
+    Q_UNREACHABLE_RETURN("");
+}
+
+static bool kindFromName(QByteArrayView name, QQmlLoadManifest::Kind *kind)
+{
+    for (QQmlLoadManifest::Kind candidate :
+         { QQmlLoadManifest::Source, QQmlLoadManifest::Qmldir, QQmlLoadManifest::Plugin }) {
+        if (name == kindName(candidate)) {
+            *kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    Brings the contents of \a filePath into the page cache, so that opening,
+    mapping or reading it later does not have to wait for the storage. Returns
+    false if the file cannot be opened.
+ */
+static bool prefetchFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    const qint64 size = file.size();
+    if (size <= 0)
+        return true;
+
+    if (uchar *data = file.map(0, size)) {
+        // Touching one byte per page faults the whole file in.
+        const qint64 pageSize = 4096;
+        uchar sum = 0;
+        for (qint64 offset = 0; offset < size; offset += pageSize)
+            sum ^= static_cast<volatile uchar *>(data)[offset];
+        Q_UNUSED(sum);
+        file.unmap(data);
+        return true;
+    }
+
+    char buffer[64 * 1024];
+    while (file.read(buffer, sizeof buffer) > 0) {}
+    return true;
+}
+
+/*
+    QQmlLoadManifest remembers which files an engine loaded while it was
+    running, in the order they were first needed, so that the next run of the
+    application can start reading all of them in parallel right away. Without
+    it, each import and type is only discovered once the file using it has been
+    parsed, and every file has to wait for the storage in turn.
+
+    The manifest is a text file with a header line and one "<kind> <path>" line
+    per file. It is enabled with the QML_LOAD_MANIFEST environment variable,
+    which names the file. The file is read when the type loader is created and
+    replaced with what was recorded when the type loader is destroyed.
+
+    Prefetching only warms the page cache, including the compilation unit cache
+    files of the sources, and parses the qmldir files into the type loader's
+    cache. It does not load anything on the engine's behalf, so a stale manifest
+    only costs some wasted reads.
+ */
+std::unique_ptr<QQmlLoadManifest> QQmlLoadManifest::create()
+{
+    const QString fileName = qEnvironmentVariable("QML_LOAD_MANIFEST");
+    if (fileName.isEmpty())
+        return nullptr;
+
+    auto manifest = std::make_unique<QQmlLoadManifest>(fileName);
+    manifest->load();
+    return manifest;
+}
+
+QQmlLoadManifest::QQmlLoadManifest(const QString &fileName)
+    : m_fileName(fileName)
+{
+}
+
+QQmlLoadManifest::~QQmlLoadManifest()
+{
+    waitForPrefetch();
+}
+
+QList<QQmlLoadManifest::Entry> QQmlLoadManifest::recordedEntries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recorded;
+}
+
+/*
+    Reads the entries of the manifest file. Returns false, and leaves no
+    entries, if the file does not exist or is not a manifest. Unknown lines are
+    skipped, so that newer kinds of entries do not invalidate the whole file.
+ */
+bool QQmlLoadManifest::load()
+{
+    m_loaded.clear();
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return false;
+
+    if (file.readLine().trimmed() != manifestHeader)
+        return false;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        const qsizetype space = line.indexOf(' ');
+        if (space <= 0)
+            continue;
+
+        Entry entry;
+        if (!kindFromName(QByteArrayView(line).first(space), &entry.kind))
+            continue;
+        entry.filePath = QString::fromUtf8(line.mid(space + 1));
+        if (!entry.filePath.isEmpty())
+            m_loaded.append(std::move(entry));
+    }
+    return true;
+}
+
+/*
+    Replaces the manifest file with the entries recorded in this run. The file
+    is left alone if nothing was recorded, which happens if the application
+    never loaded a file from the file system, or if the recorded entries are
+    the same as the loaded ones.
+ */
+bool QQmlLoadManifest::save()
+{
+    const QList<Entry> recorded = recordedEntries();
+    if (recorded.isEmpty() || recorded == m_loaded)
+        return true;
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Text))
+        return false;
+
+    file.write(manifestHeader);
+    file.write("\n");
+    for (const Entry &entry : recorded) {
+        file.write(kindName(entry.kind));
+        file.write(" ");
+        file.write(entry.filePath.toUtf8());
+        file.write("\n");
+    }
+    if (!file.commit())
+        return false;
+
+    m_loaded = recorded;
+    return true;
+}
+
+/*
+    Starts prefetching the loaded entries in the background, in the order they
+    were recorded, so that the files needed first are likely to be ready first.
+ */
+void QQmlLoadManifest::prefetch(QQmlTypeLoader *loader)
+{
+#if QT_CONFIG(thread)
+    if (m_loaded.isEmpty() || m_prefetchPool)
+        return;
+
+    m_prefetchPool = std::make_unique<QThreadPool>();
+    m_prefetchPool->setObjectName(QStringLiteral("QQmlTypeLoader prefetch"));
+    m_prefetchPool->setMaxThreadCount(prefetchThreadCount);
+    for (const Entry &entry : std::as_const(m_loaded))
+        m_prefetchPool->start([this, loader, entry]() { prefetchEntry(loader, entry); });
+#else
+    Q_UNUSED(loader);
+#endif
+}
+
+void QQmlLoadManifest::waitForPrefetch()
+{
+#if QT_CONFIG(thread)
+    if (!m_prefetchPool)
+        return;
+
+    m_prefetchPool->clear();
+    m_prefetchPool->waitForDone();
+#endif
+}
+
+void QQmlLoadManifest::prefetchEntry(QQmlTypeLoader *loader, const Entry &entry)
+{
+    switch (entry.kind) {
+    case Source: {
+        if (!prefetchFile(entry.filePath))
+            return;
+        // Whichever of the cache files exists is mapped instead of compiling
+        // the source.
+        prefetchFile(entry.filePath + QLatin1Char('c'));
+        const QString cachePath = QV4::ExecutableCompilationUnit::localCacheFilePath(
+                    QUrl::fromLocalFile(entry.filePath));
+        if (prefetchFile(cachePath)) {
+#if QT_CONFIG(qml_jit)
+            prefetchFile(QV4::JIT::JitCodeCache::filePath(cachePath));
+#endif
+        }
+        break;
+    }
+    case Qmldir:
+        if (prefetchFile(entry.filePath))
+            loader->prefetchQmldirContent(entry.filePath);
+        break;
+    case Plugin:
+        // Loading the plugin runs its static initializers, which is not ours
+        // to do ahead of time. Its pages being cached already speeds up the
+        // dynamic linker, though.
+        prefetchFile(entry.filePath);
+        break;
+    }
+}
+
+/*
+    Records that the file at \a filePath was loaded as \a kind, unless it has
+    been recorded before. Files in resources are not recorded, as they are part
+    of the application binary already.
+ */
+void QQmlLoadManifest::record(Kind kind, const QString &filePath)
+{
+    if (filePath.isEmpty() || filePath.startsWith(QLatin1Char(':')))
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_recordedPaths[kind].contains(filePath))
+        return;
+    m_recordedPaths[kind].insert(filePath);
+    m_recorded.append({ kind, filePath });
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLLOADMANIFEST_P_H
+#define QQMLLOADMANIFEST_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQml/qtqmlglobal.h>
+
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QQmlTypeLoader;
+class QThreadPool;
+
+class Q_QML_PRIVATE_EXPORT QQmlLoadManifest
+{
+    Q_DISABLE_COPY_MOVE(QQmlLoadManifest)
+public:
+    enum Kind { Source, Qmldir, Plugin };
+
+    struct Entry
+    {
+        Kind kind;
+        QString filePath;
+
+        friend bool operator==(const Entry &a, const Entry &b)
+        {
+            return a.kind == b.kind && a.filePath == b.filePath;
+        }
+        friend bool operator!=(const Entry &a, const Entry &b) { return !(a == b); }
+    };
+
+    static std::unique_ptr<QQmlLoadManifest> create();
+
+    explicit QQmlLoadManifest(const QString &fileName);
+    ~QQmlLoadManifest();
+
+    QString fileName() const { return m_fileName; }
+    QList<Entry> loadedEntries() const { return m_loaded; }
+    QList<Entry> recordedEntries() const;
+
+    bool load();
+    bool save();
+
+    void prefetch(QQmlTypeLoader *loader);
+    void waitForPrefetch();
+
+    void record(Kind kind, const QString &filePath);
+
+private:
+    void prefetchEntry(QQmlTypeLoader *loader, const Entry &entry);
+
+    const QString m_fileName;
+    QList<Entry> m_loaded;
+
+    mutable QMutex m_mutex;
+    QList<Entry> m_recorded;
+    QSet<QString> m_recordedPaths[Plugin + 1];
+
+#if QT_CONFIG(thread)
+    std::unique_ptr<QThreadPool> m_prefetchPool;
+#endif
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLLOADMANIFEST_P_H
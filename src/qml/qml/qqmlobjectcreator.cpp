@@ -9,6 +9,7 @@
 #include <private/qv4functionobject_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qqmlbinding_p.h>
+#include <private/qqmlliteralplan_p.h>
 #include <private/qqmlstringconverters_p.h>
 #include <private/qqmlboundsignal_p.h>
 #include <private/qqmlcomponentattached_p.h>
@@ -145,6 +146,9 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
     Q_ASSERT(phase == Startup);
     phase = CreatingObjects;
 
+    if (topLevelCreator && QQmlLiteralPlan::isEnabled())
+        QQmlLiteralPlan::prepare(compilationUnit.data());
+
     int objectToCreate;
     bool isComponentRoot = false; // either a "real" component of or an inline component
 
@@ -337,6 +341,15 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
         }
     }
 
+    if (compilationUnit->literalPlan) {
+        if (const QVariant *value = compilationUnit->literalPlan->value(binding, propertyType)) {
+            // The value is shared by all instances. Writing a property copies it.
+            property->writeProperty(_qobject, const_cast<void *>(value->constData()),
+                                    propertyWriteFlags);
+            return;
+        }
+    }
+
     switch (propertyType.id()) {
     case QMetaType::QVariant: {
         if (binding->type() == QV4::CompiledData::Binding::Type_Number) {
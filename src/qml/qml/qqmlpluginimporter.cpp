@@ -283,6 +283,7 @@ QTypeRevision QQmlPluginImporter::importDynamicPlugin(
                     return QTypeRevision();
                 }
 
+                typeLoader->recordLoad(QQmlLoadManifest::Plugin, absoluteFilePath);
                 instance = plugin.loader->instance();
                 plugins->insert(std::make_pair(pluginId, std::move(plugin)));
 
@@ -54,55 +54,65 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         return;
     }
 
+    m_sourceCode = data;
+    m_debugging = isDebugging();
+    parseSource();
+}
+
+// May run on a worker thread, see QQmlDataBlob::parseSource().
+void QQmlScriptBlob::parse()
+{
     QString error;
-    QString source = data.readAll(&error);
+    QString source = m_sourceCode.readAll(&error);
     if (!error.isEmpty()) {
-        setError(error);
+        QQmlError e;
+        e.setUrl(url());
+        e.setDescription(error);
+        m_parseErrors << e;
         return;
     }
 
-    QV4::CompiledData::CompilationUnit unit;
-
     if (m_isModule) {
         QList<QQmlJS::DiagnosticMessage> diagnostics;
-        unit = QV4::Compiler::Codegen::compileModule(isDebugging(), urlString(), source,
-                                                     data.sourceTimeStamp(), &diagnostics);
-        QList<QQmlError> errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
-        if (!errors.isEmpty()) {
-            setError(errors);
-            return;
-        }
+        m_parsedUnit = QV4::Compiler::Codegen::compileModule(m_debugging, urlString(), source,
+                                                             m_sourceCode.sourceTimeStamp(), &diagnostics);
+        m_parseErrors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
     } else {
-        QmlIR::Document irUnit(isDebugging());
+        QmlIR::Document irUnit(m_debugging);
 
-        irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
+        irUnit.jsModule.sourceTimeStamp = m_sourceCode.sourceTimeStamp();
 
         QmlIR::ScriptDirectivesCollector collector(&irUnit);
         irUnit.jsParserEngine.setDirectives(&collector);
 
-        QList<QQmlError> errors;
         irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
                      &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString(), finalUrlString(),
-                     source, &errors, QV4::Compiler::ContextType::ScriptImportedByQML);
+                     source, &m_parseErrors, QV4::Compiler::ContextType::ScriptImportedByQML);
 
         source.clear();
-        if (!errors.isEmpty()) {
-            setError(errors);
+        if (!m_parseErrors.isEmpty())
             return;
-        }
 
         QmlIR::QmlUnitGenerator qmlGenerator;
         qmlGenerator.generate(irUnit);
-        unit = std::move(irUnit.javaScriptCompilationUnit);
+        m_parsedUnit = std::move(irUnit.javaScriptCompilationUnit);
+    }
+}
+
+void QQmlScriptBlob::sourceParsed()
+{
+    if (!m_parseErrors.isEmpty()) {
+        setError(std::exchange(m_parseErrors, {}));
+        return;
     }
 
-    auto executableUnit = QV4::ExecutableCompilationUnit::create(std::move(unit));
+    auto executableUnit = QV4::ExecutableCompilationUnit::create(std::move(m_parsedUnit));
 
     if (writeCacheFile()) {
         QString errorString;
         if (executableUnit->saveToDisk(url(), &errorString)) {
             QString error;
-            if (!executableUnit->loadFromDisk(url(), data.sourceTimeStamp(), &error)) {
+            if (!executableUnit->loadFromDisk(url(), m_sourceCode.sourceTimeStamp(), &error)) {
                 // ignore error, keep using the in-memory compilation unit.
             }
         } else {
@@ -111,6 +121,7 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         }
     }
 
+    m_sourceCode = SourceCodeData();
     initializeFromCompilationUnit(executableUnit);
 }
 
@@ -44,6 +44,8 @@ protected:
     void dataReceived(const SourceCodeData &) override;
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
     void done() override;
+    void parse() override;
+    void sourceParsed() override;
 
     QString stringAt(int index) const override;
 
@@ -55,6 +57,12 @@ private:
     QList<ScriptReference> m_scripts;
     QQmlRefPointer<QQmlScriptData> m_scriptData;
     const bool m_isModule;
+
+    // Input and output of parse()
+    SourceCodeData m_sourceCode;
+    bool m_debugging = false;
+    QV4::CompiledData::CompilationUnit m_parsedUnit;
+    QList<QQmlError> m_parseErrors;
 };
 
 QT_END_NAMESPACE
@@ -628,10 +628,9 @@ void QQmlTypeData::dataReceived(const SourceCodeData &data)
         return;
     }
 
-    if (!loadFromSource())
-        return;
-
-    continueLoadFromIR();
+    m_document.reset(new QmlIR::Document(isDebugging()));
+    m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
+    parseSource();
 }
 
 void QQmlTypeData::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit)
@@ -649,31 +648,53 @@ bool QQmlTypeData::loadFromSource()
 {
     m_document.reset(new QmlIR::Document(isDebugging()));
     m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
+    parse();
+    return reportParseErrors();
+}
+
+// May run on a worker thread, see QQmlDataBlob::parseSource(). The engine's
+// illegal names do not change after it has been set up.
+void QQmlTypeData::parse()
+{
+    Q_ASSERT(m_document);
     QQmlEngine *qmlEngine = typeLoader()->engine();
     QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
 
     QString sourceError;
     const QString source = m_backupSourceCode.readAll(&sourceError);
     if (!sourceError.isEmpty()) {
-        setError(sourceError);
-        return false;
+        QQmlError e;
+        e.setUrl(url());
+        e.setDescription(sourceError);
+        m_parseErrors << e;
+        return;
     }
 
     if (!compiler.generateFromQml(source, finalUrlString(), m_document.data())) {
-        QList<QQmlError> errors;
-        errors.reserve(compiler.errors.size());
+        m_parseErrors.reserve(compiler.errors.size());
         for (const QQmlJS::DiagnosticMessage &msg : std::as_const(compiler.errors)) {
             QQmlError e;
             e.setUrl(url());
             e.setLine(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startLine));
             e.setColumn(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startColumn));
             e.setDescription(msg.message);
-            errors << e;
+            m_parseErrors << e;
         }
-        setError(errors);
-        return false;
     }
-    return true;
+}
+
+void QQmlTypeData::sourceParsed()
+{
+    if (reportParseErrors())
+        continueLoadFromIR();
+}
+
+bool QQmlTypeData::reportParseErrors()
+{
+    if (m_parseErrors.isEmpty())
+        return true;
+    setError(std::exchange(m_parseErrors, {}));
+    return false;
 }
 
 void QQmlTypeData::restoreIR(QV4::CompiledData::CompilationUnit &&unit)
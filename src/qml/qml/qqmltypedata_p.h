@@ -79,12 +79,15 @@ protected:
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
     void allDependenciesDone() override;
     void downloadProgressChanged(qreal) override;
+    void parse() override;
+    void sourceParsed() override;
 
     QString stringAt(int index) const override;
 
 private:
     bool tryLoadFromDiskCache();
     bool loadFromSource();
+    bool reportParseErrors();
     void restoreIR(QV4::CompiledData::CompilationUnit &&unit);
     void continueLoadFromIR();
     void resolveTypes();
@@ -107,6 +110,7 @@ private:
 
     SourceCodeData m_backupSourceCode; // used when cache verification fails.
     QScopedPointer<QmlIR::Document> m_document;
+    QList<QQmlError> m_parseErrors;
     QV4::CompiledData::TypeReferenceMap m_typeReferences;
 
     QList<ScriptReference> m_scripts;
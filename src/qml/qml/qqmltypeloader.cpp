@@ -390,6 +390,8 @@ void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QByteArray &da
 
 void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QString &fileName)
 {
+    recordLoad(QQmlLoadManifest::Source, fileName);
+
     QQmlDataBlob::SourceCodeData d;
     d.fileInfo = QFileInfo(fileName);
     setData(blob, d);
@@ -404,6 +406,12 @@ void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QQmlDataBlob::
 
     blob->dataReceived(d);
 
+    // Continued in sourceParsedThread()
+    if (blob->m_isParsing) {
+        blob->m_inCallback = false;
+        return;
+    }
+
     if (!blob->isError() && !blob->isWaiting())
         blob->allDependenciesDone();
 
@@ -435,10 +443,41 @@ void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPriv
     blob->tryDone();
 }
 
+/*!
+Continues processing \a blob after its QQmlDataBlob::parse() has finished on a
+worker thread, as setData() would have done after QQmlDataBlob::dataReceived().
+*/
+void QQmlTypeLoader::sourceParsedThread(const QQmlDataBlob::Ptr &blob)
+{
+    ASSERT_LOADTHREAD();
+
+    Q_TRACE_SCOPE(QQmlCompiling, blob->url());
+    QQmlCompilingProfiler prof(profiler(), blob.data());
+
+    Q_ASSERT(blob->m_isParsing);
+    blob->m_isParsing = false;
+    blob->m_inCallback = true;
+
+    blob->sourceParsed();
+
+    if (!blob->isError() && !blob->isWaiting())
+        blob->allDependenciesDone();
+
+    if (blob->status() != QQmlDataBlob::Error)
+        blob->m_data.setStatus(QQmlDataBlob::WaitingForDependencies);
+
+    blob->m_inCallback = false;
+
+    blob->tryDone();
+}
+
 void QQmlTypeLoader::shutdownThread()
 {
-    if (m_thread && !m_thread->isShutdown())
+    if (m_thread && !m_thread->isShutdown()) {
+        // Parses that are still running post their results to the thread.
+        m_thread->waitForParseWorkers();
         m_thread->shutdown();
+    }
 }
 
 QQmlTypeLoader::Blob::PendingImport::PendingImport(
@@ -903,7 +942,10 @@ QQmlTypeLoader::QQmlTypeLoader(QQmlEngine *engine)
     , m_thread(new QQmlTypeLoaderThread(this))
     , m_mutex(m_thread->mutex())
     , m_typeCacheTrimThreshold(TYPELOADER_MINIMUM_TRIM_THRESHOLD)
+    , m_loadManifest(QQmlLoadManifest::create())
 {
+    if (m_loadManifest)
+        m_loadManifest->prefetch(this);
 }
 
 /*!
@@ -912,6 +954,11 @@ loaded files.
 */
 QQmlTypeLoader::~QQmlTypeLoader()
 {
+    if (m_loadManifest) {
+        m_loadManifest->waitForPrefetch();
+        m_loadManifest->save();
+    }
+
     // Stop the loader thread before releasing resources
     shutdownThread();
 
@@ -1253,8 +1300,12 @@ const QQmlTypeLoaderQmldirContent QQmlTypeLoader::qmldirContent(const QString &f
     }
 
     QQmlTypeLoaderQmldirContent **val = m_importQmlDirCache.value(filePath);
-    if (val)
+    if (val) {
+        // It may have been prefetched, and is used in this run all the same.
+        if ((*val)->hasContent())
+            recordLoad(QQmlLoadManifest::Qmldir, filePath);
         return **val;
+    }
     QQmlTypeLoaderQmldirContent *qmldir = new QQmlTypeLoaderQmldirContent;
 
 #define ERROR(description) { QQmlError e; e.setDescription(description); qmldir->setError(e); }
@@ -1267,6 +1318,7 @@ const QQmlTypeLoaderQmldirContent QQmlTypeLoader::qmldirContent(const QString &f
     } else if (file.open(QFile::ReadOnly)) {
         QByteArray data = file.readAll();
         qmldir->setContent(filePath, QString::fromUtf8(data));
+        recordLoad(QQmlLoadManifest::Qmldir, filePath);
     } else {
         ERROR(NOT_READABLE_ERROR.arg(filePath));
     }
@@ -1279,6 +1331,26 @@ const QQmlTypeLoaderQmldirContent QQmlTypeLoader::qmldirContent(const QString &f
     return *qmldir;
 }
 
+/*!
+Parses the qmldir file at \a filePath into the cache qmldirContent() looks it up
+in, unless it is cached already. Unlike qmldirContent(), this can be called from
+any thread and does not hold the lock while reading and parsing the file. Errors
+are left for qmldirContent() to report.
+*/
+void QQmlTypeLoader::prefetchQmldirContent(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!QQml_isFileCaseCorrect(filePath) || !file.open(QFile::ReadOnly))
+        return;
+
+    auto qmldir = std::make_unique<QQmlTypeLoaderQmldirContent>();
+    qmldir->setContent(filePath, QString::fromUtf8(file.readAll()));
+
+    LockHolder<QQmlTypeLoader> holder(this);
+    if (!m_importQmlDirCache.value(filePath))
+        m_importQmlDirCache.insert(filePath, qmldir.release());
+}
+
 void QQmlTypeLoader::setQmldirContent(const QString &url, const QString &content)
 {
     QQmlTypeLoaderQmldirContent *qmldir;
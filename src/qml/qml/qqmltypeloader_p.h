@@ -17,6 +17,7 @@
 
 #include <private/qqmldatablob_p.h>
 #include <private/qqmlimport_p.h>
+#include <private/qqmlloadmanifest_p.h>
 #include <private/qqmlmetatype_p.h>
 
 #include <QtQml/qtqmlglobal.h>
@@ -140,6 +141,13 @@ public:
 
     const QQmlTypeLoaderQmldirContent qmldirContent(const QString &filePath);
     void setQmldirContent(const QString &filePath, const QString &content);
+    void prefetchQmldirContent(const QString &filePath);
+
+    void recordLoad(QQmlLoadManifest::Kind kind, const QString &filePath)
+    {
+        if (m_loadManifest)
+            m_loadManifest->record(kind, filePath);
+    }
 
     void clearCache();
     void trimCache();
@@ -191,6 +199,7 @@ private:
     void setData(const QQmlDataBlob::Ptr &, const QString &fileName);
     void setData(const QQmlDataBlob::Ptr &, const QQmlDataBlob::SourceCodeData &);
     void setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit);
+    void sourceParsedThread(const QQmlDataBlob::Ptr &blob);
 
     typedef QHash<QUrl, QQmlTypeData *> TypeCache;
     typedef QHash<QUrl, QQmlScriptBlob *> ScriptCache;
@@ -216,6 +225,7 @@ private:
     ImportDirCache m_importDirCache;
     ImportQmlDirCache m_importQmlDirCache;
     ChecksumCache m_checksumCache;
+    std::unique_ptr<QQmlLoadManifest> m_loadManifest;
 
     template<typename Loader>
     void doLoad(const Loader &loader, QQmlDataBlob *blob, Mode mode);
@@ -9,15 +9,46 @@
 #include <private/qqmltypeloadernetworkreplyproxy_p.h>
 #endif
 
+#if QT_CONFIG(thread)
+#include <QtCore/qthreadpool.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
+#if QT_CONFIG(thread)
+static int parseThreadCount()
+{
+    bool ok = false;
+    const int count = qEnvironmentVariableIntValue("QML_TYPELOADER_THREADS", &ok);
+    return ok ? qBound(0, count, 64) : 0;
+}
+#endif
+
 QQmlTypeLoaderThread::QQmlTypeLoaderThread(QQmlTypeLoader *loader)
     : m_loader(loader)
 {
+#if QT_CONFIG(thread)
+    if (const int threads = parseThreadCount()) {
+        m_parsePool = new QThreadPool;
+        m_parsePool->setObjectName(QStringLiteral("QQmlTypeLoader parser"));
+        m_parsePool->setMaxThreadCount(threads);
+        // The parsers recurse as deeply as on the type loader thread itself.
+        m_parsePool->setStackSize(8 * 1024 * 1024);
+    }
+#endif
+
     // Do that after initializing all the members.
     startup();
 }
 
+QQmlTypeLoaderThread::~QQmlTypeLoaderThread()
+{
+#if QT_CONFIG(thread)
+    waitForParseWorkers();
+    delete m_parsePool;
+#endif
+}
+
 #if QT_CONFIG(qml_network)
 QNetworkAccessManager *QQmlTypeLoaderThread::networkAccessManager() const
 {
@@ -102,19 +133,103 @@ void QQmlTypeLoaderThread::initializeEngine(QQmlEngineExtensionInterface *iface,
     callMethodInMain(&This::initializeEngineExtensionMain, iface, uri);
 }
 
+/*!
+    \internal
+    Runs \a b's QQmlDataBlob::parse() on a worker thread if the type loader has
+    any, and returns \c true. QQmlTypeLoader::sourceParsedThread() is called for
+    it in this thread afterwards.
+
+    The messages that load blobs do not return before all parses they started are
+    processed, so synchronous loads still complete within the load call. Only the
+    parsing of independent files overlaps, their dependencies are resolved here in
+    the order the parses finish.
+ */
+bool QQmlTypeLoaderThread::parseConcurrently(const QQmlDataBlob::Ptr &b)
+{
+#if QT_CONFIG(thread)
+    Q_ASSERT(isThisThread());
+    if (!m_parsePool)
+        return false;
+
+    b->m_isParsing = true;
+    {
+        QMutexLocker locker(&m_parseMutex);
+        ++m_parsing;
+    }
+    m_parsePool->start([this, blob = b]() mutable {
+        blob->parse();
+
+        QMutexLocker locker(&m_parseMutex);
+        // Blobs must only be released in this thread, hand over the reference.
+        m_parsed.append(std::move(blob));
+        --m_parsing;
+        m_parseCondition.wakeOne();
+        if (m_parsed.size() == 1)
+            postMethodToThread(&This::processParsedThread);
+    });
+    return true;
+#else
+    Q_UNUSED(b);
+    return false;
+#endif
+}
+
+void QQmlTypeLoaderThread::waitForParseWorkers()
+{
+#if QT_CONFIG(thread)
+    if (m_parsePool)
+        m_parsePool->waitForDone();
+#endif
+}
+
+void QQmlTypeLoaderThread::processParsedThread()
+{
+    processParsed(false);
+}
+
+void QQmlTypeLoaderThread::processParsed(bool waitForWorkers)
+{
+#if QT_CONFIG(thread)
+    if (!m_parsePool)
+        return;
+
+    QMutexLocker locker(&m_parseMutex);
+    for (;;) {
+        if (!m_parsed.isEmpty()) {
+            QList<QQmlDataBlob::Ptr> parsed = std::exchange(m_parsed, {});
+            locker.unlock();
+            // May start parsing dependencies
+            for (const QQmlDataBlob::Ptr &b : std::as_const(parsed))
+                m_loader->sourceParsedThread(b);
+            parsed.clear();
+            locker.relock();
+        } else if (waitForWorkers && m_parsing > 0) {
+            m_parseCondition.wait(&m_parseMutex);
+        } else {
+            return;
+        }
+    }
+#else
+    Q_UNUSED(waitForWorkers);
+#endif
+}
+
 void QQmlTypeLoaderThread::loadThread(const QQmlDataBlob::Ptr &b)
 {
     m_loader->loadThread(b);
+    processParsed(true);
 }
 
 void QQmlTypeLoaderThread::loadWithStaticDataThread(const QQmlDataBlob::Ptr &b, const QByteArray &d)
 {
     m_loader->loadWithStaticDataThread(b, d);
+    processParsed(true);
 }
 
 void QQmlTypeLoaderThread::loadWithCachedUnitThread(const QQmlDataBlob::Ptr &b, const QQmlPrivate::CachedQmlUnit *unit)
 {
     m_loader->loadWithCachedUnitThread(b, unit);
+    processParsed(true);
 }
 
 void QQmlTypeLoaderThread::callCompletedMain(const QQmlDataBlob::Ptr &b)
@@ -21,6 +21,11 @@
 
 #include <QtQml/qtqmlglobal.h>
 
+#if QT_CONFIG(thread)
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+#endif
+
 #if QT_CONFIG(qml_network)
 #include <private/qqmltypeloadernetworkreplyproxy_p.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
@@ -31,6 +36,7 @@ QT_BEGIN_NAMESPACE
 class QQmlTypeLoader;
 class QQmlEngineExtensionInterface;
 class QQmlExtensionInterface;
+class QThreadPool;
 
 namespace QQmlPrivate {
 struct CachedQmlUnit;
@@ -42,6 +48,7 @@ class QQmlTypeLoaderThread : public QQmlThread
 
 public:
     QQmlTypeLoaderThread(QQmlTypeLoader *loader);
+    ~QQmlTypeLoaderThread();
 #if QT_CONFIG(qml_network)
     QNetworkAccessManager *networkAccessManager() const;
     QQmlTypeLoaderNetworkReplyProxy *networkReplyProxy() const;
@@ -57,6 +64,9 @@ public:
     void initializeEngine(QQmlExtensionInterface *, const char *);
     void initializeEngine(QQmlEngineExtensionInterface *, const char *);
 
+    bool parseConcurrently(const QQmlDataBlob::Ptr &b);
+    void waitForParseWorkers();
+
 private:
     void loadThread(const QQmlDataBlob::Ptr &b);
     void loadWithStaticDataThread(const QQmlDataBlob::Ptr &b, const QByteArray &);
@@ -65,12 +75,23 @@ private:
     void callDownloadProgressChangedMain(const QQmlDataBlob::Ptr &b, qreal p);
     void initializeExtensionMain(QQmlExtensionInterface *iface, const char *uri);
     void initializeEngineExtensionMain(QQmlEngineExtensionInterface *iface, const char *uri);
+    void processParsedThread();
+    void processParsed(bool waitForWorkers);
 
     QQmlTypeLoader *m_loader;
 #if QT_CONFIG(qml_network)
     mutable QNetworkAccessManager *m_networkAccessManager = nullptr;
     mutable QQmlTypeLoaderNetworkReplyProxy *m_networkReplyProxy = nullptr;
 #endif // qml_network
+
+#if QT_CONFIG(thread)
+    // Blobs being parsed on worker threads, see parseConcurrently()
+    QThreadPool *m_parsePool = nullptr;
+    QMutex m_parseMutex;
+    QWaitCondition m_parseCondition;
+    QList<QQmlDataBlob::Ptr> m_parsed;
+    int m_parsing = 0;
+#endif
 };
 
 QT_END_NAMESPACE
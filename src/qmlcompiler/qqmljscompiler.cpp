@@ -14,11 +14,13 @@
 #include <private/qqmljsshadowcheck_p.h>
 #include <private/qqmljsstoragegeneralizer_p.h>
 #include <private/qqmljstypepropagator_p.h>
+#include <private/qv4compilationunitbundle_p.h>
 
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qloggingcategory.h>
 
+#include <algorithm>
 #include <limits>
 
 QT_BEGIN_NAMESPACE
@@ -630,6 +632,85 @@ bool qSaveQmlJSUnitAsCpp(const QString &inputFileName, const QString &outputFile
     return true;
 }
 
+/*!
+    \internal
+    Writes \a units, each a compilation unit as it would be saved to a .qmlc
+    file, into a bundle at \a outputFileName. The type loader maps the bundle
+    once for all the files in the directory it is placed in, and finds the units
+    by the file names given with them.
+ */
+bool qSaveQmlJSUnitBundle(const QString &outputFileName, QList<QQmlJSBundledUnit> units,
+                          QString *errorString)
+{
+    using namespace QV4::CompiledData;
+
+    std::sort(units.begin(), units.end(),
+              [](const QQmlJSBundledUnit &a, const QQmlJSBundledUnit &b) {
+        return a.fileName.toUtf8() < b.fileName.toUtf8();
+    });
+
+    for (qsizetype i = 1; i < units.size(); ++i) {
+        if (units.at(i - 1).fileName == units.at(i).fileName) {
+            *errorString = QStringLiteral("Duplicate file name in bundle: %1")
+                    .arg(units.at(i).fileName);
+            return false;
+        }
+    }
+
+    const auto align = [](quint64 offset) {
+        return (offset + BundleUnitAlignment - 1) & ~quint64(BundleUnitAlignment - 1);
+    };
+
+    QByteArray names;
+    QList<BundleEntry> entries(units.size());
+    const quint64 namesOffset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+    for (qsizetype i = 0; i < units.size(); ++i) {
+        const QByteArray name = units.at(i).fileName.toUtf8();
+        BundleEntry &entry = entries[i];
+        entry.nameOffset = quint32(namesOffset + names.size());
+        entry.nameSize = quint32(name.size());
+        names += name;
+    }
+
+    quint64 offset = align(namesOffset + names.size());
+    for (qsizetype i = 0; i < units.size(); ++i) {
+        const QByteArray &data = units.at(i).data;
+        if (quint64(data.size()) < sizeof(Unit)) {
+            *errorString = QStringLiteral("Invalid compilation unit for %1").arg(units.at(i).fileName);
+            return false;
+        }
+        BundleEntry &entry = entries[i];
+        entry.unitOffset = offset;
+        entry.unitSize = quint32(data.size());
+        const QByteArray checksum = BundleEntry::calculateChecksum(data.constData(), data.size());
+        Q_ASSERT(checksum.size() == sizeof(entry.checksum));
+        memcpy(entry.checksum, checksum.constData(), sizeof(entry.checksum));
+        offset = align(offset + data.size());
+    }
+
+    BundleHeader header;
+    memcpy(header.magic, bundle_magic_str, sizeof(header.magic));
+    header.version = QV4_DATA_STRUCTURE_VERSION;
+    header.qtVersion = QT_VERSION;
+    header.unitCount = quint32(entries.size());
+    header.indexOffset = sizeof(BundleHeader);
+    const quint64 size = units.isEmpty() ? namesOffset + names.size() : offset;
+    header.size = size;
+
+    QByteArray bundle(qsizetype(size), '\0');
+    char *data = bundle.data();
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + sizeof(BundleHeader), entries.constData(), entries.size() * sizeof(BundleEntry));
+    memcpy(data + namesOffset, names.constData(), names.size());
+    for (qsizetype i = 0; i < units.size(); ++i) {
+        const QByteArray &unit = units.at(i).data;
+        memcpy(data + quint64(entries.at(i).unitOffset), unit.constData(), unit.size());
+    }
+
+    return SaveableUnitPointer::writeDataToFile(outputFileName, bundle.constData(), bundle.size(),
+                                                errorString);
+}
+
 QQmlJSAotCompiler::QQmlJSAotCompiler(
         QQmlJSImporter *importer, const QString &resourcePath, const QStringList &qmldirFiles,
         QQmlJSLogger *logger)
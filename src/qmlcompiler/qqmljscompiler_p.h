@@ -124,6 +124,16 @@ bool Q_QMLCOMPILER_PRIVATE_EXPORT qSaveQmlJSUnitAsCpp(const QString &inputFileNa
                                               const QQmlJSAotFunctionMap &aotFunctions,
                                               QString *errorString);
 
+struct QQmlJSBundledUnit
+{
+    QString fileName;
+    QByteArray data;
+};
+
+bool Q_QMLCOMPILER_PRIVATE_EXPORT qSaveQmlJSUnitBundle(const QString &outputFileName,
+                                               QList<QQmlJSBundledUnit> units,
+                                               QString *errorString);
+
 QT_END_NAMESPACE
 
 #endif // QQMLJSCOMPILER_P_H
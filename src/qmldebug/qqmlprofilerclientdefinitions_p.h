@@ -30,6 +30,9 @@ enum Message {
     SceneGraphFrame,
     MemoryAllocation,
     DebugMessage,
+    Quick3DFrame,
+    PropertyLookup,
+    GarbageCollection,
 
     MaximumMessage
 };
@@ -90,6 +93,23 @@ enum MemoryType {
     SmallItem
 };
 
+// Why an access through a lookup didn't take the cached fast path.
+enum LookupResult {
+    LookupHit,
+    LookupUnresolved,
+    LookupShapeChanged,
+    LookupQObjectReverted,
+    LookupFallback,
+    LookupMegamorphic,
+
+    MaximumLookupResult
+};
+
+enum GarbageCollectionType {
+    FullGarbageCollection,
+    MaximumGarbageCollectionType
+};
+
 enum ProfileFeature {
     ProfileJavaScript,
     ProfileMemory,
@@ -103,6 +123,8 @@ enum ProfileFeature {
     ProfileHandlingSignal,
     ProfileInputEvents,
     ProfileDebugMessages,
+    ProfileQuick3D,
+    ProfileLookups,
 
     MaximumProfileFeature
 };
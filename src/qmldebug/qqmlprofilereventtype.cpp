@@ -45,9 +45,12 @@ ProfileFeature QQmlProfilerEventType::feature() const
     case SceneGraphFrame:
         return ProfileSceneGraph;
     case MemoryAllocation:
+    case GarbageCollection:
         return ProfileMemory;
     case DebugMessage:
         return ProfileDebugMessages;
+    case PropertyLookup:
+        return ProfileLookups;
     default:
         break;
     }
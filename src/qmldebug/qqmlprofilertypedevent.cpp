@@ -128,6 +128,37 @@ QDataStream &operator>>(QDataStream &stream, QQmlProfilerTypedEvent &event)
         event.event.setNumbers<qint64>({delta});
         break;
     }
+    case GarbageCollection: {
+        qint64 duration;
+        stream >> duration;
+
+        event.type = QQmlProfilerEventType(
+                    static_cast<Message>(messageType),
+                    MaximumRangeType, subtype);
+        event.event.setNumbers<qint64>({duration});
+        break;
+    }
+    case PropertyLookup: {
+        // The subtype is the result of the lookup, which can differ from one event to the next.
+        // The location and the name are only sent with the first event of each lookup, so it is
+        // identified by its ID.
+        qint64 count = 0;
+        qint64 lookupId = 0;
+        stream >> count >> lookupId;
+        QString filename;
+        qint32 line = -1;
+        qint32 column = -1;
+        QString name;
+        if (!stream.atEnd())
+            stream >> filename >> line >> column >> name;
+
+        event.serverTypeId = lookupId;
+        event.type = QQmlProfilerEventType(
+                    static_cast<Message>(messageType), MaximumRangeType, -1,
+                    QQmlProfilerEventLocation(filename, line, column), name);
+        event.event.setNumbers<qint64>({subtype, count});
+        break;
+    }
     case RangeStart: {
         if (!stream.atEnd()) {
             qint64 typeId;
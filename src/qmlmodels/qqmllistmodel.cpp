@@ -551,6 +551,135 @@ ListModel *ListModel::getListProperty(int elementIndex, const ListLayout::Role &
     return e->getListProperty(role);
 }
 
+QV4::ReturnedValue ListModel::getColumn(const ListLayout::Role &role, const QQmlListModel *owner, QV4::ExecutionEngine *eng)
+{
+    const int count = elements.count();
+
+    QV4::Scope scope(eng);
+    QV4::ScopedArrayObject column(scope, eng->newArrayObject());
+    QV4::ScopedValue value(scope);
+    column->arrayReserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        ListElement *e = elements.at(i);
+
+        // Numbers and booleans don't need to go through QVariant.
+        switch (role.type) {
+            case ListLayout::Role::Number:
+                value = QV4::Value::fromDouble(*reinterpret_cast<double *>(e->getPropertyMemory(role)));
+                break;
+            case ListLayout::Role::Bool:
+                value = QV4::Value::fromBoolean(*reinterpret_cast<bool *>(e->getPropertyMemory(role)));
+                break;
+            default:
+                value = eng->fromVariant(e->getProperty(role, owner, eng));
+                break;
+        }
+
+        column->arrayPut(i, value);
+    }
+
+    column->setArrayLengthUnchecked(count);
+    return column.asReturnedValue();
+}
+
+static ListLayout::Role::DataType roleTypeOf(const QV4::Value &value)
+{
+    if (value.isString())
+        return ListLayout::Role::String;
+    if (value.isNumber())
+        return ListLayout::Role::Number;
+    if (value.isBoolean())
+        return ListLayout::Role::Bool;
+    if (value.as<QV4::ArrayObject>())
+        return ListLayout::Role::List;
+    if (value.as<QV4::DateObject>())
+        return ListLayout::Role::DateTime;
+    if (value.as<QV4::UrlObject>())
+        return ListLayout::Role::Url;
+    if (value.as<QV4::FunctionObject>())
+        return ListLayout::Role::Function;
+    if (value.as<QV4::QObjectWrapper>())
+        return ListLayout::Role::QObject;
+    if (value.isObject())
+        return ListLayout::Role::VariantMap;
+    return ListLayout::Role::Invalid;
+}
+
+// Whether ListElement::setJsProperty() stores \a value in \a role rather than ignoring it.
+static bool isAssignable(const ListLayout::Role &role, const QV4::Value &value)
+{
+    if (value.isNullOrUndefined())
+        return true;
+
+    const ListLayout::Role::DataType type = roleTypeOf(value);
+    if (type == role.type)
+        return true;
+
+    switch (role.type) {
+    case ListLayout::Role::VariantMap:
+        return type == ListLayout::Role::QObject;
+    case ListLayout::Role::Url:
+        return (type == ListLayout::Role::VariantMap || type == ListLayout::Role::QObject)
+                && QV4::ExecutionEngine::toVariant(value, QMetaType::fromType<QUrl>(), true)
+                        .metaType() == QMetaType::fromType<QUrl>();
+    default:
+        return false;
+    }
+}
+
+int ListModel::setColumn(QV4::String *key, const QV4::ArrayObject *values, int *firstChanged, int *lastChanged)
+{
+    const int count = elements.count();
+    *firstChanged = -1;
+    *lastChanged = -1;
+
+    QV4::ExecutionEngine *v4 = values->engine();
+    QV4::Scope scope(v4);
+    QV4::ScopedValue value(scope);
+
+    // A new role gets the type of the first value that can have one.
+    const ListLayout::Role *role = m_layout->getExistingRole(key);
+    for (int i = 0; !role && i < count; ++i) {
+        value = values->get(i);
+        const ListLayout::Role::DataType type = roleTypeOf(value);
+        if (type != ListLayout::Role::Invalid)
+            role = &m_layout->getRoleOrCreate(key, type);
+    }
+
+    if (!role)
+        return -1;
+
+    // Check all values first, so that the column is either written completely or not at all.
+    for (int i = 0; i < count; ++i) {
+        value = values->get(i);
+        if (!isAssignable(*role, value)) {
+            qmlWarning(nullptr) << QStringLiteral("setColumn: can't assign value at index %1 to role '%2' of type %3")
+                                   .arg(i).arg(role->name).arg(roleTypeName(role->type));
+            return -1;
+        }
+    }
+
+    const QVector<int> changedRoles(1, role->index);
+    for (int i = 0; i < count; ++i) {
+        ListElement *e = elements.at(i);
+        value = values->get(i);
+        if (value.isNullOrUndefined())
+            e->clearProperty(*role);
+        else if (e->setJsProperty(*role, value, v4) == -1)
+            continue; // unchanged
+
+        if (*firstChanged == -1)
+            *firstChanged = i;
+        *lastChanged = i;
+
+        if (ModelNodeMetaObject *cache = e->objectCache())
+            cache->updateValues(changedRoles);
+    }
+
+    return role->index;
+}
+
 void ListModel::updateTranslations()
 {
     for (int index = 0; index != elements.count(); ++index) {
@@ -2796,6 +2925,114 @@ void QQmlListModel::sync()
     qmlWarning(this) << "List sync() can only be called from a WorkerScript";
 }
 
+/*!
+    \qmlmethod array ListModel::getColumn(string role)
+    \since 6.6
+
+    Returns an array with the value of \a role for each item in the list model,
+    in order. This is considerably faster than calling get() for each item when
+    a single role of many items is needed, for example to sum it up:
+
+    \code
+        let total = fruitModel.getColumn("cost").reduce((sum, cost) => sum + cost, 0);
+    \endcode
+
+    Returns \c undefined if no item has the role.
+
+    \sa setColumn(), get()
+*/
+QJSValue QQmlListModel::getColumn(const QString &role) const
+{
+    QV4::Scope scope(engine());
+    QV4::ScopedValue result(scope, QV4::Value::undefinedValue());
+
+    if (m_dynamicRoles) {
+        if (m_roles.contains(role)) {
+            const int count = m_modelObjects.size();
+            QV4::ScopedArrayObject column(scope, scope.engine->newArrayObject());
+            QV4::ScopedValue value(scope);
+            column->arrayReserve(count);
+            for (int i = 0; i < count; ++i) {
+                value = scope.engine->fromVariant(m_modelObjects.at(i)->getValue(role));
+                column->arrayPut(i, value);
+            }
+            column->setArrayLengthUnchecked(count);
+            result = column;
+        }
+    } else {
+        QV4::ScopedString name(scope, scope.engine->newString(role));
+        if (const ListLayout::Role *r = m_listModel->getExistingRole(name))
+            result = m_listModel->getColumn(*r, this, scope.engine);
+    }
+
+    return QJSValuePrivate::fromReturnedValue(result->asReturnedValue());
+}
+
+/*!
+    \qmlmethod ListModel::setColumn(string role, array values)
+    \since 6.6
+
+    Sets \a role of each item in the list model to the value at the same
+    position in \a values. The length of \a values has to match the number of
+    items.
+
+    \code
+        fruitModel.setColumn("cost", fruitModel.getColumn("cost").map(cost => cost * 1.1));
+    \endcode
+
+    In contrast to calling setProperty() for each item, views are notified of
+    the change only once. \c null and \c undefined clear the role of an item.
+    If any of the other values has a different type than the role, a warning
+    is printed and none of the items is changed.
+
+    \sa getColumn(), setProperty()
+*/
+void QQmlListModel::setColumn(const QString &role, const QJSValue &values)
+{
+    QV4::Scope scope(engine());
+    QV4::ScopedArrayObject array(scope, QJSValuePrivate::asReturnedValue(&values));
+
+    if (!array) {
+        qmlWarning(this) << tr("setColumn: value is not an array");
+        return;
+    }
+    if (array->getLength() != qint64(count())) {
+        qmlWarning(this) << tr("setColumn: array length %1 doesn't match count %2")
+                            .arg(array->getLength()).arg(count());
+        return;
+    }
+
+    int roleIndex = -1;
+    int first = -1;
+    int last = -1;
+
+    if (m_dynamicRoles) {
+        roleIndex = m_roles.indexOf(role);
+        if (roleIndex == -1) {
+            roleIndex = m_roles.size();
+            m_roles.append(role);
+        }
+
+        const QByteArray name = role.toUtf8();
+        QV4::ScopedValue value(scope);
+        for (int i = 0, end = m_modelObjects.size(); i < end; ++i) {
+            value = array->get(i);
+            const QVariant variant = QV4::ExecutionEngine::toVariant(value, QMetaType {}, false);
+            if (!m_modelObjects[i]->setValue(name, variant))
+                continue;
+            if (first == -1)
+                first = i;
+            last = i;
+        }
+    } else {
+        QV4::ScopedString name(scope, scope.engine->newString(role));
+        roleIndex = m_listModel->setColumn(name, array, &first, &last);
+    }
+
+    if (roleIndex != -1 && first != -1)
+        emitItemsChanged(first, last - first + 1, QVector<int>(1, roleIndex));
+}
+
 bool QQmlListModelParser::verifyProperty(const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit, const QV4::CompiledData::Binding *binding)
 {
     if (binding->type() >= QV4::CompiledData::Binding::Type_Object) {
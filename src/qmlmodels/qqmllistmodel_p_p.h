@@ -326,6 +326,9 @@ public:
     QVariant getProperty(int elementIndex, int roleIndex, const QQmlListModel *owner, QV4::ExecutionEngine *eng);
     ListModel *getListProperty(int elementIndex, const ListLayout::Role &role);
 
+    QV4::ReturnedValue getColumn(const ListLayout::Role &role, const QQmlListModel *owner, QV4::ExecutionEngine *eng);
+    int setColumn(QV4::String *key, const QV4::ArrayObject *values, int *firstChanged, int *lastChanged);
+
     void updateTranslations();
 
     int roleCount() const
@@ -106,6 +106,16 @@ void QQmlListModelWorkerAgent::move(int from, int to, int count)
     m_copy->move(from, to, count);
 }
 
+QJSValue QQmlListModelWorkerAgent::getColumn(const QString &role) const
+{
+    return m_copy->getColumn(role);
+}
+
+void QQmlListModelWorkerAgent::setColumn(const QString &role, const QJSValue &values)
+{
+    m_copy->setColumn(role, values);
+}
+
 void QQmlListModelWorkerAgent::sync()
 {
     Sync *s = new Sync(m_copy);
@@ -60,6 +60,8 @@ public:
     Q_INVOKABLE void setProperty(int index, const QString& property, const QVariant& value);
     Q_INVOKABLE void move(int from, int to, int count);
     Q_INVOKABLE void sync();
+    Q_INVOKABLE QJSValue getColumn(const QString &role) const;
+    Q_INVOKABLE void setColumn(const QString &role, const QJSValue &values);
 
     void modelDestroyed();
 
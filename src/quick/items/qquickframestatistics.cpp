@@ -0,0 +1,552 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qquickframestatistics_p.h"
+
+#include <private/qsgrenderer_p.h>
+
+#include <QtCore/qmetaobject.h>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QQuickFrameStatistics
+    \inmodule QtQuick
+    \since 6.6
+
+    \brief The QQuickFrameStatistics class provides timing and load figures for the frames
+    rendered by a QQuickWindow.
+
+    Every QQuickWindow owns an instance of this class, accessible via
+    QQuickWindow::frameStatistics(). After each frame the render loop records how long the
+    polish, synchronization, render and swap phases took, how many batches the renderer
+    issued, and how many bytes of vertex and index data it uploaded. The interval between
+    two consecutive frames and its variation (the jitter) are recorded as well.
+
+    The properties describe the most recently completed frame. The last historySize frames
+    are kept, and average(), maximum() and percentile() evaluate a metric over this history.
+
+    With the threaded render loop the frames are recorded on the render thread. The
+    updated() signal is always emitted on the thread the object lives in, typically the GUI
+    thread, and several frames may have been completed by the time it is delivered.
+
+    Times are reported in milliseconds.
+
+    \sa QQuickWindow::frameStatistics()
+*/
+
+/*!
+    \qmltype FrameStatistics
+    \instantiates QQuickFrameStatistics
+    \inqmlmodule QtQuick
+    \ingroup qtquick-visual
+    \since 6.6
+    \brief Contains timing and load figures for the frames rendered by a Window.
+
+    This type is not creatable. It is available via the \l{Window::frameStatistics}
+    {Window.frameStatistics} property.
+
+    \code
+    Text {
+        text: "frame: " + Window.window.frameStatistics.frameTime.toFixed(2) + " ms, "
+              + "p95: " + Window.window.frameStatistics.percentile(FrameStatistics.FrameTime, 95).toFixed(2) + " ms"
+    }
+    \endcode
+*/
+
+/*!
+    \enum QQuickFrameStatistics::Metric
+
+    Selects the value evaluated by average(), maximum() and percentile().
+
+    \value PolishTime Time spent polishing items, in milliseconds.
+    \value SyncTime Time spent synchronizing the items with the scene graph, in milliseconds.
+    \value RenderTime Time spent rendering the scene graph, in milliseconds.
+    \value SwapTime Time spent presenting the frame, in milliseconds.
+    \value FrameTime The sum of the four phases above, in milliseconds.
+    \value FrameInterval Time between the ends of two consecutive frames, in milliseconds.
+    \value Jitter Difference between two consecutive frame intervals, in milliseconds.
+    \value BatchCount Number of batches the renderer issued.
+    \value UploadBytes Number of bytes of vertex and index data uploaded.
+    \value PaintedArea Number of pixels painted, with the software adaptation.
+    \value PresentError How much later than predicted the frame was presented, in
+           milliseconds, with frame pacing enabled.
+    \value IncubatedObjects Number of objects the window's incubation controller created
+           asynchronously between the frame and the previous one.
+*/
+
+static inline qreal qsg_nsToMs(qint64 ns)
+{
+    return ns / qreal(1000000);
+}
+
+qreal QQuickFrameStatisticsPrivate::Sample::value(QQuickFrameStatistics::Metric metric) const
+{
+    switch (metric) {
+    case QQuickFrameStatistics::PolishTime:
+        return qsg_nsToMs(polish);
+    case QQuickFrameStatistics::SyncTime:
+        return qsg_nsToMs(sync);
+    case QQuickFrameStatistics::RenderTime:
+        return qsg_nsToMs(render);
+    case QQuickFrameStatistics::SwapTime:
+        return qsg_nsToMs(swap);
+    case QQuickFrameStatistics::FrameTime:
+        return qsg_nsToMs(polish + sync + render + swap);
+    case QQuickFrameStatistics::FrameInterval:
+        return qsg_nsToMs(interval);
+    case QQuickFrameStatistics::Jitter:
+        return qsg_nsToMs(jitter);
+    case QQuickFrameStatistics::BatchCount:
+        return batches;
+    case QQuickFrameStatistics::UploadBytes:
+        return qreal(uploadBytes);
+    case QQuickFrameStatistics::PaintedArea:
+        return qreal(paintedArea);
+    case QQuickFrameStatistics::PresentError:
+        return qsg_nsToMs(presentError);
+    case QQuickFrameStatistics::IncubatedObjects:
+        return incubatedObjects;
+    }
+    return 0;
+}
+
+void QQuickFrameStatisticsPrivate::recordPolish(qint64 polishTime)
+{
+    QMutexLocker locker(&mutex);
+    pendingPolish += polishTime;
+}
+
+void QQuickFrameStatisticsPrivate::recordPresentError(qint64 presentError)
+{
+    QMutexLocker locker(&mutex);
+    pendingPresentError = presentError;
+}
+
+void QQuickFrameStatisticsPrivate::recordIncubation(int objectCount)
+{
+    QMutexLocker locker(&mutex);
+    pendingIncubatedObjects += objectCount;
+}
+
+void QQuickFrameStatisticsPrivate::recordFrame(qint64 syncTime, qint64 renderTime,
+                                               qint64 swapTime, const QSGRenderer *renderer)
+{
+    Q_Q(QQuickFrameStatistics);
+    {
+        QMutexLocker locker(&mutex);
+
+        Sample sample;
+        sample.polish = pendingPolish;
+        sample.sync = syncTime;
+        sample.render = renderTime;
+        sample.swap = swapTime;
+        if (renderer) {
+            sample.batches = renderer->lastFrameBatchCount();
+            sample.uploadBytes = renderer->lastFrameUploadBytes();
+            sample.paintedArea = renderer->lastFramePaintedArea();
+        }
+        sample.presentError = pendingPresentError;
+        sample.incubatedObjects = pendingIncubatedObjects;
+        pendingPolish = 0;
+        pendingPresentError = 0;
+        pendingIncubatedObjects = 0;
+
+        // The first frame after creation or reset() has no predecessor to measure against.
+        if (intervalTimer.isValid()) {
+            sample.interval = intervalTimer.nsecsElapsed();
+            intervalTimer.restart();
+            if (lastInterval >= 0)
+                sample.jitter = qAbs(sample.interval - lastInterval);
+            lastInterval = sample.interval;
+        } else {
+            intervalTimer.start();
+        }
+
+        if (samples.size() != historySize)
+            samples.resize(historySize);
+        samples[nextSample] = sample;
+        nextSample = (nextSample + 1) % historySize;
+        sampleCount = qMin(sampleCount + 1, historySize);
+        ++frameCount;
+    }
+
+    // Coalesce the notifications in case the render thread is faster than the GUI thread.
+    if (updatePending.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(q, [this, q]() {
+            updatePending.storeRelease(0);
+            emit q->updated();
+        }, Qt::QueuedConnection);
+    }
+}
+
+QQuickFrameStatisticsPrivate::Sample QQuickFrameStatisticsPrivate::latestSample() const
+{
+    QMutexLocker locker(&mutex);
+    if (!sampleCount)
+        return Sample();
+    return samples.at((nextSample + historySize - 1) % historySize);
+}
+
+QList<qreal> QQuickFrameStatisticsPrivate::history(QQuickFrameStatistics::Metric metric) const
+{
+    QMutexLocker locker(&mutex);
+    QList<qreal> values;
+    values.reserve(sampleCount);
+    for (int i = 0; i < sampleCount; ++i)
+        values.append(samples.at(i).value(metric));
+    return values;
+}
+
+QQuickFrameStatistics::QQuickFrameStatistics(QObject *parent)
+    : QObject(*new QQuickFrameStatisticsPrivate, parent)
+{
+}
+
+QQuickFrameStatistics::~QQuickFrameStatistics() = default;
+
+/*!
+    \property QQuickFrameStatistics::frameCount
+    \brief the number of frames recorded since creation or the last reset()
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::frameCount
+    The number of frames recorded since creation or the last reset().
+*/
+int QQuickFrameStatistics::frameCount() const
+{
+    Q_D(const QQuickFrameStatistics);
+    QMutexLocker locker(&d->mutex);
+    return d->frameCount;
+}
+
+/*!
+    \property QQuickFrameStatistics::polishTime
+    \brief the time spent polishing items for the last frame, in milliseconds
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::polishTime
+    The time spent polishing items for the last frame, in milliseconds.
+*/
+qreal QQuickFrameStatistics::polishTime() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(PolishTime);
+}
+
+/*!
+    \property QQuickFrameStatistics::syncTime
+    \brief the time spent synchronizing the scene graph for the last frame, in milliseconds
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::syncTime
+    The time spent synchronizing the scene graph for the last frame, in milliseconds.
+*/
+qreal QQuickFrameStatistics::syncTime() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(SyncTime);
+}
+
+/*!
+    \property QQuickFrameStatistics::renderTime
+    \brief the time spent rendering the last frame, in milliseconds
+
+    This is the CPU time spent recording the frame, not the time the GPU took to execute it.
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::renderTime
+    The time spent rendering the last frame, in milliseconds. This is the CPU time spent
+    recording the frame, not the time the GPU took to execute it.
+*/
+qreal QQuickFrameStatistics::renderTime() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(RenderTime);
+}
+
+/*!
+    \property QQuickFrameStatistics::swapTime
+    \brief the time spent presenting the last frame, in milliseconds
+
+    With vertical synchronization enabled this typically includes the time spent waiting for
+    the display.
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::swapTime
+    The time spent presenting the last frame, in milliseconds. With vertical synchronization
+    enabled this typically includes the time spent waiting for the display.
+*/
+qreal QQuickFrameStatistics::swapTime() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(SwapTime);
+}
+
+/*!
+    \property QQuickFrameStatistics::frameTime
+    \brief the sum of the polish, sync, render and swap times of the last frame, in milliseconds
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::frameTime
+    The sum of the polish, sync, render and swap times of the last frame, in milliseconds.
+*/
+qreal QQuickFrameStatistics::frameTime() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(FrameTime);
+}
+
+/*!
+    \property QQuickFrameStatistics::frameInterval
+    \brief the time between the end of the last frame and the end of the one before it, in
+    milliseconds
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::frameInterval
+    The time between the end of the last frame and the end of the one before it, in
+    milliseconds.
+*/
+qreal QQuickFrameStatistics::frameInterval() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(FrameInterval);
+}
+
+/*!
+    \property QQuickFrameStatistics::jitter
+    \brief the absolute difference between the last two frame intervals, in milliseconds
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::jitter
+    The absolute difference between the last two frame intervals, in milliseconds.
+*/
+qreal QQuickFrameStatistics::jitter() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().value(Jitter);
+}
+
+/*!
+    \property QQuickFrameStatistics::batchCount
+    \brief the number of batches the renderer issued for the last frame
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::batchCount
+    The number of batches the renderer issued for the last frame.
+*/
+int QQuickFrameStatistics::batchCount() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().batches;
+}
+
+/*!
+    \property QQuickFrameStatistics::uploadBytes
+    \brief the number of bytes of vertex and index data uploaded for the last frame
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::uploadBytes
+    The number of bytes of vertex and index data uploaded for the last frame.
+*/
+qint64 QQuickFrameStatistics::uploadBytes() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().uploadBytes;
+}
+
+/*!
+    \property QQuickFrameStatistics::paintedArea
+    \brief the number of pixels painted for the last frame
+
+    Only the \l{qtquick-visualcanvas-adaptations-software.html}{Software adaptation}
+    paints individual regions of the window and reports this value. It is 0 with
+    the other adaptations.
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::paintedArea
+    The number of pixels painted for the last frame. Only the Software adaptation
+    reports this value, it is 0 with the other adaptations.
+*/
+qint64 QQuickFrameStatistics::paintedArea() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().paintedArea;
+}
+
+/*!
+    \property QQuickFrameStatistics::presentError
+    \brief how much later than predicted the last frame was presented
+
+    The threaded render loop can predict when each frame will be presented and advance
+    animations to that time. This is enabled by setting the \c QSG_FRAME_PACING
+    environment variable to \c 1. The value is negative when the frame was presented
+    earlier than predicted, and 0 when frame pacing is not enabled.
+*/
+/*!
+    \qmlproperty real QtQuick::FrameStatistics::presentError
+    How much later than predicted the last frame was presented, in milliseconds. Only
+    reported by the threaded render loop with \c QSG_FRAME_PACING set, 0 otherwise.
+*/
+qreal QQuickFrameStatistics::presentError() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return qsg_nsToMs(d->latestSample().presentError);
+}
+
+/*!
+    \property QQuickFrameStatistics::incubatedObjects
+    \brief the number of objects created asynchronously for the last frame
+
+    This counts the objects created by incubators, for example by asynchronous
+    \l{Loader}{Loaders} and delegates of views, that are driven by the window's
+    incubation controller, since the previous frame. Objects are counted when
+    they are created, so an incubation that is spread over several frames is
+    counted in the frames that did the work, not in the one it completed in.
+
+    \sa QQuickWindow::incubationController()
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::incubatedObjects
+    The number of objects created asynchronously, for example by asynchronous
+    \l{Loader}{Loaders} and delegates of views, since the previous frame.
+*/
+int QQuickFrameStatistics::incubatedObjects() const
+{
+    Q_D(const QQuickFrameStatistics);
+    return d->latestSample().incubatedObjects;
+}
+
+/*!
+    \property QQuickFrameStatistics::historySize
+    \brief the number of frames average(), maximum() and percentile() are evaluated over
+
+    The default is 120. Changing the size discards the recorded history.
+*/
+/*!
+    \qmlproperty int QtQuick::FrameStatistics::historySize
+    The number of frames average(), maximum() and percentile() are evaluated over. The
+    default is 120. Changing the size discards the recorded history.
+*/
+int QQuickFrameStatistics::historySize() const
+{
+    Q_D(const QQuickFrameStatistics);
+    QMutexLocker locker(&d->mutex);
+    return d->historySize;
+}
+
+void QQuickFrameStatistics::setHistorySize(int size)
+{
+    Q_D(QQuickFrameStatistics);
+    size = qMax(1, size);
+    {
+        QMutexLocker locker(&d->mutex);
+        if (d->historySize == size)
+            return;
+        d->historySize = size;
+        d->samples.clear();
+        d->nextSample = 0;
+        d->sampleCount = 0;
+    }
+    emit historySizeChanged();
+}
+
+/*!
+    \qmlmethod real QtQuick::FrameStatistics::average(Metric metric)
+    Returns the mean of \a metric over the recorded history.
+*/
+/*!
+    Returns the mean of \a metric over the recorded history, or 0 if no frame was recorded.
+*/
+qreal QQuickFrameStatistics::average(Metric metric) const
+{
+    Q_D(const QQuickFrameStatistics);
+    const QList<qreal> values = d->history(metric);
+    if (values.isEmpty())
+        return 0;
+    qreal sum = 0;
+    for (qreal value : values)
+        sum += value;
+    return sum / values.size();
+}
+
+/*!
+    \qmlmethod real QtQuick::FrameStatistics::maximum(Metric metric)
+    Returns the largest value of \a metric in the recorded history.
+*/
+/*!
+    Returns the largest value of \a metric in the recorded history, or 0 if no frame was
+    recorded.
+*/
+qreal QQuickFrameStatistics::maximum(Metric metric) const
+{
+    Q_D(const QQuickFrameStatistics);
+    const QList<qreal> values = d->history(metric);
+    if (values.isEmpty())
+        return 0;
+    return *std::max_element(values.cbegin(), values.cend());
+}
+
+/*!
+    \qmlmethod real QtQuick::FrameStatistics::percentile(Metric metric, real percent)
+    Returns the value below which \a percent percent of the recorded values of \a metric
+    fall.
+*/
+/*!
+    Returns the value below which \a percent percent of the recorded values of \a metric
+    fall, using the nearest-rank method. Returns 0 if no frame was recorded.
+*/
+qreal QQuickFrameStatistics::percentile(Metric metric, qreal percent) const
+{
+    Q_D(const QQuickFrameStatistics);
+    QList<qreal> values = d->history(metric);
+    if (values.isEmpty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    const qreal rank = std::ceil(qBound(qreal(0), percent, qreal(100)) / 100 * values.size());
+    return values.at(qBound(0, int(rank) - 1, int(values.size()) - 1));
+}
+
+/*!
+    \qmlmethod QtQuick::FrameStatistics::reset()
+    Discards all recorded frames.
+*/
+/*!
+    Discards all recorded frames.
+*/
+void QQuickFrameStatistics::reset()
+{
+    Q_D(QQuickFrameStatistics);
+    {
+        QMutexLocker locker(&d->mutex);
+        d->samples.clear();
+        d->nextSample = 0;
+        d->sampleCount = 0;
+        d->frameCount = 0;
+        d->pendingPolish = 0;
+        d->pendingPresentError = 0;
+        d->pendingIncubatedObjects = 0;
+        d->intervalTimer.invalidate();
+        d->lastInterval = -1;
+    }
+    emit updated();
+}
+
+/*!
+    \fn void QQuickFrameStatistics::updated()
+
+    This signal is emitted after one or more frames have been recorded.
+*/
+
+/*!
+    \fn void QQuickFrameStatistics::historySizeChanged()
+
+    This signal is emitted when the historySize changes.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qquickframestatistics.cpp"
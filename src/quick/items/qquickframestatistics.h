@@ -0,0 +1,91 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQUICKFRAMESTATISTICS_H
+#define QQUICKFRAMESTATISTICS_H
+
+#include <QtCore/QObject>
+#include <QtQml/qqml.h>
+#include <QtQuick/qtquickglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickFrameStatisticsPrivate;
+
+class Q_QUICK_EXPORT QQuickFrameStatistics : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QQuickFrameStatistics)
+
+    Q_PROPERTY(int frameCount READ frameCount NOTIFY updated FINAL)
+    Q_PROPERTY(qreal polishTime READ polishTime NOTIFY updated FINAL)
+    Q_PROPERTY(qreal syncTime READ syncTime NOTIFY updated FINAL)
+    Q_PROPERTY(qreal renderTime READ renderTime NOTIFY updated FINAL)
+    Q_PROPERTY(qreal swapTime READ swapTime NOTIFY updated FINAL)
+    Q_PROPERTY(qreal frameTime READ frameTime NOTIFY updated FINAL)
+    Q_PROPERTY(qreal frameInterval READ frameInterval NOTIFY updated FINAL)
+    Q_PROPERTY(qreal jitter READ jitter NOTIFY updated FINAL)
+    Q_PROPERTY(int batchCount READ batchCount NOTIFY updated FINAL)
+    Q_PROPERTY(qint64 uploadBytes READ uploadBytes NOTIFY updated FINAL)
+    Q_PROPERTY(qint64 paintedArea READ paintedArea NOTIFY updated FINAL)
+    Q_PROPERTY(qreal presentError READ presentError NOTIFY updated FINAL)
+    Q_PROPERTY(int incubatedObjects READ incubatedObjects NOTIFY updated FINAL)
+    Q_PROPERTY(int historySize READ historySize WRITE setHistorySize NOTIFY historySizeChanged FINAL)
+    QML_NAMED_ELEMENT(FrameStatistics)
+    QML_UNCREATABLE("FrameStatistics is only available via Window.frameStatistics.")
+    QML_ADDED_IN_VERSION(6, 6)
+
+public:
+    enum Metric {
+        PolishTime,
+        SyncTime,
+        RenderTime,
+        SwapTime,
+        FrameTime,
+        FrameInterval,
+        Jitter,
+        BatchCount,
+        UploadBytes,
+        PaintedArea,
+        PresentError,
+        IncubatedObjects
+    };
+    Q_ENUM(Metric)
+
+    ~QQuickFrameStatistics() override;
+
+    int frameCount() const;
+    qreal polishTime() const;
+    qreal syncTime() const;
+    qreal renderTime() const;
+    qreal swapTime() const;
+    qreal frameTime() const;
+    qreal frameInterval() const;
+    qreal jitter() const;
+    int batchCount() const;
+    qint64 uploadBytes() const;
+    qint64 paintedArea() const;
+    qreal presentError() const;
+    int incubatedObjects() const;
+
+    int historySize() const;
+    void setHistorySize(int size);
+
+    Q_INVOKABLE qreal average(QQuickFrameStatistics::Metric metric) const;
+    Q_INVOKABLE qreal maximum(QQuickFrameStatistics::Metric metric) const;
+    Q_INVOKABLE qreal percentile(QQuickFrameStatistics::Metric metric, qreal percent) const;
+    Q_INVOKABLE void reset();
+
+Q_SIGNALS:
+    void updated();
+    void historySizeChanged();
+
+private:
+    friend class QQuickWindowPrivate;
+
+    explicit QQuickFrameStatistics(QObject *parent = nullptr);
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKFRAMESTATISTICS_H
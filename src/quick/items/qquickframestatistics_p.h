@@ -0,0 +1,86 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQUICKFRAMESTATISTICS_P_H
+#define QQUICKFRAMESTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qquickframestatistics.h"
+
+#include <QtCore/private/qobject_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSGRenderer;
+
+class Q_QUICK_PRIVATE_EXPORT QQuickFrameStatisticsPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QQuickFrameStatistics)
+public:
+    struct Sample
+    {
+        qint64 polish = 0; // all times in nanoseconds
+        qint64 sync = 0;
+        qint64 render = 0;
+        qint64 swap = 0;
+        qint64 interval = 0;
+        qint64 jitter = 0;
+        int batches = 0;
+        qint64 uploadBytes = 0;
+        qint64 paintedArea = 0;
+        qint64 presentError = 0;
+        int incubatedObjects = 0;
+
+        qreal value(QQuickFrameStatistics::Metric metric) const;
+    };
+
+    static QQuickFrameStatisticsPrivate *get(QQuickFrameStatistics *statistics)
+    {
+        return statistics->d_func();
+    }
+
+    // May be called from the render thread. Polish time and present error are held back until
+    // the frame they belong to has been recorded, so that every sample describes one complete
+    // frame.
+    void recordPolish(qint64 polishTime);
+    void recordPresentError(qint64 presentError);
+    void recordIncubation(int objectCount);
+    void recordFrame(qint64 syncTime, qint64 renderTime, qint64 swapTime,
+                     const QSGRenderer *renderer);
+
+    Sample latestSample() const;
+    QList<qreal> history(QQuickFrameStatistics::Metric metric) const;
+
+    mutable QMutex mutex;
+    QList<Sample> samples; // ring buffer of historySize entries
+    int nextSample = 0;
+    int sampleCount = 0;
+    int historySize = 120;
+    int frameCount = 0;
+
+    qint64 pendingPolish = 0;
+    qint64 pendingPresentError = 0;
+    int pendingIncubatedObjects = 0;
+    QElapsedTimer intervalTimer;
+    qint64 lastInterval = -1;
+
+    QAtomicInt updatePending;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKFRAMESTATISTICS_P_H
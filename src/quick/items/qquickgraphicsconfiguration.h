@@ -43,6 +43,9 @@ public:
     void setAutomaticPipelineCache(bool enable);
     bool isAutomaticPipelineCacheEnabled() const;
 
+    void setParallelBatchUpload(bool enable);
+    bool isParallelBatchUploadEnabled() const;
+
     void setPipelineCacheSaveFile(const QString &filename);
     QString pipelineCacheSaveFile() const;
 
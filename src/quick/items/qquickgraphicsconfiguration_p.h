@@ -35,7 +35,8 @@ public:
         EnableDebugMarkers = 0x04,
         PreferSoftwareDevice = 0x08,
         AutoPipelineCache = 0x10,
-        EnableTimestamps = 0x20
+        EnableTimestamps = 0x20,
+        ParallelBatchUpload = 0x40
     };
     Q_DECLARE_FLAGS(Flags, Flag)
 
@@ -22,6 +22,7 @@
 #include <QtQuick/QQuickRenderTarget>
 #include <QtQuick/private/qquickwindow_p.h>
 #include <QtQuick/private/qquickitem_p.h>
+#include <QtQuick/private/qquickframestatistics_p.h>
 #include <QtQuick/private/qsgsoftwarerenderer_p.h>
 #include <QtCore/private/qobject_p.h>
 
@@ -330,7 +331,10 @@ void QQuickRenderControl::polishItems()
     cd->deliveryAgentPrivate()->flushFrameSynchronousEvents(d->window);
     if (!d->window)
         return;
+    QElapsedTimer timer;
+    timer.start();
     cd->polishItems();
+    QQuickFrameStatisticsPrivate::get(cd->frameStatistics)->recordPolish(timer.nsecsElapsed());
     emit d->window->afterAnimating();
 }
 
@@ -363,8 +367,11 @@ bool QQuickRenderControl::sync()
         cd->setCustomCommandBuffer(d->cb);
     }
 
+    QElapsedTimer timer;
+    timer.start();
     cd->syncSceneGraph();
     d->rc->endSync();
+    d->syncTime = timer.nsecsElapsed();
 
     return true;
 }
@@ -431,7 +438,13 @@ void QQuickRenderControl::render()
         cd->setCustomCommandBuffer(d->cb);
     }
 
+    QElapsedTimer timer;
+    timer.start();
     cd->renderSceneGraph();
+    // Presenting is up to the application, so there is no swap time to report.
+    QQuickFrameStatisticsPrivate::get(cd->frameStatistics)->recordFrame(d->syncTime, timer.nsecsElapsed(),
+                                                                       0, cd->renderer);
+    d->syncTime = 0;
 }
 
 /*!
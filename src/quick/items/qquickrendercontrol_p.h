@@ -69,6 +69,7 @@ public:
     QOffscreenSurface *offscreenSurface;
     int sampleCount;
     FrameStatus frameStatus;
+    qint64 syncTime = 0; // of the current frame, for QQuickFrameStatistics
 };
 
 QT_END_NAMESPACE
@@ -8,6 +8,7 @@
 #include "qquickitem_p.h"
 #include "qquickevents_p_p.h"
 #include "qquickgraphicsdevice_p.h"
+#include "qquickframestatistics_p.h"
 
 #include <QtQuick/private/qsgrenderer_p.h>
 #include <QtQuick/private/qsgplaintexture_p.h>
@@ -34,6 +35,7 @@
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
 #include <QtQml/qqmlinfo.h>
+#include <QtQml/private/qqmlengine_p.h>
 #include <QtQml/private/qqmlmetatype_p.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -73,11 +75,17 @@ class QQuickWindowIncubationController : public QObject, public QQmlIncubationCo
     Q_OBJECT
 
 public:
-    QQuickWindowIncubationController(QSGRenderLoop *loop)
-        : m_renderLoop(loop), m_timer(0)
+    QQuickWindowIncubationController(QQuickWindow *window, QSGRenderLoop *loop)
+        : m_window(window), m_renderLoop(loop), m_timer(0)
     {
+        const qreal refreshRate = QGuiApplication::primaryScreen()->refreshRate();
+
         // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        m_incubation_time = qMax(1, int(1000 / refreshRate) / 3);
+
+        // When sized after the remaining frame budget, allow at least 1/8 of a
+        // frame, so that incubation does not starve if every frame is tight.
+        m_minimum_slice = qint64(1000000000 / refreshRate) / 8;
 
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
@@ -102,13 +110,35 @@ protected:
         }
     }
 
+    // Incubates until the deadline and records how many objects that created
+    // for the frame statistics of the window.
+    void incubateUntilAndRecord(QDeadlineTimer deadline)
+    {
+        QQmlEnginePrivate *enginePriv = QQmlEnginePrivate::get(engine());
+        const quint64 incubated = enginePriv->incubatedObjectCount;
+        incubateUntil(deadline);
+        QQuickFrameStatistics *statistics = QQuickWindowPrivate::get(m_window)->frameStatistics;
+        if (statistics) {
+            QQuickFrameStatisticsPrivate::get(statistics)->recordIncubation(
+                    int(enginePriv->incubatedObjectCount - incubated));
+        }
+    }
+
 public slots:
     void incubate() {
         if (m_renderLoop && incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                // Use what is left of the frame if the render loop can tell.
+                const qint64 remaining = m_renderLoop->remainingFrameBudget(m_window);
+                if (remaining >= 0) {
+                    incubateUntilAndRecord(QDeadlineTimer(
+                            std::chrono::nanoseconds(qMax(remaining, m_minimum_slice)),
+                            Qt::PreciseTimer));
+                } else {
+                    incubateUntilAndRecord(QDeadlineTimer(m_incubation_time));
+                }
             } else {
-                incubateFor(m_incubation_time * 2);
+                incubateUntilAndRecord(QDeadlineTimer(m_incubation_time * 2));
                 if (incubatingObjectCount())
                     incubateAgain();
             }
@@ -125,8 +155,10 @@ protected:
     }
 
 private:
+    QQuickWindow *m_window;
     QPointer<QSGRenderLoop> m_renderLoop;
     int m_incubation_time;
+    qint64 m_minimum_slice;
     int m_timer;
 };
 
@@ -677,6 +709,7 @@ QQuickWindowPrivate::QQuickWindowPrivate()
     , persistentSceneGraph(true)
     , componentCompleted(true)
     , inDestructor(false)
+    , frameStatistics(nullptr)
     , incubationController(nullptr)
     , hasActiveSwapchain(false)
     , hasRenderableSwapchain(false)
@@ -722,6 +755,8 @@ void QQuickWindowPrivate::init(QQuickWindow *c, QQuickRenderControl *control)
     contentItem->setSize(q->size());
     deliveryAgent = new QQuickDeliveryAgent(contentItem);
 
+    frameStatistics = new QQuickFrameStatistics(q);
+
     visualizationMode = qgetenv("QSG_VISUALIZE");
     renderControl = control;
     if (renderControl)
@@ -2581,6 +2616,12 @@ QImage QQuickWindow::grabWindow()
     for this window. QQuickView automatically installs this controller for you,
     otherwise you will need to install it yourself using \l{QQmlEngine::setIncubationController()}.
 
+    While animations are running, the controller incubates between frames. With
+    the threaded render loop it measures how long the frames take to render and
+    present, and incubates for the time that is left before the next frame has
+    to be polished. Otherwise it incubates for a third of a frame. The number of
+    objects created is reported by QQuickFrameStatistics::incubatedObjects.
+
     The controller is owned by the window and will be destroyed when the window
     is deleted.
 */
@@ -2592,7 +2633,7 @@ QQmlIncubationController *QQuickWindow::incubationController() const
         return nullptr; // TODO: make sure that this is safe
 
     if (!d->incubationController)
-        d->incubationController = new QQuickWindowIncubationController(d->windowManager);
+        d->incubationController = new QQuickWindowIncubationController(const_cast<QQuickWindow *>(this), d->windowManager);
     return d->incubationController;
 }
 
@@ -4108,6 +4149,43 @@ QQuickGraphicsConfiguration QQuickWindow::graphicsConfiguration() const
     return d->graphicsConfig;
 }
 
+/*!
+    \property QQuickWindow::frameStatistics
+    \brief the timing and load figures of the frames rendered for this window
+
+    The object is owned by the window and stays valid for its lifetime. It is
+    updated after every frame, regardless of whether the scene graph logging
+    categories are enabled.
+
+    \since 6.6
+    \sa QQuickFrameStatistics
+ */
+
+/*!
+    \qmlproperty FrameStatistics Window::frameStatistics
+    \readonly
+    \since 6.6
+
+    This property holds the timing and load figures of the frames rendered for
+    the window: the time spent polishing, synchronizing, rendering and
+    presenting, the number of batches, the amount of geometry uploaded and the
+    interval and jitter between frames.
+
+    \code
+    Window {
+        id: window
+        Text {
+            text: "avg " + window.frameStatistics.average(FrameStatistics.FrameTime).toFixed(2) + " ms"
+        }
+    }
+    \endcode
+ */
+QQuickFrameStatistics *QQuickWindow::frameStatistics() const
+{
+    Q_D(const QQuickWindow);
+    return d->frameStatistics;
+}
+
 /*!
     Creates a simple rectangle node. When the scenegraph is not initialized, the return value is null.
 
@@ -33,6 +33,7 @@ class QQuickPalette;
 class QQuickRenderTarget;
 class QQuickGraphicsDevice;
 class QQuickGraphicsConfiguration;
+class QQuickFrameStatistics;
 
 class Q_QUICK_EXPORT QQuickWindow : public QWindow
 {
@@ -43,6 +44,7 @@ class Q_QUICK_EXPORT QQuickWindow : public QWindow
     Q_PROPERTY(QQuickItem* activeFocusItem READ activeFocusItem NOTIFY activeFocusItemChanged REVISION(2, 1))
     Q_PRIVATE_PROPERTY(QQuickWindow::d_func(), QQuickPalette *palette READ palette WRITE setPalette
         RESET resetPalette NOTIFY paletteChanged REVISION(6, 2))
+    Q_PROPERTY(QQuickFrameStatistics *frameStatistics READ frameStatistics CONSTANT REVISION(6, 6) FINAL)
     QDOC_PROPERTY(QWindow* transientParent READ transientParent WRITE setTransientParent NOTIFY transientParentChanged)
     Q_CLASSINFO("DefaultProperty", "data")
     Q_DECLARE_PRIVATE(QQuickWindow)
@@ -148,6 +150,8 @@ public:
     void setGraphicsConfiguration(const QQuickGraphicsConfiguration &config);
     QQuickGraphicsConfiguration graphicsConfiguration() const;
 
+    QQuickFrameStatistics *frameStatistics() const;
+
     QSGRectangleNode *createRectangleNode() const;
     QSGImageNode *createImageNode() const;
     QSGNinePatchNode *createNinePatchNode() const;
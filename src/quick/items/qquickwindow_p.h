@@ -208,6 +208,8 @@ public:
 
     QQuickGraphicsConfiguration graphicsConfig;
 
+    QQuickFrameStatistics *frameStatistics;
+
     mutable QQuickWindowIncubationController *incubationController;
 
     static bool defaultAlphaBuffer;
@@ -9,6 +9,11 @@
 #include "qsgsoftwarerenderablenode_p.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVarLengthArray>
+#include <QtGui/QPainter>
 #include <QtGui/QWindow>
 #include <QtQuick/QSGSimpleRectNode>
 
@@ -16,11 +21,22 @@ Q_LOGGING_CATEGORY(lc2DRender, "qt.scenegraph.softwarecontext.abstractrenderer")
 
 QT_BEGIN_NAMESPACE
 
+// Updates smaller than this, in logical pixels, are not worth distributing.
+static const int minimumParallelArea = 256 * 256;
+static const int minimumTileHeight = 32;
+
 QSGAbstractSoftwareRenderer::QSGAbstractSoftwareRenderer(QSGRenderContext *context)
     : QSGRenderer(context)
     , m_background(new QSGSimpleRectNode)
     , m_nodeUpdater(new QSGSoftwareRenderableNodeUpdater(this))
 {
+    bool ok = false;
+    m_rasterThreadCount = qEnvironmentVariableIntValue("QSG_SOFTWARE_RENDER_THREADS", &ok);
+    if (!ok)
+        m_rasterThreadCount = 1;
+    else if (m_rasterThreadCount <= 0)
+        m_rasterThreadCount = qMin(QThread::idealThreadCount(), 4);
+
     // Setup special background node
     auto backgroundRenderable = new QSGSoftwareRenderableNode(QSGSoftwareRenderableNode::SimpleRect, m_background);
     addNodeMapping(m_background, backgroundRenderable);
@@ -34,6 +50,8 @@ QSGAbstractSoftwareRenderer::~QSGAbstractSoftwareRenderer()
     qDeleteAll(m_nodes);
 
     delete m_nodeUpdater;
+
+    delete m_rasterThreadPool;
 }
 
 QSGSoftwareRenderableNode *QSGAbstractSoftwareRenderer::renderableNode(QSGNode *node) const
@@ -107,6 +125,113 @@ QRegion QSGAbstractSoftwareRenderer::renderNodes(QPainter *painter)
     return dirtyRegion;
 }
 
+bool QSGAbstractSoftwareRenderer::canRenderNodesInParallel(const QImage *image, const QRegion &updateRegion) const
+{
+    if (m_rasterThreadCount < 2 || image->depth() < 8)
+        return false;
+
+    // Tiles must start on whole device pixels
+    const qreal dpr = image->devicePixelRatio();
+    if (!qFuzzyCompare(dpr, qreal(qRound(dpr))))
+        return false;
+
+    qint64 area = 0;
+    for (const QRect &rect : updateRegion)
+        area += qint64(rect.width()) * rect.height();
+    if (area < minimumParallelArea)
+        return false;
+
+    // Render nodes paint with the one painter exposed by the render context
+    for (QSGSoftwareRenderableNode *node : m_renderableNodes) {
+        if (node->type() == QSGSoftwareRenderableNode::RenderNode && node->isDirty())
+            return false;
+    }
+
+    return true;
+}
+
+// Splits the update region into horizontal bands and paints each band on its own
+// QPainter, on a QImage sharing the memory of the corresponding rows of \a image.
+// The result is the same as renderNodes() on a painter for \a image.
+QRegion QSGAbstractSoftwareRenderer::renderNodesInParallel(QImage *image, const QRegion &updateRegion)
+{
+    QRegion dirtyRegion;
+    // If there are no nodes, do nothing
+    if (m_renderableNodes.isEmpty())
+        return dirtyRegion;
+
+    const qreal dpr = image->devicePixelRatio();
+    QVarLengthArray<QSGSoftwareRenderableNode *, 256> nodesToPaint;
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes)) {
+        if (node->needsPainting()) {
+            node->preparePainting(dpr);
+            nodesToPaint.append(node);
+        }
+    }
+    // First node is the background and needs to painted without blending
+    const QSGSoftwareRenderableNode *backgroundNode = m_renderableNodes.first();
+
+    const QRect bounds = updateRegion.boundingRect().intersected(
+            QRect(QPoint(0, 0), image->deviceIndependentSize().toSize()));
+    const int tileCount = qBound(1, bounds.height() / minimumTileHeight, m_rasterThreadCount * 2);
+    const int tileHeight = (bounds.height() + tileCount - 1) / tileCount;
+
+    const int ratio = qRound(dpr);
+    const int bytesPerPixel = image->depth() / 8;
+    const qsizetype bytesPerLine = image->bytesPerLine();
+    uchar *bits = image->bits();
+
+    const auto paintTile = [&](int index) {
+        const QRect tile = QRect(bounds.x(), bounds.y() + index * tileHeight,
+                                 bounds.width(), tileHeight).intersected(bounds);
+        if (tile.isEmpty() || !updateRegion.intersects(tile))
+            return;
+
+        QImage tileImage(bits + qsizetype(tile.y()) * ratio * bytesPerLine
+                                 + qsizetype(tile.x()) * ratio * bytesPerPixel,
+                         tile.width() * ratio, tile.height() * ratio, bytesPerLine, image->format());
+        tileImage.setDevicePixelRatio(dpr);
+        QPainter painter(&tileImage);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(-tile.topLeft());
+        for (const QSGSoftwareRenderableNode *node : nodesToPaint) {
+            if (node->dirtyRegion().intersects(tile))
+                node->paint(&painter, node == backgroundNode, &m_glyphCacheMutex, tile.topLeft());
+        }
+    };
+
+    if (!m_rasterThreadPool) {
+        m_rasterThreadPool = new QThreadPool;
+        m_rasterThreadPool->setObjectName(QStringLiteral("QSGSoftwareRenderer raster"));
+        m_rasterThreadPool->setMaxThreadCount(m_rasterThreadCount - 1);
+    }
+
+    // The render thread paints tiles too, whoever is free takes the next one
+    QAtomicInt nextTile;
+    const auto paintTiles = [&]() {
+        for (int i = nextTile.fetchAndAddRelaxed(1); i < tileCount; i = nextTile.fetchAndAddRelaxed(1))
+            paintTile(i);
+    };
+
+    const int workerCount = qMin(m_rasterThreadCount - 1, tileCount - 1);
+    QSemaphore finishedWorkers;
+    for (int i = 0; i < workerCount; ++i) {
+        m_rasterThreadPool->start([&paintTiles, &finishedWorkers] {
+            paintTiles();
+            finishedWorkers.release();
+        });
+    }
+    paintTiles();
+    finishedWorkers.acquire(workerCount);
+
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes))
+        dirtyRegion += node->finishPainting();
+
+    qCDebug(lc2DRender) << "painted" << tileCount << "tiles of" << bounds << "on" << workerCount + 1 << "threads";
+
+    return dirtyRegion;
+}
+
 void QSGAbstractSoftwareRenderer::buildRenderList()
 {
     // Clear the previous renderlist
@@ -195,6 +320,14 @@ QRegion QSGAbstractSoftwareRenderer::optimizeRenderList()
     return updateRegion;
 }
 
+// Marks \a region to be painted again even though nothing changed there, after
+// optimizeRenderList(). Every node in it is repainted, back to front.
+void QSGAbstractSoftwareRenderer::repaintRegion(const QRegion &region)
+{
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes))
+        node->addDirtyRegion(region, true);
+}
+
 void QSGAbstractSoftwareRenderer::setBackgroundColor(const QColor &color)
 {
     if (m_background->color() == color)
@@ -18,10 +18,12 @@
 #include <private/qsgrenderer_p.h>
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 
 QT_BEGIN_NAMESPACE
 
 class QSGSimpleRectNode;
+class QThreadPool;
 
 class QSGSoftwareRenderableNode;
 class QSGSoftwareRenderableNodeUpdater;
@@ -42,8 +44,11 @@ public:
 
 protected:
     QRegion renderNodes(QPainter *painter);
+    bool canRenderNodesInParallel(const QImage *image, const QRegion &updateRegion) const;
+    QRegion renderNodesInParallel(QImage *image, const QRegion &updateRegion);
     void buildRenderList();
     QRegion optimizeRenderList();
+    void repaintRegion(const QRegion &region);
 
     void setBackgroundColor(const QColor &color);
     void setBackgroundRect(const QRect &rect, qreal devicePixelRatio);
@@ -72,6 +77,10 @@ private:
     bool m_isOpaque = false;
 
     QSGSoftwareRenderableNodeUpdater *m_nodeUpdater;
+
+    int m_rasterThreadCount;
+    QThreadPool *m_rasterThreadPool = nullptr;
+    QMutex m_glyphCacheMutex;
 };
 
 QT_END_NAMESPACE
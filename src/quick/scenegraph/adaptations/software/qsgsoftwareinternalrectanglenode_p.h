@@ -40,6 +40,7 @@ public:
 
     void update() override;
 
+    void updateDevicePixelRatio(qreal ratio);
     void paint(QPainter *);
 
     bool isOpaque() const;
@@ -18,6 +18,8 @@
 #include <private/qsgrendernode_p.h>
 #include <private/qsgplaintexture_p.h>
 
+#include <QtCore/qmutex.h>
+
 #include <qmath.h>
 
 Q_LOGGING_CATEGORY(lcRenderable, "qt.scenegraph.softwarecontext.renderable")
@@ -213,11 +215,9 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
 
     // Check for don't paint conditions
     if (m_nodeType != RenderNode) {
-        if (!m_isDirty || qFuzzyIsNull(m_opacity) || m_dirtyRegion.isEmpty()) {
-            m_isDirty = false;
-            m_dirtyRegion = QRegion();
-            return QRegion();
-        }
+        if (needsPainting())
+            paint(painter, forceOpaquePainting);
+        return finishPainting();
     } else {
         if (!m_isDirty || qFuzzyIsNull(m_opacity)) {
             m_isDirty = false;
@@ -249,7 +249,32 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
             return br;
         }
     }
+}
+
+bool QSGSoftwareRenderableNode::needsPainting() const
+{
+    return m_nodeType != RenderNode && m_isDirty && !qFuzzyIsNull(m_opacity) && !m_dirtyRegion.isEmpty();
+}
 
+void QSGSoftwareRenderableNode::preparePainting(qreal devicePixelRatio)
+{
+    // Resolve what the nodes would otherwise compute on first use in paint(), so
+    // that paint() only reads from the node.
+    switch (m_nodeType) {
+    case QSGSoftwareRenderableNode::Rectangle:
+        m_handle.rectangleNode->updateDevicePixelRatio(devicePixelRatio);
+        break;
+    case QSGSoftwareRenderableNode::SimpleImage:
+        static_cast<QSGSoftwareImageNode *>(m_handle.simpleImageNode)->preparePaint();
+        break;
+    default:
+        break;
+    }
+}
+
+void QSGSoftwareRenderableNode::paint(QPainter *painter, bool forceOpaquePainting,
+                                      QMutex *glyphCacheMutex, const QPoint &tileOrigin) const
+{
     painter->save();
     painter->setOpacity(m_opacity);
 
@@ -259,7 +284,11 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
     if (m_clipRegion.rectCount() > 1)
         painter->setClipRegion(m_clipRegion, Qt::IntersectClip);
 
-    painter->setTransform(m_transform, false); //precalculated worldTransform
+    //precalculated worldTransform, moved to the origin of the tile when painting in parallel
+    if (tileOrigin.isNull())
+        painter->setTransform(m_transform, false);
+    else
+        painter->setTransform(m_transform * QTransform::fromTranslate(-tileOrigin.x(), -tileOrigin.y()), false);
     if (forceOpaquePainting || m_isOpaque)
         painter->setCompositionMode(QPainter::CompositionMode_Source);
 
@@ -289,7 +318,11 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
         m_handle.rectangleNode->paint(painter);
         break;
     case QSGSoftwareRenderableNode::Glyph:
+    {
+        // The glyph caches of the font engines are shared between all painters.
+        QMutexLocker locker(glyphCacheMutex);
         m_handle.glpyhNode->paint(painter);
+    }
         break;
     case QSGSoftwareRenderableNode::NinePatch:
         m_handle.ninePatchNode->paint(painter);
@@ -310,6 +343,15 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
     }
 
     painter->restore();
+}
+
+QRegion QSGSoftwareRenderableNode::finishPainting()
+{
+    if (!needsPainting()) {
+        m_isDirty = false;
+        m_dirtyRegion = QRegion();
+        return QRegion();
+    }
 
     QRegion areaToBeFlushed = m_dirtyRegion;
     m_previousDirtyRegion = QRegion(m_boundingRectMax);
@@ -35,6 +35,7 @@ class QSGSoftwareGlyphNode;
 class QSGSoftwareNinePatchNode;
 class QSGSoftwareSpriteNode;
 class QSGRenderNode;
+class QMutex;
 
 class Q_QUICK_PRIVATE_EXPORT QSGSoftwareRenderableNode
 {
@@ -62,6 +63,17 @@ public:
     void update();
 
     QRegion renderNode(QPainter *painter, bool forceOpaquePainting = false);
+
+    // renderNode() split into steps, so that the node can be painted into
+    // several tiles at once. Not applicable to RenderNode. A painter that
+    // covers a tile with its top left corner at \a tileOrigin is translated
+    // by -tileOrigin.
+    bool needsPainting() const;
+    void preparePainting(qreal devicePixelRatio);
+    void paint(QPainter *painter, bool forceOpaquePainting = false,
+               QMutex *glyphCacheMutex = nullptr, const QPoint &tileOrigin = QPoint()) const;
+    QRegion finishPainting();
+
     QRect boundingRectMin() const { return m_boundingRectMin; }
     QRect boundingRectMax() const { return m_boundingRectMax; }
     NodeType type() const { return m_nodeType; }
@@ -8,6 +8,7 @@
 #include "qsgsoftwarecontext_p.h"
 #include "qsgsoftwarerenderablenode_p.h"
 
+#include <QtGui/QImage>
 #include <QtGui/QPaintDevice>
 #include <QtGui/QBackingStore>
 #include <QElapsedTimer>
@@ -21,6 +22,9 @@ QSGSoftwareRenderer::QSGSoftwareRenderer(QSGRenderContext *context)
     , m_paintDevice(nullptr)
     , m_backingStore(nullptr)
 {
+    // Backing stores preserve their contents between frames unless the
+    // platform says otherwise
+    m_bufferCount = qBound(1, qEnvironmentVariableIntValue("QSG_SOFTWARE_BUFFER_COUNT"), 8);
 }
 
 QSGSoftwareRenderer::~QSGSoftwareRenderer()
@@ -49,6 +53,14 @@ QRegion QSGSoftwareRenderer::flushRegion() const
     return m_flushRegion;
 }
 
+// Called when the contents of the buffers are lost, for example after the
+// backing store was resized. Each buffer is then repainted fully once.
+void QSGSoftwareRenderer::invalidateBuffers()
+{
+    m_validBufferCount = 0;
+    m_damageHistory.clear();
+}
+
 void QSGSoftwareRenderer::renderScene()
 {
     QSGRenderer::renderScene();
@@ -98,7 +110,31 @@ void QSGSoftwareRenderer::render()
     // side effect of this is that additional nodes may need to be marked dirty to
     // force a repaint.  It is also important that any item that needs to be
     // repainted only paints what is needed, via the use of clip regions.
-    const QRegion updateRegion = optimizeRenderList();
+    const QRegion damage = optimizeRenderList();
+    QRegion updateRegion = damage;
+
+    // With more than one buffer the one painted now was last painted
+    // m_bufferCount frames ago, so it also lacks the damage of the frames
+    // painted into the other buffers since then.
+    if (m_bufferCount > 1) {
+        QRegion missingRegion;
+        if (m_validBufferCount < m_bufferCount) {
+            missingRegion = QRegion(backgroundRect());
+            ++m_validBufferCount;
+        } else {
+            for (const QRegion &previousDamage : std::as_const(m_damageHistory))
+                missingRegion += previousDamage;
+        }
+        missingRegion -= damage;
+        if (!missingRegion.isEmpty()) {
+            repaintRegion(missingRegion);
+            updateRegion += missingRegion;
+        }
+
+        m_damageHistory.prepend(damage);
+        if (m_damageHistory.size() >= m_bufferCount)
+            m_damageHistory.resize(m_bufferCount - 1);
+    }
     qint64 optimizeRenderListTime = renderTimer.restart();
 
     // If Rendering to a backingstore, prepare it to be updated
@@ -109,22 +145,38 @@ void QSGSoftwareRenderer::render()
         paintDevice = backingStore->paintDevice();
     }
 
-    QPainter painter(paintDevice);
-    painter.setRenderHint(QPainter::Antialiasing);
-    auto rc = static_cast<QSGSoftwareRenderContext *>(context());
-    QPainter *prevPainter = rc->m_activePainter;
-    rc->m_activePainter = &painter;
-
-    // Render the contents Renderlist
-    m_flushRegion = renderNodes(&painter);
+    // Large updates of a raster image are split into tiles painted on a thread pool
+    QImage *image = paintDevice->devType() == QInternal::Image ? static_cast<QImage *>(paintDevice) : nullptr;
+    if (image && canRenderNodesInParallel(image, updateRegion)) {
+        m_flushRegion = renderNodesInParallel(image, updateRegion);
+    } else {
+        QPainter painter(paintDevice);
+        painter.setRenderHint(QPainter::Antialiasing);
+        auto rc = static_cast<QSGSoftwareRenderContext *>(context());
+        QPainter *prevPainter = rc->m_activePainter;
+        rc->m_activePainter = &painter;
+
+        // Render the contents Renderlist
+        m_flushRegion = renderNodes(&painter);
+
+        painter.end();
+        rc->m_activePainter = prevPainter;
+    }
     qint64 renderTime = renderTimer.elapsed();
 
-    painter.end();
+    // The rest of the target already matches what is on screen
+    if (m_bufferCount > 1)
+        m_flushRegion &= damage;
+
+    const qreal dpr = paintDevice->devicePixelRatio();
+    m_last_frame_painted_area = 0;
+    for (const QRect &rect : updateRegion)
+        m_last_frame_painted_area += qint64(rect.width() * dpr) * qint64(rect.height() * dpr);
+
     if (backingStore != nullptr)
         backingStore->endPaint();
-
-    rc->m_activePainter = prevPainter;
-    qCDebug(lcRenderer) << "render" << m_flushRegion << buildRenderListTime << optimizeRenderListTime << renderTime;
+    qCDebug(lcRenderer) << "render" << m_flushRegion << "painted" << updateRegion
+                        << buildRenderListTime << optimizeRenderListTime << renderTime;
 }
 
 QT_END_NAMESPACE
@@ -33,6 +33,8 @@ public:
     void setBackingStore(QBackingStore *backingStore);
     QRegion flushRegion() const;
 
+    void invalidateBuffers();
+
 protected:
     void renderScene() final;
     void render() final;
@@ -41,6 +43,12 @@ private:
     QPaintDevice* m_paintDevice;
     QBackingStore* m_backingStore;
     QRegion m_flushRegion;
+
+    // Number of buffers the target cycles through. Each one misses the damage
+    // of the frames painted into the others since it was last painted.
+    int m_bufferCount;
+    int m_validBufferCount = 0;
+    QList<QRegion> m_damageHistory; // newest first, m_bufferCount - 1 entries
 };
 
 QT_END_NAMESPACE
@@ -9,6 +9,7 @@
 
 #include <private/qquickwindow_p.h>
 #include <private/qquickitem_p.h>
+#include <private/qquickframestatistics_p.h>
 #include <QElapsedTimer>
 #include <private/qquickanimatorcontroller_p.h>
 #include <private/qquickprofiler_p.h>
@@ -83,8 +84,10 @@ void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window, bool isNewExpose)
         return;
 
     //Resize the backing store if necessary
+    bool buffersLost = isNewExpose;
     if (m_backingStores[window]->size() != window->size()) {
         m_backingStores[window]->resize(window->size());
+        buffersLost = true;
     }
 
     // ### create QPainter and set up pointer to current window/painter
@@ -104,16 +107,14 @@ void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window, bool isNewExpose)
     Q_TRACE_SCOPE(QSG_renderWindow)
     QElapsedTimer renderTimer;
     qint64 renderTime = 0, syncTime = 0, polishTime = 0;
-    bool profileFrames = QSG_RASTER_LOG_TIME_RENDERLOOP().isDebugEnabled();
-    if (profileFrames)
-        renderTimer.start();
+    // Always timed, QQuickWindow::frameStatistics() reports the phases of every frame.
+    renderTimer.start();
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishFrame);
     Q_TRACE(QSG_polishItems_entry);
 
     cd->polishItems();
 
-    if (profileFrames)
-        polishTime = renderTimer.nsecsElapsed();
+    polishTime = renderTimer.nsecsElapsed();
     Q_TRACE(QSG_polishItems_exit);
     Q_QUICK_SG_PROFILE_SWITCH(QQuickProfiler::SceneGraphPolishFrame,
                               QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -127,8 +128,7 @@ void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window, bool isNewExpose)
     cd->syncSceneGraph();
     rc->endSync();
 
-    if (profileFrames)
-        syncTime = renderTimer.nsecsElapsed();
+    syncTime = renderTimer.nsecsElapsed();
     Q_TRACE(QSG_sync_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopSync);
@@ -136,13 +136,15 @@ void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window, bool isNewExpose)
 
     //Tell the renderer about the windows backing store
     auto softwareRenderer = static_cast<QSGSoftwareRenderer*>(cd->renderer);
-    if (softwareRenderer)
+    if (softwareRenderer) {
         softwareRenderer->setBackingStore(m_backingStores[window]);
+        if (buffersLost)
+            softwareRenderer->invalidateBuffers();
+    }
 
     cd->renderSceneGraph();
 
-    if (profileFrames)
-        renderTime = renderTimer.nsecsElapsed();
+    renderTime = renderTimer.nsecsElapsed();
     Q_TRACE(QSG_render_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopRender);
@@ -164,9 +166,12 @@ void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window, bool isNewExpose)
 
     emit window->afterFrameEnd();
 
-    qint64 swapTime = 0;
-    if (profileFrames)
-        swapTime = renderTimer.nsecsElapsed();
+    const qint64 swapTime = renderTimer.nsecsElapsed();
+
+    QQuickFrameStatisticsPrivate *frameStatistics = QQuickFrameStatisticsPrivate::get(cd->frameStatistics);
+    frameStatistics->recordPolish(polishTime);
+    frameStatistics->recordFrame(syncTime - polishTime, renderTime - syncTime, swapTime - renderTime,
+                                 cd->renderer);
     Q_TRACE(QSG_swap_exit);
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRenderLoopFrame,
                            QQuickProfiler::SceneGraphRenderLoopSwap);
@@ -170,6 +170,7 @@ public:
     QWaitCondition waitCondition;
     QQuickWindow *exposedWindow = nullptr;
     QBackingStore *backingStore = nullptr;
+    bool backingStoreBuffersLost = false;
     bool stopEventProcessing = false;
     QSGSoftwareEventQueue eventQueue;
     QElapsedTimer renderThrottleTimer;
@@ -207,10 +208,14 @@ bool QSGSoftwareRenderThread::event(QEvent *e)
         if (sleeping)
             stopEventProcessing = true;
         exposedWindow = wme->window;
-        if (backingStore == nullptr)
+        if (backingStore == nullptr) {
             backingStore = new QBackingStore(exposedWindow);
-        if (backingStore->size() != exposedWindow->size())
+            backingStoreBuffersLost = true;
+        }
+        if (backingStore->size() != exposedWindow->size()) {
             backingStore->resize(exposedWindow->size());
+            backingStoreBuffersLost = true;
+        }
         qCDebug(QSG_RASTER_LOG_RENDERLOOP) << "RT - WM_RequestSync" << exposedWindow;
         pendingUpdate |= SyncRequest;
         if (wme->syncInExpose) {
@@ -454,8 +459,12 @@ void QSGSoftwareRenderThread::syncAndRender()
 
     if (canRender) {
         auto softwareRenderer = static_cast<QSGSoftwareRenderer*>(wd->renderer);
-        if (softwareRenderer)
+        if (softwareRenderer) {
             softwareRenderer->setBackingStore(backingStore);
+            if (backingStoreBuffersLost || exposeRequested)
+                softwareRenderer->invalidateBuffers();
+            backingStoreBuffersLost = false;
+        }
         wd->renderSceneGraph();
 
         Q_TRACE(QSG_render_exit);
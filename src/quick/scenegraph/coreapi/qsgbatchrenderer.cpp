@@ -8,11 +8,15 @@
 #include <qmath.h>
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QtNumeric>
 
 #include <QtGui/QGuiApplication>
 
 #include <private/qnumeric_p.h>
+#include <private/qsimd_p.h>
 #include "qsgmaterialshader_p.h"
 
 #include "qsgrhivisualizer_p.h"
@@ -42,6 +46,7 @@ DECLARE_DEBUG_VAR(dump)
 DECLARE_DEBUG_VAR(noalpha)
 DECLARE_DEBUG_VAR(noopaque)
 DECLARE_DEBUG_VAR(noclip)
+DECLARE_DEBUG_VAR(retain)
 #undef DECLARE_DEBUG_VAR
 
 #define QSGNODE_TRAVERSE(NODE) for (QSGNode *child = NODE->firstChild(); child; child = child->nextSibling())
@@ -701,6 +706,25 @@ BatchCompatibility Batch::isMaterialCompatible(Element *e) const
             : BatchBreaksOnCompare;
 }
 
+/*
+ * Unlike isMaterialCompatible(), which assumes that the rest of the batch still
+ * agrees, this compares the materials of all elements against each other.
+ */
+bool Batch::hasIncompatibleMaterials() const
+{
+    QSGMaterial *m = nullptr;
+    for (Element *e = first; e; e = e->nextInBatch) {
+        if (e->removed)
+            continue;
+        QSGMaterial *em = e->node->activeMaterial();
+        if (!m)
+            m = em;
+        else if (em->type() != m->type() || em->compare(m) != 0)
+            return true;
+    }
+    return false;
+}
+
 /*
  * Marks this batch as dirty or in the case where the geometry node has
  * changed to be incompatible with this batch, return false so that
@@ -877,6 +901,8 @@ Renderer::Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMod
     m_batchNodeThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_NODE_THRESHOLD", 64);
     m_batchVertexThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_VERTEX_THRESHOLD", 1024);
     m_srbPoolThreshold = qt_sg_envInt("QSG_RENDERER_SRB_POOL_THRESHOLD", 1024);
+    m_parallelUploadThreshold = qt_sg_envInt("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD", 16);
+    m_retainFrameThreshold = qt_sg_envInt("QSG_RENDERER_RETAIN_FRAME_THRESHOLD", 0);
 
     if (Q_UNLIKELY(debug_build() || debug_render())) {
         qDebug("Batch thresholds: nodes: %d vertices: %d Srb pool threshold: %d",
@@ -907,6 +933,8 @@ static void qsg_wipeBatch(Batch *batch)
 
 Renderer::~Renderer()
 {
+    unparkRetainedBatches();
+
     if (m_rhi) {
         // Clean up batches and buffers
         for (int i = 0; i < m_opaqueBatches.size(); ++i)
@@ -932,6 +960,7 @@ Renderer::~Renderer()
 
     destroyGraphicsResources();
 
+    delete m_uploadThreadPool;
     delete m_visualizer;
 }
 
@@ -968,22 +997,26 @@ void Renderer::releaseCachedResources()
 
 void Renderer::invalidateAndRecycleBatch(Batch *b)
 {
+    parkRetainedBatch(b);
     b->invalidate();
+    if (b->parked)
+        return;
     for (int i=0; i<m_batchPool.size(); ++i)
         if (b == m_batchPool.at(i))
             return;
     m_batchPool.add(b);
 }
 
-void Renderer::map(Buffer *buffer, quint32 byteSize, bool isIndexBuf)
+void Renderer::map(Buffer *buffer, quint32 byteSize, bool isIndexBuf, quint32 poolOffset)
 {
     if (m_visualizer->mode() == Visualizer::VisualizeNothing) {
         // Common case, use a shared memory pool for uploading vertex data to avoid
-        // excessive reevaluation
+        // excessive reevaluation. Parallel uploads map each batch to its own
+        // slice of the pool, which is then sized up front.
         QDataBuffer<char> &pool = isIndexBuf ? m_indexUploadPool : m_vertexUploadPool;
-        if (byteSize > quint32(pool.size()))
-            pool.resize(byteSize);
-        buffer->data = pool.data();
+        if (poolOffset + byteSize > quint32(pool.size()))
+            pool.resize(poolOffset + byteSize);
+        buffer->data = pool.data() + poolOffset;
     } else if (buffer->size != byteSize) {
         free(buffer->data);
         buffer->data = (char *) malloc(byteSize);
@@ -1123,6 +1156,7 @@ void Renderer::nodeWasTransformed(Node *node, int *vertexCount)
         Element *e  = node->element();
         if (e) {
             e->boundsComputed = false;
+            e->lastChangeFrame = m_currentFrame;
             if (e->batch) {
                 if (!e->batch->isOpaque) {
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
@@ -1152,6 +1186,7 @@ void Renderer::nodeWasAdded(QSGNode *node, Node *shadowParent)
     if (node->type() == QSGNode::GeometryNodeType) {
         snode->data = m_elementAllocator.allocate();
         snode->element()->setNode(static_cast<QSGGeometryNode *>(node));
+        snode->element()->lastChangeFrame = m_currentFrame;
 
     } else if (node->type() == QSGNode::ClipNodeType) {
         snode->data = new ClipBatchRootInfo;
@@ -1191,6 +1226,9 @@ void Renderer::nodeWasRemoved(Node *node)
     if (node->type() == QSGNode::GeometryNodeType) {
         Element *e = node->element();
         if (e) {
+            // The element may be part of a parked batch, which must then not
+            // be matched against the batches of the next frame.
+            unparkRetainedBatches();
             e->removed = true;
             m_elementsToDelete.add(e);
             e->node = nullptr;
@@ -1347,6 +1385,7 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
         Element *e = shadowNode->element();
         if (e) {
             e->boundsComputed = false;
+            e->lastChangeFrame = m_currentFrame;
             Batch *b = e->batch;
             if (b) {
                 if (!e->batch->geometryWasChanged(gn) || !e->batch->isOpaque) {
@@ -1361,6 +1400,7 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
     if (state & QSGNode::DirtyMaterial && node->type() == QSGNode::GeometryNodeType) {
         Element *e = shadowNode->element();
         if (e) {
+            e->lastChangeFrame = m_currentFrame;
             bool blended = hasMaterialWithBlending(static_cast<QSGGeometryNode *>(node));
             if (e->isMaterialBlended != blended) {
                 m_rebuild |= Renderer::FullRebuild;
@@ -1615,6 +1655,7 @@ void Renderer::invalidateBatchAndOverlappingRenderOrders(Batch *batch)
     int last = batch->lastOrderInBatch;
 #endif
 
+    parkRetainedBatch(batch);
     batch->invalidate();
 
     for (int i=0; i<m_alphaBatches.size(); ++i) {
@@ -1622,8 +1663,10 @@ void Renderer::invalidateBatchAndOverlappingRenderOrders(Batch *batch)
         if (b->first) {
             int bf = b->first->order;
             int bl = b->lastOrderInBatch;
-            if (bl > first && bf < last)
+            if (bl > first && bf < last) {
+                parkRetainedBatch(b);
                 b->invalidate();
+            }
         }
     }
 
@@ -1645,6 +1688,145 @@ void Renderer::cleanupBatches(QDataBuffer<Batch *> *batches) {
     }
 }
 
+/* A batch that has to be uploaded because some of its elements changed in
+ * this frame, while others have been static for a while, is split up so that
+ * the static elements end up in a retained batch of their own. That batch is
+ * then not touched again until one of its elements changes.
+ */
+void Renderer::splitMixedBatches()
+{
+    if (m_retainFrameThreshold <= 0)
+        return;
+
+    const auto split = [this](const QDataBuffer<Batch *> &batches) {
+        for (int i = 0; i < batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (!b->first || !b->needsUpload || b->isRenderNode)
+                continue;
+            int staticCount = 0;
+            int changedCount = 0;
+            for (Element *e = b->first; e; e = e->nextInBatch) {
+                if (e->removed)
+                    continue;
+                if (isStaticElement(e))
+                    ++staticCount;
+                else if (e->lastChangeFrame == m_currentFrame)
+                    ++changedCount;
+            }
+            if (staticCount && changedCount) {
+                if (Q_UNLIKELY(debug_retain()))
+                    qDebug() << " - splitting batch" << b << "static elements:" << staticCount
+                             << "changed elements:" << changedCount;
+                invalidateBatchAndOverlappingRenderOrders(b);
+            }
+        }
+    };
+    split(m_opaqueBatches);
+    split(m_alphaBatches);
+}
+
+/* Invalidating a batch normally recycles its buffers. For retained batches
+ * that are invalidated without any change to their own content, typically
+ * because an overlapping alpha batch or a subtree was rebuilt, the batch is
+ * parked instead, together with the elements it contained.
+ * adoptRetainedBatches() then puts it back in place if batching recreates
+ * the very same batch.
+ */
+void Renderer::parkRetainedBatch(Batch *b)
+{
+    if (!b->retained || b->parked || b->needsUpload || b->isRenderNode || !b->first)
+        return;
+
+    RetainedBatch retained;
+    retained.batch = b;
+    retained.root = b->root;
+    retained.isOpaque = b->isOpaque;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (e->removed)
+            return;
+        retained.elements.append({ e, e->order });
+    }
+
+    b->parked = true;
+    m_parkedBatches.insert(b->first, std::move(retained));
+}
+
+/* Drops all parked batches, so that they are recycled like any other
+ * invalidated batch. Outside of prepareRenderPass(), parked batches are still
+ * in the batch lists, without elements, and cleanupBatches() or the destructor
+ * takes care of them.
+ */
+void Renderer::unparkRetainedBatches()
+{
+    for (const RetainedBatch &retained : std::as_const(m_parkedBatches))
+        retained.batch->parked = false;
+    m_parkedBatches.clear();
+}
+
+void Renderer::adoptRetainedBatches()
+{
+    if (m_parkedBatches.isEmpty())
+        return;
+
+    const auto adopt = [this](QDataBuffer<Batch *> &batches) {
+        for (int i = 0; i < batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (!b->retained || !b->needsUpload || b->parked)
+                continue;
+            const auto it = m_parkedBatches.constFind(b->first);
+            if (it == m_parkedBatches.cend())
+                continue;
+
+            const RetainedBatch &retained = it.value();
+            Batch *rb = retained.batch;
+            // The vertex data is relative to the root, and the z data depends
+            // on the render order of each element.
+            const bool hasZ = rb->zRangeInBuffer >= 0;
+            bool same = retained.root == b->root && retained.isOpaque == b->isOpaque
+                    && (!hasZ || rb->zRangeInBuffer == m_zRange);
+            Element *e = b->first;
+            for (const auto &[element, order] : retained.elements) {
+                if (!same)
+                    break;
+                same = e == element && (!hasZ || e->order == order);
+                if (e)
+                    e = e->nextInBatch;
+            }
+            if (!same || e)
+                continue;
+
+            if (Q_UNLIKELY(debug_retain()))
+                qDebug() << " - reusing retained batch" << rb << "vertices:" << rb->vertexCount;
+
+            for (e = b->first; e; e = e->nextInBatch)
+                e->batch = rb;
+            rb->first = b->first;
+            rb->root = b->root;
+            rb->lastOrderInBatch = b->lastOrderInBatch;
+            rb->needsUpload = false;
+            rb->needsPurge = false;
+            rb->ubufDataValid = false;
+            rb->parked = false;
+            rb->clipState.reset();
+            batches.at(i) = rb;
+
+            m_parkedBatches.erase(it);
+            b->first = nullptr;
+            b->root = nullptr;
+            invalidateAndRecycleBatch(b);
+        }
+    };
+    adopt(m_opaqueBatches);
+    adopt(m_alphaBatches);
+
+    // Whatever was not recreated goes back to the pool.
+    for (const RetainedBatch &retained : std::as_const(m_parkedBatches)) {
+        retained.batch->parked = false;
+        invalidateAndRecycleBatch(retained.batch);
+    }
+    m_parkedBatches.clear();
+}
+
 void Renderer::prepareOpaqueBatches()
 {
     for (int i=m_opaqueRenderList.size() - 1; i >= 0; --i) {
@@ -1656,6 +1838,7 @@ void Renderer::prepareOpaqueBatches()
         batch->root = ei->root;
         batch->isOpaque = true;
         batch->needsUpload = true;
+        batch->retained = isStaticElement(ei);
         batch->positionAttribute = qsg_positionAttribute(ei->node->geometry());
 
         m_opaqueBatches.add(batch);
@@ -1682,7 +1865,8 @@ void Renderer::prepareOpaqueBatches()
                     && gni->geometry()->attributes() == gnj->geometry()->attributes()
                     && gni->inheritedOpacity() == gnj->inheritedOpacity()
                     && gni->activeMaterial()->type() == gnj->activeMaterial()->type()
-                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0) {
+                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0
+                    && isStaticElement(ej) == batch->retained) {
                 ej->batch = batch;
                 next->nextInBatch = ej;
                 next = ej;
@@ -1755,6 +1939,7 @@ void Renderer::prepareAlphaBatches()
         batch->root = ei->root;
         batch->isOpaque = false;
         batch->needsUpload = true;
+        batch->retained = isStaticElement(ei);
         m_alphaBatches.add(batch);
         ei->batch = batch;
 
@@ -1793,7 +1978,8 @@ void Renderer::prepareAlphaBatches()
                     && gni->geometry()->attributes() == gnj->geometry()->attributes()
                     && gni->inheritedOpacity() == gnj->inheritedOpacity()
                     && gni->activeMaterial()->type() == gnj->activeMaterial()->type()
-                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0) {
+                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0
+                    && isStaticElement(ej) == batch->retained) {
                 if (!overlapBounds.intersects(ej->bounds) || !checkOverlap(i+1, j - 1, ej->bounds)) {
                     ej->batch = batch;
                     next->nextInBatch = ej;
@@ -1844,6 +2030,106 @@ static inline float calculateElementZOrder(const Element *e, qreal zRange)
     return std::clamp(1.0f - float(e->order * zRange), VIEWPORT_MIN_DEPTH, VIEWPORT_MAX_DEPTH);
 }
 
+/* The vertex kernels below work on the 2D float position that every merged
+ * vertex has at the same offset. Vertices are vSize bytes apart, so both the
+ * SSE2 and the NEON versions gather two of them into one register per
+ * iteration. The arithmetic is the same as in Pt::map(), so results don't
+ * depend on the instruction set, apart from the compiler contracting the
+ * scalar version into fused multiply-adds where it may.
+ */
+
+void qsg_translateVertices(char *vdata, int vCount, int vSize, float dx, float dy)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 t = _mm_setr_ps(dx, dy, dx, dy);
+    for (; i + 1 < vCount; i += 2) {
+        __m64 *p0 = reinterpret_cast<__m64 *>(vdata);
+        __m64 *p1 = reinterpret_cast<__m64 *>(vdata + vSize);
+        __m128 v = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), p0), p1);
+        v = _mm_add_ps(v, t);
+        _mm_storel_pi(p0, v);
+        _mm_storeh_pi(p1, v);
+        vdata += 2 * vSize;
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const float32x4_t t = { dx, dy, dx, dy };
+    for (; i + 1 < vCount; i += 2) {
+        float *p0 = reinterpret_cast<float *>(vdata);
+        float *p1 = reinterpret_cast<float *>(vdata + vSize);
+        const float32x4_t v = vaddq_f32(vcombine_f32(vld1_f32(p0), vld1_f32(p1)), t);
+        vst1_f32(p0, vget_low_f32(v));
+        vst1_f32(p1, vget_high_f32(v));
+        vdata += 2 * vSize;
+    }
+#endif
+    for (; i < vCount; ++i) {
+        Pt *p = reinterpret_cast<Pt *>(vdata);
+        p->x += dx;
+        p->y += dy;
+        vdata += vSize;
+    }
+}
+
+void qsg_mapVertices(char *vdata, int vCount, int vSize, const QMatrix4x4 &matrix)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const float *m = matrix.constData();
+    const __m128 c0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 c1 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128 t = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    for (; i + 1 < vCount; i += 2) {
+        __m64 *p0 = reinterpret_cast<__m64 *>(vdata);
+        __m64 *p1 = reinterpret_cast<__m64 *>(vdata + vSize);
+        const __m128 v = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), p0), p1);
+        const __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, c0), _mm_mul_ps(y, c1)), t);
+        _mm_storel_pi(p0, r);
+        _mm_storeh_pi(p1, r);
+        vdata += 2 * vSize;
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const float *m = matrix.constData();
+    const float32x4_t c0 = { m[0], m[1], m[0], m[1] };
+    const float32x4_t c1 = { m[4], m[5], m[4], m[5] };
+    const float32x4_t t = { m[12], m[13], m[12], m[13] };
+    for (; i + 1 < vCount; i += 2) {
+        float *p0 = reinterpret_cast<float *>(vdata);
+        float *p1 = reinterpret_cast<float *>(vdata + vSize);
+        const float32x2_t v0 = vld1_f32(p0);
+        const float32x2_t v1 = vld1_f32(p1);
+        const float32x4_t x = vcombine_f32(vdup_lane_f32(v0, 0), vdup_lane_f32(v1, 0));
+        const float32x4_t y = vcombine_f32(vdup_lane_f32(v0, 1), vdup_lane_f32(v1, 1));
+        const float32x4_t r = vaddq_f32(vaddq_f32(vmulq_f32(x, c0), vmulq_f32(y, c1)), t);
+        vst1_f32(p0, vget_low_f32(r));
+        vst1_f32(p1, vget_high_f32(r));
+        vdata += 2 * vSize;
+    }
+#endif
+    for (; i < vCount; ++i) {
+        reinterpret_cast<Pt *>(vdata)->map(matrix);
+        vdata += vSize;
+    }
+}
+
+static void qsg_fillZOrder(float *zdata, int count, float zorder)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 z = _mm_set1_ps(zorder);
+    for (; i + 3 < count; i += 4)
+        _mm_storeu_ps(zdata + i, z);
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const float32x4_t z = vdupq_n_f32(zorder);
+    for (; i + 3 < count; i += 4)
+        vst1q_f32(zdata + i, z);
+#endif
+    for (; i < count; ++i)
+        zdata[i] = zorder;
+}
+
 /* These parameters warrant some explanation...
  *
  * vaOffset: The byte offset into the vertex data to the location of the
@@ -1872,25 +2158,13 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
 
     // apply vertex transform..
     char *vdata = *vertexData + vaOffset;
-    if (localx.flags() == QMatrix4x4::Translation) {
-        for (int i=0; i<vCount; ++i) {
-            Pt *p = (Pt *) vdata;
-            p->x += localxdata[12];
-            p->y += localxdata[13];
-            vdata += vSize;
-        }
-    } else if (localx.flags() > QMatrix4x4::Translation) {
-        for (int i=0; i<vCount; ++i) {
-            ((Pt *) vdata)->map(localx);
-            vdata += vSize;
-        }
-    }
+    if (localx.flags() == QMatrix4x4::Translation)
+        qsg_translateVertices(vdata, vCount, vSize, localxdata[12], localxdata[13]);
+    else if (localx.flags() > QMatrix4x4::Translation)
+        qsg_mapVertices(vdata, vCount, vSize, localx);
 
     if (useDepthBuffer()) {
-        float *vzorder = (float *) *zData;
-        float zorder = calculateElementZOrder(e, m_zRange);
-        for (int i=0; i<vCount; ++i)
-            vzorder[i] = zorder;
+        qsg_fillZOrder((float *) *zData, vCount, calculateElementZOrder(e, m_zRange));
         *zData += vCount * sizeof(float);
     }
 
@@ -1968,22 +2242,29 @@ QMatrix4x4 qsg_matrixForRoot(Node *node)
     return *c->matrix();
 }
 
-void Renderer::uploadBatch(Batch *b)
+/* Uploading a batch happens in three steps. prepareBatchUpload() decides how
+ * the batch is drawn and how much memory it needs, fillBatch() writes the
+ * vertex and index data into the mapped buffers and finishBatchUpload() hands
+ * the data over to QRhi. Only fillBatch() is safe to run outside of the render
+ * thread, as it touches nothing but the batch itself and its geometry.
+ */
+
+bool Renderer::prepareBatchUpload(Batch *b, quint32 *vertexBufferSize, quint32 *indexBufferSize)
 {
     // Early out if nothing has changed in this batch..
     if (!b->needsUpload) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "already uploaded...";
-        return;
+        return false;
     }
 
     if (!b->first) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "is invalid...";
-        return;
+        return false;
     }
 
     if (b->isRenderNode) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch: " << b << "is a render node...";
-        return;
+        return false;
     }
 
     // Figure out if we can merge or not, if not, then just render the batch as is..
@@ -2028,7 +2309,7 @@ void Renderer::uploadBatch(Batch *b)
     // Abort if there are no vertices in this batch.. We abort this late as
     // this is a broken usecase which we do not care to optimize for...
     if (b->vertexCount == 0 || (b->merged && b->indexCount == 0))
-        return;
+        return false;
 
     /* Allocate memory for this batch. Merged batches are divided into three separate blocks
            1. Vertex data for all elements, as they were in the QSGGeometry object, but
@@ -2052,8 +2333,14 @@ void Renderer::uploadBatch(Batch *b)
         ibufferSize = unmergedIndexSize;
     }
 
-    map(&b->ibo, ibufferSize, true);
-    map(&b->vbo, bufferSize);
+    *vertexBufferSize = bufferSize;
+    *indexBufferSize = ibufferSize;
+    return true;
+}
+
+void Renderer::fillBatch(Batch *b)
+{
+    QSGGeometry *g = b->first->node->geometry();
 
     if (Q_UNLIKELY(debug_upload())) qDebug() << " - batch" << b << " first:" << b->first << " root:"
                                              << b->root << " merged:" << b->merged << " positionAttribute" << b->positionAttribute
@@ -2066,7 +2353,6 @@ void Renderer::uploadBatch(Batch *b)
 
         quint16 iOffset16 = 0;
         quint32 iOffset32 = 0;
-        e = b->first;
         uint verticesInSet = 0;
         // Start a new set already after 65534 vertices because 0xFFFF may be
         // used for an always-on primitive restart with some apis (adapt for
@@ -2077,6 +2363,7 @@ void Renderer::uploadBatch(Batch *b)
         int drawSetIndices = 0;
         const char *indexBase = b->ibo.data;
         b->drawSets << DrawSet(0, zData - vertexData, drawSetIndices);
+        Element *e = b->first;
         while (e) {
             verticesInSet += e->node->geometry()->vertexCount();
             if (verticesInSet > verticesInSetLimit) {
@@ -2201,9 +2488,14 @@ void Renderer::uploadBatch(Batch *b)
         }
     }
 #endif // QT_NO_DEBUG_OUTPUT
+}
 
+void Renderer::finishBatchUpload(Batch *b)
+{
     unmap(&b->vbo);
     unmap(&b->ibo, true);
+    m_last_frame_upload_bytes += b->vbo.size + b->ibo.size;
+    b->zRangeInBuffer = b->merged && useDepthBuffer() ? m_zRange : -1;
 
     if (Q_UNLIKELY(debug_upload())) qDebug() << "  --- vertex/index buffers unmapped, batch upload completed...";
 
@@ -2213,6 +2505,128 @@ void Renderer::uploadBatch(Batch *b)
         b->uploadedThisFrame = true;
 }
 
+void Renderer::uploadBatch(Batch *b)
+{
+    quint32 vertexBufferSize = 0;
+    quint32 indexBufferSize = 0;
+    if (!prepareBatchUpload(b, &vertexBufferSize, &indexBufferSize))
+        return;
+
+    map(&b->ibo, indexBufferSize, true);
+    map(&b->vbo, vertexBufferSize);
+    fillBatch(b);
+    finishBatchUpload(b);
+}
+
+// Slices of the upload pools handed to different threads start on separate cache lines.
+static inline quint32 qsg_alignUploadSlice(quint32 size)
+{
+    return (size + 63) & ~quint32(63);
+}
+
+/* Uploads all opaque and alpha batches with the fillBatch() step spread over a
+ * small thread pool. Every batch gets its own slice of the upload pools, so the
+ * batches can be filled in any order, while everything touching QRhi stays on
+ * the render thread and happens in the same order as with uploadBatch().
+ * Returns false when the batches should be uploaded one by one instead.
+ */
+bool Renderer::uploadBatchesInParallel()
+{
+    if (!m_context->parallelBatchUpload()
+            || m_visualizer->mode() != Visualizer::VisualizeNothing
+            || Q_UNLIKELY(debug_upload())) {
+        return false;
+    }
+
+    int pendingCount = 0;
+    for (int i = 0; i < m_opaqueBatches.size(); ++i)
+        pendingCount += m_opaqueBatches.at(i)->needsUpload;
+    for (int i = 0; i < m_alphaBatches.size(); ++i)
+        pendingCount += m_alphaBatches.at(i)->needsUpload;
+    if (pendingCount < m_parallelUploadThreshold)
+        return false;
+
+    struct PendingUpload {
+        Batch *batch;
+        quint32 vertexOffset;
+        quint32 vertexSize;
+        quint32 indexOffset;
+        quint32 indexSize;
+    };
+    QVarLengthArray<PendingUpload, 256> pending;
+    pending.reserve(pendingCount);
+    quint32 vertexPoolSize = 0;
+    quint32 indexPoolSize = 0;
+
+    const auto prepare = [&](const QDataBuffer<Batch *> &batches) {
+        for (int i = 0; i < batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            quint32 vertexSize = 0;
+            quint32 indexSize = 0;
+            if (!prepareBatchUpload(b, &vertexSize, &indexSize))
+                continue;
+            pending.append({ b, vertexPoolSize, vertexSize, indexPoolSize, indexSize });
+            vertexPoolSize += qsg_alignUploadSlice(vertexSize);
+            indexPoolSize += qsg_alignUploadSlice(indexSize);
+        }
+    };
+    prepare(m_opaqueBatches);
+    prepare(m_alphaBatches);
+
+    // Grow the pools once, so that no slice moves while mapping the others.
+    if (vertexPoolSize > quint32(m_vertexUploadPool.size()))
+        m_vertexUploadPool.resize(vertexPoolSize);
+    if (indexPoolSize > quint32(m_indexUploadPool.size()))
+        m_indexUploadPool.resize(indexPoolSize);
+
+    for (const PendingUpload &p : pending) {
+        map(&p.batch->ibo, p.indexSize, true, p.indexOffset);
+        map(&p.batch->vbo, p.vertexSize, false, p.vertexOffset);
+    }
+
+    if (!m_uploadThreadPool) {
+        m_uploadThreadPool = new QThreadPool;
+        m_uploadThreadPool->setObjectName(QStringLiteral("QSGBatchRenderer upload"));
+        m_uploadThreadPool->setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 3));
+    }
+
+    // Split the batches into contiguous ranges of roughly the same amount of
+    // data, one for each worker and one for the render thread itself.
+    const int rangeCount = m_uploadThreadPool->maxThreadCount() + 1;
+    const quint64 totalSize = quint64(vertexPoolSize) + indexPoolSize;
+    QVarLengthArray<qsizetype, 8> rangeEnds;
+    quint64 filledSize = 0;
+    for (qsizetype i = 0; i < pending.size(); ++i) {
+        filledSize += qsg_alignUploadSlice(pending.at(i).vertexSize)
+                + qsg_alignUploadSlice(pending.at(i).indexSize);
+        if (filledSize * rangeCount >= totalSize * (rangeEnds.size() + 1) || i == pending.size() - 1)
+            rangeEnds.append(i + 1);
+    }
+
+    const auto fillRange = [this, &pending](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i)
+            fillBatch(pending.at(i).batch);
+    };
+
+    QSemaphore filledRanges;
+    for (qsizetype r = 1; r < rangeEnds.size(); ++r) {
+        const qsizetype begin = rangeEnds.at(r - 1);
+        const qsizetype end = rangeEnds.at(r);
+        m_uploadThreadPool->start([&fillRange, &filledRanges, begin, end] {
+            fillRange(begin, end);
+            filledRanges.release();
+        });
+    }
+    if (!rangeEnds.isEmpty())
+        fillRange(0, rangeEnds.first());
+    filledRanges.acquire(qMax(qsizetype(0), rangeEnds.size() - 1));
+
+    for (const PendingUpload &p : pending)
+        finishBatchUpload(p.batch);
+
+    return true;
+}
+
 void Renderer::applyClipStateToGraphicsState()
 {
     m_gstate.usesScissor = (m_currentClipState.type & ClipState::ScissorClip);
@@ -3517,6 +3931,29 @@ void Renderer::deleteRemovedElements()
     m_elementsToDelete.reset();
 }
 
+void Renderer::preprocess()
+{
+    QSGRenderer::preprocess();
+
+    // When the atlas has moved textures to another page, the nodes using them
+    // have marked their material dirty, but each was only compared against one
+    // other element of its batch, which may well have moved along with it.
+    // Check the batches as a whole, so that none ends up drawing elements from
+    // two pages with the texture of one.
+    const uint atlasGeneration = m_context->atlasGeneration();
+    if (atlasGeneration == m_atlasGeneration)
+        return;
+    m_atlasGeneration = atlasGeneration;
+
+    for (auto *batches : { &m_opaqueBatches, &m_alphaBatches }) {
+        for (int i = 0; i < batches->size(); ++i) {
+            Batch *b = batches->at(i);
+            if (b->first && !b->isRenderNode && b->hasIncompatibleMaterials())
+                invalidateBatchAndOverlappingRenderOrders(b);
+        }
+    }
+}
+
 void Renderer::render()
 {
     // Gracefully handle the lack of a render target - some autotests may rely
@@ -3565,6 +4002,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     ctx->timeUploadOpaque = 0;
     ctx->timeUploadAlpha = 0;
 
+    m_last_frame_upload_bytes = 0;
+
     if (Q_UNLIKELY(debug_render() || debug_build())) {
         QByteArray type("rebuild:");
         if (m_rebuild == 0)
@@ -3609,6 +4048,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     }
     if (Q_UNLIKELY(debug_render())) ctx->timeRenderLists = ctx->timer.restart();
 
+    splitMixedBatches();
+
     for (int i=0; i<m_opaqueBatches.size(); ++i)
         m_opaqueBatches.at(i)->cleanupRemovedElements();
     for (int i=0; i<m_alphaBatches.size(); ++i)
@@ -3664,6 +4105,28 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
                  : 0;
     }
 
+    adoptRetainedBatches();
+
+    if (Q_UNLIKELY(debug_retain())) {
+        int retainedCount = 0;
+        int reusedCount = 0;
+        int reusedVertices = 0;
+        for (const QDataBuffer<Batch *> *batches : { &m_opaqueBatches, &m_alphaBatches }) {
+            for (int i = 0; i < batches->size(); ++i) {
+                const Batch *b = batches->at(i);
+                if (!b->retained)
+                    continue;
+                ++retainedCount;
+                if (!b->needsUpload) {
+                    ++reusedCount;
+                    reusedVertices += b->vertexCount;
+                }
+            }
+        }
+        qDebug() << "Retained batches:" << retainedCount << "reused:" << reusedCount
+                 << "vertices not uploaded:" << reusedVertices;
+    }
+
     if (Q_UNLIKELY(debug_render())) ctx->timeSorting = ctx->timer.restart();
 
     // Set size to 0, nothing is deallocated, they will "grow" again
@@ -3671,19 +4134,23 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     m_vertexUploadPool.reset();
     m_indexUploadPool.reset();
 
-    if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Opaque Batches:");
-    for (int i=0; i<m_opaqueBatches.size(); ++i) {
-        Batch *b = m_opaqueBatches.at(i);
-        uploadBatch(b);
-    }
-    if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
+    if (uploadBatchesInParallel()) {
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timeUploadAlpha = ctx->timer.restart();
+    } else {
+        if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Opaque Batches:");
+        for (int i=0; i<m_opaqueBatches.size(); ++i) {
+            Batch *b = m_opaqueBatches.at(i);
+            uploadBatch(b);
+        }
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
 
-    if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Alpha Batches:");
-    for (int i=0; i<m_alphaBatches.size(); ++i) {
-        Batch *b = m_alphaBatches.at(i);
-        uploadBatch(b);
+        if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Alpha Batches:");
+        for (int i=0; i<m_alphaBatches.size(); ++i) {
+            Batch *b = m_alphaBatches.at(i);
+            uploadBatch(b);
+        }
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadAlpha = ctx->timer.restart();
     }
-    if (Q_UNLIKELY(debug_render())) ctx->timeUploadAlpha = ctx->timer.restart();
 
     if (Q_UNLIKELY(debug_render())) {
         qDebug().nospace() << "Rendering:" << Qt::endl
@@ -3773,7 +4240,10 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
         }
     }
 
+    m_last_frame_batch_count = ctx->opaqueRenderBatches.size() + ctx->alphaRenderBatches.size();
+
     m_rebuild = 0;
+    ++m_currentFrame;
 
 #if defined(QSGBATCHRENDERER_INVALIDATE_WEDGED_NODES)
     m_renderOrderRebuildLower = -1;
@@ -29,8 +29,12 @@
 
 #include <QtGui/private/qrhi_p.h>
 
+class NodesTest;
+
 QT_BEGIN_NAMESPACE
 
+class QThreadPool;
+
 namespace QSGBatchRenderer
 {
 
@@ -200,6 +204,13 @@ struct Pt {
     }
 };
 
+// Translate or map the Pt at the start of each of vCount vertices that are vSize bytes apart.
+// Used when uploading merged batches, and exported for the autotests of the SIMD versions.
+Q_QUICK_PRIVATE_EXPORT void qsg_translateVertices(char *vdata, int vCount, int vSize,
+                                                  float dx, float dy);
+Q_QUICK_PRIVATE_EXPORT void qsg_mapVertices(char *vdata, int vCount, int vSize,
+                                            const QMatrix4x4 &matrix);
+
 inline QDebug operator << (QDebug d, const Pt &p) {
     d << "Pt(" << p.x << p.y << ")";
     return d;
@@ -298,6 +309,7 @@ struct Element {
     Rect bounds; // in device coordinates
 
     int order = 0;
+    uint lastChangeFrame = 0; // last frame in which the vertex data was changed
     QRhiShaderResourceBindings *srb = nullptr;
     QRhiGraphicsPipeline *ps = nullptr;
     QRhiGraphicsPipeline *depthPostPassPs = nullptr;
@@ -404,6 +416,7 @@ struct Batch
     Batch() : drawSets(1) {}
     bool geometryWasChanged(QSGGeometryNode *gn);
     BatchCompatibility isMaterialCompatible(Element *e) const;
+    bool hasIncompatibleMaterials() const;
     void invalidate();
     void cleanupRemovedElements();
 
@@ -425,6 +438,9 @@ struct Batch
         isRenderNode = false;
         ubufDataValid = false;
         needsPurge = false;
+        retained = false;
+        parked = false;
+        zRangeInBuffer = -1;
         clipState.reset();
         blendConstant = QColor();
     }
@@ -445,11 +461,14 @@ struct Batch
     uint isRenderNode : 1;
     uint ubufDataValid : 1;
     uint needsPurge : 1;
+    uint retained : 1; // all elements are static, see Renderer::isStaticElement()
+    uint parked : 1; // invalidated, but buffers kept for Renderer::adoptRetainedBatches()
 
     mutable uint uploadedThisFrame : 1; // solely for debugging purposes
 
     Buffer vbo;
     Buffer ibo;
+    qreal zRangeInBuffer; // the z range the vertex data was generated with, -1 for no z data
     QRhiBuffer *ubuf;
     ClipState clipState;
     StencilClipState stencilClipState;
@@ -731,6 +750,7 @@ public:
 
 protected:
     void nodeChanged(QSGNode *node, QSGNode::DirtyState state) override;
+    void preprocess() override;
     void render() override;
     void prepareInline() override;
     void renderInline() override;
@@ -775,9 +795,10 @@ private:
 
     friend class Updater;
     friend class RhiVisualizer;
+    friend class ::NodesTest;
 
     void destroyGraphicsResources();
-    void map(Buffer *buffer, quint32 byteSize, bool isIndexBuf = false);
+    void map(Buffer *buffer, quint32 byteSize, bool isIndexBuf = false, quint32 poolOffset = 0);
     void unmap(Buffer *buffer, bool isIndexBuf = false);
 
     void buildRenderListsFromScratch();
@@ -792,7 +813,17 @@ private:
     void prepareAlphaBatches();
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
+    bool prepareBatchUpload(Batch *b, quint32 *vertexBufferSize, quint32 *indexBufferSize);
+    void fillBatch(Batch *b);
+    void finishBatchUpload(Batch *b);
     void uploadBatch(Batch *b);
+    bool uploadBatchesInParallel();
+
+    inline bool isStaticElement(const Element *e) const;
+    void splitMixedBatches();
+    void parkRetainedBatch(Batch *b);
+    void unparkRetainedBatches();
+    void adoptRetainedBatches();
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, void *iBasePtr, int *indexCount);
 
     bool ensurePipelineState(Element *e, const ShaderManager::Shader *sms, bool depthPostPass = false);
@@ -868,6 +899,18 @@ private:
     int m_batchNodeThreshold;
     int m_batchVertexThreshold;
     int m_srbPoolThreshold;
+    int m_parallelUploadThreshold;
+    int m_retainFrameThreshold;
+    uint m_currentFrame = 0;
+    uint m_atlasGeneration = 0;
+
+    struct RetainedBatch {
+        Batch *batch;
+        Node *root;
+        bool isOpaque;
+        QVarLengthArray<std::pair<Element *, int>, 16> elements; // with their render order
+    };
+    QHash<Element *, RetainedBatch> m_parkedBatches;
 
     Visualizer *m_visualizer;
 
@@ -879,6 +922,7 @@ private:
 
     QDataBuffer<char> m_vertexUploadPool;
     QDataBuffer<char> m_indexUploadPool;
+    QThreadPool *m_uploadThreadPool = nullptr;
 
     Allocator<Node, 256> m_nodeAllocator;
     Allocator<Element, 64> m_elementAllocator;
@@ -928,6 +972,15 @@ Batch *Renderer::newBatch()
     return b;
 }
 
+// Elements whose vertex data has not changed for a number of frames are kept
+// in batches of their own, so that they are not uploaded again together with
+// the content that keeps changing.
+bool Renderer::isStaticElement(const Element *e) const
+{
+    return m_retainFrameThreshold > 0
+            && m_currentFrame - e->lastChangeFrame >= uint(m_retainFrameThreshold);
+}
+
 int Renderer::mergedIndexElemSize() const
 {
     return m_uint32IndexForRhi ? sizeof(quint32) : sizeof(quint16);
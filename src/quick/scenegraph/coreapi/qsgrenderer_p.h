@@ -104,6 +104,11 @@ public:
         m_renderPassRecordingCallbacks.userData = userData;
     }
 
+    // Accessed by QQuickFrameStatistics after a frame has been rendered.
+    int lastFrameBatchCount() const { return m_last_frame_batch_count; }
+    qint64 lastFrameUploadBytes() const { return m_last_frame_upload_bytes; }
+    qint64 lastFramePaintedArea() const { return m_last_frame_painted_area; }
+
 protected:
     virtual void render() = 0;
 
@@ -128,6 +133,9 @@ protected:
     QRhiResourceUpdateBatch *m_current_resource_update_batch;
     QRhi *m_rhi;
     QSGRenderTarget m_rt;
+    int m_last_frame_batch_count = 0;
+    qint64 m_last_frame_upload_bytes = 0;
+    qint64 m_last_frame_painted_area = 0; // in device pixels, only tracked by the software renderer
     struct {
         QSGRenderContext::RenderPassCallback start = nullptr;
         QSGRenderContext::RenderPassCallback end = nullptr;
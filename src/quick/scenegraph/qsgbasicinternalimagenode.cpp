@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qsgbasicinternalimagenode_p.h"
+#include <private/qsgrhiatlastexture_p.h>
 
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qmath.h>
@@ -89,6 +90,10 @@ void QSGBasicInternalImageNode::setTexture(QSGTexture *texture)
 
     // Because the texture can be a different part of the atlas, we need to update it...
     m_dirtyGeometry = true;
+
+    // ...and the same goes for when the atlas is defragmented.
+    if (texture->isAtlasTexture() && QSGRhiAtlasTexture::Manager::isDefragmentationEnabled())
+        setFlag(UsePreprocess);
 }
 
 void QSGBasicInternalImageNode::setAntialiasing(bool antialiasing)
@@ -140,6 +145,12 @@ void QSGBasicInternalImageNode::preprocess()
                 m_dynamicTextureSubRect = t->normalizedTextureSubRect();
             }
         }
+    } else if (QSGTexture *texture = materialTexture(); texture && texture->isAtlasTexture()) {
+        // Moved to another atlas page since the geometry was built.
+        if (texture->normalizedTextureSubRect() != m_atlasTextureSubRect && !m_targetRect.isEmpty()) {
+            updateGeometry();
+            doDirty = true;
+        }
     }
     m_dynamicTexture = t;
 
@@ -472,6 +483,7 @@ void QSGBasicInternalImageNode::updateGeometry()
         memset(g->vertexData(), 0, g->sizeOfVertex() * 4);
     } else {
         QRectF sourceRect = t->normalizedTextureSubRect();
+        m_atlasTextureSubRect = sourceRect;
 
         QRectF innerSourceRect(sourceRect.x() + m_innerSourceRect.x() * sourceRect.width(),
                                sourceRect.y() + m_innerSourceRect.y() * sourceRect.height(),
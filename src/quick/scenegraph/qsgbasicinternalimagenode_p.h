@@ -68,6 +68,7 @@ protected:
     QSGDynamicTexture *m_dynamicTexture;
     QSize m_dynamicTextureSize;
     QRectF m_dynamicTextureSubRect;
+    QRectF m_atlasTextureSubRect;
 };
 
 QT_END_NAMESPACE
@@ -101,8 +101,12 @@ public:
 
     virtual bool isVSyncDependent() const = 0;
 
+    // Consumed by the next advance().
+    void setPresentDelay(qint64 nsecs) { m_presentDelay = nsecs; }
+
 protected:
     float m_vsync = 0;
+    qint64 m_presentDelay = -1;
 };
 
 // default as in default for the threaded render loop
@@ -143,6 +147,8 @@ public:
         m_time = 0;
         m_timer.start();
         m_wallTime.restart();
+        m_presentClock.start();
+        m_lastPresentTime = -1;
         QAnimationDriver::start();
     }
 
@@ -157,6 +163,24 @@ public:
     {
         qint64 delta = m_timer.restart();
 
+        if (m_mode == VSyncMode && m_presentDelay >= 0) {
+            // With frame pacing, advance by the time between the predicted
+            // presents instead, so that a frame that is going to miss a vsync
+            // shows the animations where they should be by the time it is on
+            // screen. The lag heuristics below do not apply then.
+            const qint64 presentTime = m_presentClock.nsecsElapsed() + m_presentDelay;
+            if (m_lastPresentTime >= 0)
+                m_time += qMax(qint64(0), presentTime - m_lastPresentTime) / 1000000.0;
+            else
+                m_time += m_vsync;
+            m_lastPresentTime = presentTime;
+            m_presentDelay = -1;
+            advanceAnimation();
+            return;
+        }
+        m_presentDelay = -1;
+        m_lastPresentTime = -1;
+
         if (m_mode == VSyncMode) {
             // If a frame is skipped, either because rendering was slow or because
             // the QML was slow, we accept it and continue advancing with a single
@@ -222,6 +246,8 @@ public:
     Mode m_mode;
     QElapsedTimer m_timer;
     QElapsedTimer m_wallTime;
+    QElapsedTimer m_presentClock;
+    qint64 m_lastPresentTime = -1;
     float m_lag;
     int m_bad;
     int m_good;
@@ -377,6 +403,16 @@ bool QSGContext::isVSyncDependent(QAnimationDriver *driver)
     return static_cast<QSGAnimationDriver *>(driver)->isVSyncDependent();
 }
 
+/*!
+    Tells the \a driver that was created by createAnimationDriver() that the
+    frame its next advance is for is expected to be presented \a nsecs
+    nanoseconds from now.
+ */
+void QSGContext::setAnimationDriverPresentDelay(QAnimationDriver *driver, qint64 nsecs)
+{
+    static_cast<QSGAnimationDriver *>(driver)->setPresentDelay(nsecs);
+}
+
 QSize QSGContext::minimumFBOSize() const
 {
     return QSize(1, 1);
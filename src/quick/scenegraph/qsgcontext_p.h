@@ -102,6 +102,7 @@ public:
     virtual QAnimationDriver *createAnimationDriver(QObject *parent);
     virtual float vsyncIntervalForAnimationDriver(QAnimationDriver *driver);
     virtual bool isVSyncDependent(QAnimationDriver *driver);
+    virtual void setAnimationDriverPresentDelay(QAnimationDriver *driver, qint64 nsecs);
 
     virtual QSize minimumFBOSize() const;
     virtual QSurfaceFormat defaultSurfaceFormat() const = 0;
@@ -26,6 +26,7 @@ QSGDefaultRenderContext::QSGDefaultRenderContext(QSGContext *context)
     , m_currentFrameCommandBuffer(nullptr)
     , m_currentFrameRenderPass(nullptr)
     , m_useDepthBufferFor2D(true)
+    , m_parallelBatchUpload(false)
     , m_glyphCacheResourceUpdates(nullptr)
 {
 }
@@ -135,6 +136,7 @@ void QSGDefaultRenderContext::prepareSync(qreal devicePixelRatio,
 {
     m_currentDevicePixelRatio = devicePixelRatio;
     m_useDepthBufferFor2D = config.isDepthBufferEnabledFor2D();
+    m_parallelBatchUpload = config.isParallelBatchUploadEnabled();
 
     // we store the command buffer already here, in case there is something in
     // an updatePaintNode() implementation that leads to needing it (for
@@ -152,6 +154,9 @@ void QSGDefaultRenderContext::beginNextFrame(QSGRenderer *renderer, const QSGRen
 
     m_currentFrameCommandBuffer = renderTarget.cb; // usually the same as what was passed to prepareSync() but cannot count on that having been called
     m_currentFrameRenderPass = renderTarget.rpDesc;
+
+    if (m_rhiAtlasManager && m_currentFrameCommandBuffer)
+        m_rhiAtlasManager->beginFrame();
 }
 
 void QSGDefaultRenderContext::renderNextFrame(QSGRenderer *renderer)
@@ -166,6 +171,15 @@ void QSGDefaultRenderContext::endNextFrame(QSGRenderer *renderer)
     m_currentFrameRenderPass = nullptr;
 }
 
+/*
+    Returns a value that changes whenever atlas textures have moved to another
+    atlas page, which changes what they compare equal to.
+ */
+uint QSGDefaultRenderContext::atlasGeneration() const
+{
+    return m_rhiAtlasManager ? m_rhiAtlasManager->generation() : 0;
+}
+
 QSGTexture *QSGDefaultRenderContext::createTexture(const QImage &image, uint flags) const
 {
     bool atlas = flags & CreateTexture_Atlas;
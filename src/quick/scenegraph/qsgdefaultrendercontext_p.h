@@ -79,6 +79,8 @@ public:
 
     int maxTextureSize() const override { return m_maxTextureSize; }
     bool useDepthBufferFor2D() const { return m_useDepthBufferFor2D; }
+    bool parallelBatchUpload() const { return m_parallelBatchUpload; }
+    uint atlasGeneration() const;
     int msaaSampleCount() const { return m_initParams.sampleCount; }
 
     QRhiCommandBuffer *currentFrameCommandBuffer() const {
@@ -117,6 +119,7 @@ protected:
     QRhiRenderPassDescriptor *m_currentFrameRenderPass;
     qreal m_currentDevicePixelRatio;
     bool m_useDepthBufferFor2D;
+    bool m_parallelBatchUpload;
     QRhiResourceUpdateBatch *m_glyphCacheResourceUpdates;
     QSet<QRhiTexture *> m_pendingGlyphCacheTextures;
 };
@@ -0,0 +1,226 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qsgframepacer_p.h"
+
+#include <private/qqmlglobal_p.h>
+#include <private/qsgcontext_p.h>
+
+#include <QtCore/qelapsedtimer.h>
+
+QT_BEGIN_NAMESPACE
+
+DEFINE_BOOL_CONFIG_OPTION(qsgEnableFramePacing, QSG_FRAME_PACING)
+
+// Frames after which the prediction error is summarized in the log.
+static const int statisticsInterval = 300;
+
+/*
+    QSGFramePacer predicts when the frame that is about to be prepared will
+    reach the screen, so that animations can be advanced to that point in time
+    rather than by a fixed vsync step per frame.
+
+    Presents land on a vsync grid, anchored at the most recent present. The
+    frame is ready once polishing, and the previous frame if it is still being
+    rendered, and then its own synchronization and rendering are done; it is
+    predicted to be presented at the first vsync after that.
+
+    The thread preparing frames calls predict() before polishing, to find out
+    whether the frame is worth preparing now, and commits a prediction when it
+    advances animations for the next frame. The thread rendering them brackets
+    each frame with beginFrame() and endFrame(), which measures the frame cost
+    and compares the actual present time with the prediction that frame was
+    prepared with.
+
+    The frames are measured also when frame pacing is not enabled, as the
+    incubation controller of the window sizes its time slices after the frame
+    budget that remains.
+
+    The times are taken from a monotonic clock by default. Tests can pass a
+    clock of their own.
+ */
+QSGFramePacer::QSGFramePacer()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_clock = [timer]() { return timer.nsecsElapsed(); };
+}
+
+QSGFramePacer::QSGFramePacer(Clock clock)
+    : m_clock(std::move(clock))
+{
+}
+
+bool QSGFramePacer::isEnabled()
+{
+    return qsgEnableFramePacing();
+}
+
+void QSGFramePacer::setVSyncInterval(qint64 interval)
+{
+    QMutexLocker locker(&m_mutex);
+    if (interval > 0)
+        m_vsyncInterval = interval;
+}
+
+qint64 QSGFramePacer::vsyncInterval() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_vsyncInterval;
+}
+
+qint64 QSGFramePacer::expectedFrameCost() const
+{
+    // A single slow frame should not make every following frame look like it
+    // is going to miss, but a lasting increase should show up right away.
+    const int count = qMin(m_presentCount, int(HistorySize));
+    if (count == 0)
+        return 0;
+    qint64 sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += m_frameCosts[i];
+    const qint64 latest = m_frameCosts[(m_presentCount - 1) % HistorySize];
+    return qMax(sum / count, latest);
+}
+
+QSGFramePacer::Prediction QSGFramePacer::predict() const
+{
+    QMutexLocker locker(&m_mutex);
+    Prediction prediction;
+    if (m_presentCount == 0)
+        return prediction;
+
+    const qint64 now = m_clock();
+    const qint64 lastPresent = m_presentTimes[(m_presentCount - 1) % HistorySize];
+    const qint64 cost = expectedFrameCost();
+
+    prediction.frameInFlight = m_frameStart >= 0;
+    prediction.nextVSync = lastPresent + ((now - lastPresent) / m_vsyncInterval + 1) * m_vsyncInterval;
+
+    qint64 ready = now + m_polishTime;
+    if (prediction.frameInFlight)
+        ready = qMax(ready, m_frameStart + cost);
+    ready += cost;
+
+    const qint64 vsyncs = qMax(qint64(1), (ready - lastPresent + m_vsyncInterval - 1) / m_vsyncInterval);
+    prediction.presentTime = qMax(prediction.nextVSync, lastPresent + vsyncs * m_vsyncInterval);
+    return prediction;
+}
+
+/*
+    Marks \a prediction as the one the next frame is prepared with, typically
+    because animations were advanced to its present time. The next frame
+    rendered is then measured against it.
+ */
+void QSGFramePacer::commitPrediction(const Prediction &prediction)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingPrediction = prediction.presentTime;
+}
+
+void QSGFramePacer::recordPolish(qint64 polishTime)
+{
+    QMutexLocker locker(&m_mutex);
+    // Smoothed, polishing tends to vary more from frame to frame than rendering.
+    m_polishTime = (3 * m_polishTime + polishTime) / 4;
+}
+
+void QSGFramePacer::recordDroppedFrame()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_statistics.droppedCount;
+}
+
+QSGFramePacer::Statistics QSGFramePacer::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+/*
+    Returns how much time, in nanoseconds, the thread preparing frames can spend
+    on other work before it has to start polishing the next frame, or -1 when no
+    frame has been presented yet.
+
+    If a frame is being rendered, the render thread takes the next one once it
+    has presented the current one, at the first vsync after it is done. If not,
+    the next frame has to be rendered in time for the next vsync.
+ */
+qint64 QSGFramePacer::remainingFrameBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_presentCount == 0)
+        return -1;
+
+    const qint64 now = m_clock();
+    const qint64 lastPresent = m_presentTimes[(m_presentCount - 1) % HistorySize];
+    const qint64 cost = expectedFrameCost();
+
+    qint64 syncBy;
+    if (m_frameStart >= 0) {
+        const qint64 done = qMax(now, m_frameStart + cost);
+        syncBy = lastPresent + qMax(qint64(1), (done - lastPresent + m_vsyncInterval - 1) / m_vsyncInterval) * m_vsyncInterval;
+    } else {
+        syncBy = lastPresent + ((now - lastPresent) / m_vsyncInterval + 1) * m_vsyncInterval - cost;
+    }
+
+    return qMax(qint64(0), syncBy - now - m_polishTime);
+}
+
+void QSGFramePacer::beginFrame()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frameStart = m_clock();
+    m_inFlightPrediction = m_pendingPrediction;
+    m_pendingPrediction = -1;
+}
+
+// The frame was not presented after all.
+void QSGFramePacer::cancelFrame()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frameStart = -1;
+    m_inFlightPrediction = -1;
+}
+
+/*
+    Returns how much later than predicted the frame was presented, in
+    nanoseconds, or 0 when there was no prediction for it. \a swapTime is the
+    time spent presenting, which may include waiting for vsync and so does not
+    count towards the frame cost.
+ */
+qint64 QSGFramePacer::endFrame(qint64 swapTime)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_frameStart < 0)
+        return 0;
+
+    const qint64 now = m_clock();
+    const int index = m_presentCount % HistorySize;
+    m_presentTimes[index] = now;
+    m_frameCosts[index] = qMax(qint64(0), now - m_frameStart - swapTime);
+    ++m_presentCount;
+    m_frameStart = -1;
+
+    qint64 error = 0;
+    if (m_inFlightPrediction >= 0) {
+        error = now - m_inFlightPrediction;
+        m_statistics.errorSum += qAbs(error);
+        ++m_statistics.errorCount;
+        // Later than half a vsync means it went to screen a vsync later.
+        if (error > m_vsyncInterval / 2)
+            ++m_statistics.lateCount;
+        m_inFlightPrediction = -1;
+    }
+
+    if (m_statistics.errorCount >= statisticsInterval) {
+        qCDebug(QSG_LOG_TIME_RENDERLOOP, "frame pacing: mean present error %.2f ms, %d of %d frames late, %d dropped",
+                m_statistics.errorSum / qreal(m_statistics.errorCount) / 1000000.0,
+                m_statistics.lateCount, m_statistics.errorCount, m_statistics.droppedCount);
+        m_statistics = Statistics();
+    }
+
+    return error;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,99 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSGFRAMEPACER_P_H
+#define QSGFRAMEPACER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+#include <QtCore/qmutex.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK_PRIVATE_EXPORT QSGFramePacer
+{
+public:
+    struct Prediction
+    {
+        qint64 presentTime = -1; // on the pacer's clock, in nanoseconds
+        qint64 nextVSync = -1;
+        bool frameInFlight = false;
+
+        bool isValid() const { return presentTime >= 0; }
+        // The frame will not make it to the screen at the next vsync.
+        bool willMiss() const { return presentTime > nextVSync; }
+    };
+
+    // Returns the current time in nanoseconds.
+    using Clock = std::function<qint64()>;
+
+    struct Statistics
+    {
+        qint64 errorSum = 0; // absolute present errors, in nanoseconds
+        int errorCount = 0;
+        int lateCount = 0;
+        int droppedCount = 0;
+    };
+
+    QSGFramePacer();
+    explicit QSGFramePacer(Clock clock);
+
+    static bool isEnabled();
+
+    void setVSyncInterval(qint64 interval);
+    qint64 vsyncInterval() const;
+
+    // Called by the thread that prepares the frames.
+    Prediction predict() const;
+    void commitPrediction(const Prediction &prediction);
+    void recordPolish(qint64 polishTime);
+    void recordDroppedFrame();
+    qint64 remainingFrameBudget() const;
+
+    // Called by the thread that renders the frame.
+    void beginFrame();
+    qint64 endFrame(qint64 swapTime);
+    void cancelFrame();
+
+    // Since the statistics were last logged.
+    Statistics statistics() const;
+
+    qint64 now() const { return m_clock(); }
+
+private:
+    static const int HistorySize = 8;
+
+    qint64 expectedFrameCost() const;
+
+    mutable QMutex m_mutex;
+    Clock m_clock;
+
+    qint64 m_vsyncInterval = 16666667;
+    qint64 m_presentTimes[HistorySize] = {};
+    qint64 m_frameCosts[HistorySize] = {};
+    int m_presentCount = 0;
+    qint64 m_polishTime = 0;
+
+    qint64 m_frameStart = -1;
+    qint64 m_pendingPrediction = -1;
+    qint64 m_inFlightPrediction = -1;
+
+    // Logged periodically with qt.scenegraph.time.renderloop.
+    Statistics m_statistics;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGFRAMEPACER_P_H
@@ -21,6 +21,7 @@
 #include <QtQuick/QQuickWindow>
 #include <QtQuick/private/qquickwindow_p.h>
 #include <QtQuick/private/qquickitem_p.h>
+#include <QtQuick/private/qquickframestatistics_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
 #include <QtQuick/private/qsgrenderer_p.h>
 #include <private/qquickprofiler_p.h>
@@ -577,8 +578,8 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     QElapsedTimer renderTimer;
     qint64 renderTime = 0, syncTime = 0, polishTime = 0;
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
-    if (profileFrames)
-        renderTimer.start();
+    // Always timed, QQuickWindow::frameStatistics() reports the phases of every frame.
+    renderTimer.start();
     Q_TRACE(QSG_polishItems_entry);
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishFrame);
 
@@ -586,8 +587,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     cd->polishItems();
     m_inPolish = false;
 
-    if (profileFrames)
-        polishTime = renderTimer.nsecsElapsed();
+    polishTime = renderTimer.nsecsElapsed();
 
     Q_TRACE(QSG_polishItems_exit);
     Q_QUICK_SG_PROFILE_SWITCH(QQuickProfiler::SceneGraphPolishFrame,
@@ -653,8 +653,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     if (lastDirtyWindow)
         data.rc->endSync();
 
-    if (profileFrames)
-        syncTime = renderTimer.nsecsElapsed();
+    syncTime = renderTimer.nsecsElapsed();
 
     Q_TRACE(QSG_sync_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -663,8 +662,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
 
     cd->renderSceneGraph();
 
-    if (profileFrames)
-        renderTime = renderTimer.nsecsElapsed();
+    renderTime = renderTimer.nsecsElapsed();
     Q_TRACE(QSG_render_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopRender);
@@ -690,9 +688,12 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
 
     emit window->afterFrameEnd();
 
-    qint64 swapTime = 0;
-    if (profileFrames)
-        swapTime = renderTimer.nsecsElapsed();
+    const qint64 swapTime = renderTimer.nsecsElapsed();
+
+    QQuickFrameStatisticsPrivate *frameStatistics = QQuickFrameStatisticsPrivate::get(cd->frameStatistics);
+    frameStatistics->recordPolish(polishTime);
+    frameStatistics->recordFrame(syncTime - polishTime, renderTime - syncTime, swapTime - renderTime,
+                                 cd->renderer);
 
     Q_TRACE(QSG_swap_exit);
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -73,6 +73,9 @@ public:
     static void setInstance(QSGRenderLoop *instance);
 
     virtual bool interleaveIncubation() const { return false; }
+    // Nanoseconds the GUI thread can spend before it has to prepare the next
+    // frame of the window, or -1 if the render loop does not know.
+    virtual qint64 remainingFrameBudget(QQuickWindow *window) { Q_UNUSED(window); return -1; }
 
     virtual int flags() const { return 0; }
 
@@ -18,11 +18,13 @@
 #include <QtQuick/QQuickWindow>
 #include <private/qquickwindow_p.h>
 #include <private/qquickitem_p.h>
+#include <private/qquickframestatistics_p.h>
 
 #include <QtQuick/private/qsgrenderer_p.h>
 
 #include "qsgthreadedrenderloop_p.h"
 #include "qsgrhisupport_p.h"
+#include "qsgframepacer_p.h"
 #include <private/qquickanimatorcontroller_p.h>
 
 #include <private/qquickprofiler_p.h>
@@ -300,6 +302,7 @@ public:
     QWaitCondition waitCondition;
 
     QElapsedTimer m_threadTimeBetweenRenders;
+    QSGFramePacer framePacer;
 
     QQuickWindow *window; // Will be 0 when window is not exposed
     QSize windowSize;
@@ -596,8 +599,8 @@ void QSGRenderThread::syncAndRender()
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
     QElapsedTimer threadTimer;
     qint64 syncTime = 0, renderTime = 0;
-    if (profileFrames)
-        threadTimer.start();
+    // Always timed, QQuickWindow::frameStatistics() reports the phases of every frame.
+    threadTimer.start();
     Q_TRACE_SCOPE(QSG_syncAndRender);
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphRenderLoopFrame);
     Q_TRACE(QSG_sync_entry);
@@ -683,13 +686,15 @@ void QSGRenderThread::syncAndRender()
         }
     }
 
+    const bool pacing = QSGFramePacer::isEnabled();
+    framePacer.beginFrame();
+
     if (syncRequested) {
         qCDebug(QSG_LOG_RENDERLOOP, QSG_RT_PAD, "- updatePending, doing sync");
         sync(exposeRequested);
     }
 #ifndef QSG_NO_RENDER_TIMING
-    if (profileFrames)
-        syncTime = threadTimer.nsecsElapsed();
+    syncTime = threadTimer.nsecsElapsed();
 #endif
     Q_TRACE(QSG_sync_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -733,8 +738,7 @@ void QSGRenderThread::syncAndRender()
 
         d->renderSceneGraph();
 
-        if (profileFrames)
-            renderTime = threadTimer.nsecsElapsed();
+        renderTime = threadTimer.nsecsElapsed();
         Q_TRACE(QSG_render_exit);
         Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                                   QQuickProfiler::SceneGraphRenderLoopRender);
@@ -751,12 +755,21 @@ void QSGRenderThread::syncAndRender()
         }
         lastCompletedGpuTime = cd->swapchain->currentFrameCommandBuffer()->lastCompletedGpuTime();
         d->fireFrameSwapped();
+
+        QQuickFrameStatisticsPrivate *statistics = QQuickFrameStatisticsPrivate::get(d->frameStatistics);
+        const qint64 presentError = framePacer.endFrame(threadTimer.nsecsElapsed() - renderTime);
+        if (pacing)
+            statistics->recordPresentError(presentError);
+        // The polish time was recorded by polishAndSync() on the GUI thread.
+        statistics->recordFrame(
+                syncTime, renderTime - syncTime, threadTimer.nsecsElapsed() - renderTime, d->renderer);
     } else {
         Q_TRACE(QSG_render_exit);
         Q_QUICK_SG_PROFILE_SKIP(QQuickProfiler::SceneGraphRenderLoopFrame,
                                 QQuickProfiler::SceneGraphRenderLoopSync, 1);
         Q_TRACE(QSG_swap_entry);
         qCDebug(QSG_LOG_RENDERLOOP, QSG_RT_PAD, "- window not ready, skipping render");
+        framePacer.cancelFrame();
         // Make sure a beginFrame() always gets an endFrame(). We could have
         // started a frame but then not have a valid renderer (if there was no
         // sync). So gracefully handle that.
@@ -1030,6 +1043,14 @@ bool QSGThreadedRenderLoop::interleaveIncubation() const
     return m_animation_driver->isRunning() && anyoneShowing();
 }
 
+qint64 QSGThreadedRenderLoop::remainingFrameBudget(QQuickWindow *window)
+{
+    const Window *w = windowFor(window);
+    if (!w || !w->thread)
+        return -1;
+    return w->thread->framePacer.remainingFrameBudget();
+}
+
 void QSGThreadedRenderLoop::animationStarted()
 {
     qCDebug(QSG_LOG_RENDERLOOP, "- animationStarted()");
@@ -1244,6 +1265,7 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
         win.updateDuringSync = false;
         win.forceRenderPass = true; // also covered by polishAndSync(inExpose=true), but doesn't hurt
         win.badVSync = false;
+        win.droppedLastFrame = false;
         win.timeBetweenPolishAndSyncs.start();
         win.psTimeAccumulator = 0.0f;
         win.psTimeSampleCount = 0;
@@ -1572,9 +1594,31 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
         }
     }
 
+    // With frame pacing, a frame that cannot make the next vsync because the
+    // previous one is still being rendered is not prepared now. Polishing it
+    // would only hold up the GUI thread; instead it is prepared on the next
+    // update, with more up to date input and animations. Never drop two in a
+    // row, and never drop frames that must be rendered.
+    const bool pacing = QSGFramePacer::isEnabled();
+    w->thread->framePacer.setVSyncInterval(
+            qint64(sg->vsyncIntervalForAnimationDriver(m_animation_driver) * 1000000));
+    if (pacing) {
+        QSGFramePacer &pacer(w->thread->framePacer);
+        const QSGFramePacer::Prediction prediction = pacer.predict();
+        if (!inExpose && !w->forceRenderPass && !w->droppedLastFrame
+                && prediction.isValid() && prediction.frameInFlight && prediction.willMiss()) {
+            qCDebug(QSG_LOG_RENDERLOOP, "- frame would miss its vsync, dropped");
+            pacer.recordDroppedFrame();
+            w->droppedLastFrame = true;
+            postUpdateRequest(w);
+            return;
+        }
+        w->droppedLastFrame = false;
+    }
+
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
+    timer.start();
     if (profileFrames) {
-        timer.start();
         qCDebug(QSG_LOG_TIME_RENDERLOOP, "[window %p][gui thread] polishAndSync: start, elapsed since last call: %d ms",
                 window,
                 int(elapsedSinceLastMs));
@@ -1587,8 +1631,11 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     d->polishItems();
     m_inPolish = false;
 
-    if (profileFrames)
-        polishTime = timer.nsecsElapsed();
+    polishTime = timer.nsecsElapsed();
+    // Recorded before the sync is requested so that the render thread attributes it to the
+    // frame it is about to render.
+    QQuickFrameStatisticsPrivate::get(d->frameStatistics)->recordPolish(polishTime);
+    w->thread->framePacer.recordPolish(polishTime);
     Q_TRACE(QSG_polishItems_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphPolishAndSync,
                               QQuickProfiler::SceneGraphPolishAndSyncPolish);
@@ -1636,6 +1683,16 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     // just advance here)
     if (m_animation_timer == 0 && m_animation_driver->isRunning()) {
         qCDebug(QSG_LOG_RENDERLOOP, "- advancing animations");
+        if (pacing) {
+            // Advance to when the next frame is expected on screen, the one
+            // just synced is being rendered by now.
+            QSGFramePacer &pacer(w->thread->framePacer);
+            const QSGFramePacer::Prediction prediction = pacer.predict();
+            if (prediction.isValid()) {
+                pacer.commitPrediction(prediction);
+                sg->setAnimationDriverPresentDelay(m_animation_driver, prediction.presentTime - pacer.now());
+            }
+        }
         m_animation_driver->advance();
         qCDebug(QSG_LOG_RENDERLOOP, "- animations done..");
 
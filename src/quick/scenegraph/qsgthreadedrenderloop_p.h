@@ -56,6 +56,7 @@ public:
     void postJob(QQuickWindow *window, QRunnable *job) override;
 
     bool interleaveIncubation() const override;
+    qint64 remainingFrameBudget(QQuickWindow *window) override;
 
 public Q_SLOTS:
     void animationStarted();
@@ -72,6 +73,7 @@ private:
         uint updateDuringSync : 1;
         uint forceRenderPass : 1;
         uint badVSync : 1;
+        uint droppedLastFrame : 1;
     };
 
     friend class QSGRenderThread;
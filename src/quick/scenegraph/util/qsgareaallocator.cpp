@@ -56,9 +56,54 @@ bool QSGAreaAllocatorNode::isLeaf()
 }
 
 
-QSGAreaAllocator::QSGAreaAllocator(const QSize &size) : m_size(size)
+template <typename Function>
+static void forEachLeaf(const QSGAreaAllocatorNode *root, const QSize &size, Function function)
+{
+    struct Entry { const QSGAreaAllocatorNode *node; QRect rect; };
+    QVarLengthArray<Entry, 64> entries;
+    entries.append({ root, QRect(QPoint(0, 0), size) });
+    while (!entries.isEmpty()) {
+        const Entry entry = entries.takeLast();
+        const QSGAreaAllocatorNode *node = entry.node;
+        if (!node->left) {
+            function(node, entry.rect);
+            continue;
+        }
+        QRect leftRect = entry.rect;
+        QRect rightRect = entry.rect;
+        if (node->splitType == HorizontalSplit) {
+            leftRect.setHeight(node->split - leftRect.top());
+            rightRect.setTop(node->split);
+        } else {
+            leftRect.setWidth(node->split - leftRect.left());
+            rightRect.setLeft(node->split);
+        }
+        entries.append({ node->left, leftRect });
+        entries.append({ node->right, rightRect });
+    }
+}
+
+/*
+    QSGAreaAllocator hands out non-overlapping rectangles of a fixed size area.
+
+    The BinaryTree strategy splits the area recursively and merges free
+    neighbours again on deallocation. It is quick, but once the area has been
+    split for a mix of sizes, free space tends to end up in slivers that fit
+    nothing.
+
+    The Skyline strategy places each rectangle bottom-left on top of the
+    outline of what has been allocated so far, and keeps the holes that
+    remain below that outline, from deallocations or from placing a rectangle
+    over an uneven outline, in a free list that is searched first. This packs
+    mixed sizes noticeably tighter.
+*/
+QSGAreaAllocator::QSGAreaAllocator(const QSize &size, Strategy strategy)
+    : m_size(size)
+    , m_strategy(strategy)
 {
     m_root = new QSGAreaAllocatorNode(nullptr);
+    if (m_strategy == Skyline)
+        m_skyline.append({ 0, 0, m_size.width() });
 }
 
 QSGAreaAllocator::~QSGAreaAllocator()
@@ -68,6 +113,18 @@ QSGAreaAllocator::~QSGAreaAllocator()
 
 QRect QSGAreaAllocator::allocate(const QSize &size)
 {
+    if (size.isEmpty())
+        return QRect();
+
+    if (m_strategy == Skyline) {
+        QRect rect = allocateInFreeRects(size);
+        if (!rect.isValid())
+            rect = allocateInSkyline(size);
+        if (rect.isValid())
+            m_usedArea += qint64(size.width()) * size.height();
+        return rect;
+    }
+
     QPoint point;
     bool result = allocateInNode(size, point, QRect(QPoint(0, 0), m_size), m_root);
     return result ? QRect(point, size) : QRect();
@@ -75,9 +132,234 @@ QRect QSGAreaAllocator::allocate(const QSize &size)
 
 bool QSGAreaAllocator::deallocate(const QRect &rect)
 {
+    if (m_strategy == Skyline) {
+        if (rect.isEmpty())
+            return false;
+        m_usedArea -= qint64(rect.width()) * rect.height();
+        if (m_usedArea == 0) {
+            // Start over rather than piecing the outline back together.
+            m_freeRects.clear();
+            m_skyline = { { 0, 0, m_size.width() } };
+        } else {
+            addFreeRect(rect);
+            lowerSkyline();
+        }
+        return true;
+    }
+
     return deallocateInNode(rect.topLeft(), m_root);
 }
 
+qint64 QSGAreaAllocator::largestFreeArea() const
+{
+    qint64 largest = 0;
+
+    if (m_strategy == Skyline) {
+        for (const QRect &r : m_freeRects)
+            largest = qMax(largest, qint64(r.width()) * r.height());
+        // The largest rectangle above the outline spans a run of segments and
+        // is as tall as the space above the highest of them.
+        for (int i = 0; i < m_skyline.size(); ++i) {
+            int top = 0;
+            for (int j = i; j < m_skyline.size(); ++j) {
+                top = qMax(top, m_skyline.at(j).y);
+                const int width = m_skyline.at(j).x + m_skyline.at(j).width - m_skyline.at(i).x;
+                largest = qMax(largest, qint64(width) * (m_size.height() - top));
+            }
+        }
+        return largest;
+    }
+
+    forEachLeaf(m_root, m_size, [&largest](const QSGAreaAllocatorNode *node, const QRect &rect) {
+        if (!node->isOccupied)
+            largest = qMax(largest, qint64(rect.width()) * rect.height());
+    });
+    return largest;
+}
+
+QRect QSGAreaAllocator::allocateInFreeRects(const QSize &size)
+{
+    // Best fit by area, so that large holes stay available for large requests.
+    int best = -1;
+    qint64 bestArea = 0;
+    for (int i = 0; i < m_freeRects.size(); ++i) {
+        const QRect &r = m_freeRects.at(i);
+        if (r.width() < size.width() || r.height() < size.height())
+            continue;
+        const qint64 area = qint64(r.width()) * r.height();
+        if (best < 0 || area < bestArea) {
+            best = i;
+            bestArea = area;
+        }
+    }
+    if (best < 0)
+        return QRect();
+
+    const QRect hole = m_freeRects.takeAt(best);
+    const QRect result(hole.topLeft(), size);
+
+    // Split the rest of the hole along the shorter leftover edge, which keeps
+    // the larger of the two remainders as square as possible.
+    const int restWidth = hole.width() - size.width();
+    const int restHeight = hole.height() - size.height();
+    QRect right;
+    QRect bottom;
+    if (restWidth > restHeight) {
+        right = QRect(hole.left() + size.width(), hole.top(), restWidth, hole.height());
+        bottom = QRect(hole.left(), hole.top() + size.height(), size.width(), restHeight);
+    } else {
+        right = QRect(hole.left() + size.width(), hole.top(), restWidth, size.height());
+        bottom = QRect(hole.left(), hole.top() + size.height(), hole.width(), restHeight);
+    }
+    if (!right.isEmpty())
+        m_freeRects.append(right);
+    if (!bottom.isEmpty())
+        m_freeRects.append(bottom);
+    return result;
+}
+
+QRect QSGAreaAllocator::allocateInSkyline(const QSize &size)
+{
+    int bestIndex = -1;
+    int bestTop = 0;
+    int bestWidth = 0;
+
+    for (int i = 0; i < m_skyline.size(); ++i) {
+        const int x = m_skyline.at(i).x;
+        if (x + size.width() > m_size.width())
+            break;
+        int top = 0;
+        int remaining = size.width();
+        for (int j = i; remaining > 0; ++j) {
+            top = qMax(top, m_skyline.at(j).y);
+            remaining -= m_skyline.at(j).width;
+        }
+        if (top + size.height() > m_size.height())
+            continue;
+        // Lowest placement first, then the narrowest segment to waste less.
+        if (bestIndex < 0 || top < bestTop
+                || (top == bestTop && m_skyline.at(i).width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = m_skyline.at(i).width;
+        }
+    }
+    if (bestIndex < 0)
+        return QRect();
+
+    const QRect result(m_skyline.at(bestIndex).x, bestTop, size.width(), size.height());
+
+    // Everything below the new rectangle that is not yet allocated becomes a hole.
+    int i = bestIndex;
+    while (i < m_skyline.size() && m_skyline.at(i).x < result.right() + 1) {
+        SkylineSegment &segment = m_skyline[i];
+        const int end = segment.x + segment.width;
+        const int coveredEnd = qMin(end, result.right() + 1);
+        if (segment.y < bestTop)
+            m_freeRects.append(QRect(segment.x, segment.y, coveredEnd - segment.x, bestTop - segment.y));
+        if (end > coveredEnd) {
+            segment.width = end - coveredEnd;
+            segment.x = coveredEnd;
+            break;
+        }
+        m_skyline.removeAt(i);
+    }
+    m_skyline.insert(bestIndex, { result.x(), result.bottom() + 1, result.width() });
+
+    // Merge neighbours at the same height.
+    for (int j = qMax(0, bestIndex - 1); j + 1 < m_skyline.size() && j <= bestIndex;) {
+        if (m_skyline.at(j).y == m_skyline.at(j + 1).y) {
+            m_skyline[j].width += m_skyline.at(j + 1).width;
+            m_skyline.removeAt(j + 1);
+            --bestIndex;
+        } else {
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+void QSGAreaAllocator::addFreeRect(const QRect &rect)
+{
+    QRect merged = rect;
+    // Join holes that share a full edge, so that space freed piece by piece
+    // can be reused for something larger.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < m_freeRects.size(); ++i) {
+            const QRect &r = m_freeRects.at(i);
+            const bool sameColumn = r.left() == merged.left() && r.width() == merged.width()
+                    && (r.bottom() + 1 == merged.top() || merged.bottom() + 1 == r.top());
+            const bool sameRow = r.top() == merged.top() && r.height() == merged.height()
+                    && (r.right() + 1 == merged.left() || merged.right() + 1 == r.left());
+            if (sameColumn || sameRow) {
+                merged = merged.united(r);
+                m_freeRects.removeAt(i);
+                changed = true;
+                break;
+            }
+        }
+    }
+    m_freeRects.append(merged);
+}
+
+void QSGAreaAllocator::lowerSkyline()
+{
+    // A hole whose top edge spans segments at exactly its bottom has nothing
+    // allocated above it, so the outline can drop down to the top of the hole.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < m_freeRects.size() && !changed; ++i) {
+            const QRect hole = m_freeRects.at(i);
+            int first = -1;
+            int last = -1;
+            for (int j = 0; j < m_skyline.size(); ++j) {
+                const SkylineSegment &segment = m_skyline.at(j);
+                if (segment.x + segment.width <= hole.left() || segment.x > hole.right())
+                    continue;
+                if (segment.y != hole.bottom() + 1) {
+                    first = -1;
+                    break;
+                }
+                if (first < 0)
+                    first = j;
+                last = j;
+            }
+            if (first < 0)
+                continue;
+
+            // Split off the parts of the boundary segments that lie outside the hole.
+            SkylineSegment lastSegment = m_skyline.at(last);
+            const int lastEnd = lastSegment.x + lastSegment.width;
+            if (lastEnd > hole.right() + 1) {
+                m_skyline.insert(last + 1, { hole.right() + 1, lastSegment.y, lastEnd - hole.right() - 1 });
+            }
+            SkylineSegment firstSegment = m_skyline.at(first);
+            if (firstSegment.x < hole.left()) {
+                m_skyline.insert(first, { firstSegment.x, firstSegment.y, hole.left() - firstSegment.x });
+                ++first;
+                ++last;
+            }
+            m_skyline.remove(first, last - first + 1);
+            m_skyline.insert(first, { hole.left(), hole.top(), hole.width() });
+
+            for (int j = 0; j + 1 < m_skyline.size();) {
+                if (m_skyline.at(j).y == m_skyline.at(j + 1).y) {
+                    m_skyline[j].width += m_skyline.at(j + 1).width;
+                    m_skyline.removeAt(j + 1);
+                } else {
+                    ++j;
+                }
+            }
+            m_freeRects.removeAt(i);
+            changed = true;
+        }
+    }
+}
+
 bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node)
 {
     if (size.width() > currentRect.width() || size.height() > currentRect.height())
@@ -89,6 +371,7 @@ bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const Q
         if (size.width() + maxMargin >= currentRect.width() && size.height() + maxMargin >= currentRect.height()) {
             //Snug fit, occupy entire rectangle.
             node->isOccupied = true;
+            m_usedArea += qint64(currentRect.width()) * currentRect.height();
             result = currentRect.topLeft();
             return true;
         }
@@ -129,14 +412,28 @@ bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const Q
 
 bool QSGAreaAllocator::deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node)
 {
+    QRect currentRect(QPoint(0, 0), m_size);
     while (!node->isLeaf()) {
         //  has been split.
         int cmp = node->splitType == HorizontalSplit ? pos.y() : pos.x();
-        node = cmp < node->split ? node->left : node->right;
+        if (cmp < node->split) {
+            if (node->splitType == HorizontalSplit)
+                currentRect.setBottom(node->split - 1);
+            else
+                currentRect.setRight(node->split - 1);
+            node = node->left;
+        } else {
+            if (node->splitType == HorizontalSplit)
+                currentRect.setTop(node->split);
+            else
+                currentRect.setLeft(node->split);
+            node = node->right;
+        }
     }
     if (!node->isOccupied)
         return false;
     node->isOccupied = false;
+    m_usedArea -= qint64(currentRect.width()) * currentRect.height();
     mergeNodeWithNeighbors(node);
     return true;
 }
@@ -293,6 +590,8 @@ namespace {
 
 QByteArray QSGAreaAllocator::serialize()
 {
+    Q_ASSERT(m_strategy == BinaryTree);
+
     QVarLengthArray<QSGAreaAllocatorNode *> nodesToProcess;
 
     QStack<QSGAreaAllocatorNode *> nodes;
@@ -334,6 +633,8 @@ QByteArray QSGAreaAllocator::serialize()
 
 const char *QSGAreaAllocator::deserialize(const char *data, int size)
 {
+    Q_ASSERT(m_strategy == BinaryTree);
+
     if (uint(size) < AreaAllocatorTable::HeaderSize) {
         qWarning("QSGAreaAllocator::deserialize: Data not long enough to fit header");
         return nullptr;
@@ -388,6 +689,11 @@ const char *QSGAreaAllocator::deserialize(const char *data, int size)
         data += AreaAllocatorTable::NodeSize;
     }
 
+    m_usedArea = 0;
+    forEachLeaf(m_root, m_size, [this](const QSGAreaAllocatorNode *node, const QRect &rect) {
+        if (node->isOccupied)
+            m_usedArea += qint64(rect.width()) * rect.height();
+    });
     return data;
 }
 
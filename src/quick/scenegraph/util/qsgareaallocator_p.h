@@ -16,23 +16,33 @@
 //
 
 #include <private/qtquickglobal_p.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrect.h>
 #include <QtCore/qsize.h>
 
 QT_BEGIN_NAMESPACE
 
-class QRect;
 class QPoint;
 struct QSGAreaAllocatorNode;
 class Q_QUICK_PRIVATE_EXPORT QSGAreaAllocator
 {
 public:
-    QSGAreaAllocator(const QSize &size);
+    enum Strategy {
+        BinaryTree,
+        Skyline
+    };
+
+    QSGAreaAllocator(const QSize &size, Strategy strategy = BinaryTree);
     ~QSGAreaAllocator();
 
     QRect allocate(const QSize &size);
     bool deallocate(const QRect &rect);
-    bool isEmpty() const { return m_root == nullptr; }
+    bool isEmpty() const { return m_usedArea == 0; }
     QSize size() const { return m_size; }
+    Strategy strategy() const { return m_strategy; }
+
+    qint64 usedArea() const { return m_usedArea; }
+    qint64 largestFreeArea() const;
 
     QByteArray serialize();
     const char *deserialize(const char *data, int size);
@@ -42,8 +52,27 @@ private:
     bool deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node);
     void mergeNodeWithNeighbors(QSGAreaAllocatorNode *node);
 
-    QSGAreaAllocatorNode *m_root;
+    struct SkylineSegment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    QRect allocateInSkyline(const QSize &size);
+    QRect allocateInFreeRects(const QSize &size);
+    void addFreeRect(const QRect &rect);
+    void lowerSkyline();
+
+    QSGAreaAllocatorNode *m_root = nullptr;
     QSize m_size;
+    Strategy m_strategy;
+    qint64 m_usedArea = 0;
+
+    // Skyline only: the top edge of the allocated area, sorted by x, and the
+    // holes below it left by deallocations and by uneven placements.
+    QList<SkylineSegment> m_skyline;
+    QList<QRect> m_freeRects;
 };
 
 QT_END_NAMESPACE
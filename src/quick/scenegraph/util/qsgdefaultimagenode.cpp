@@ -3,6 +3,7 @@
 
 #include "qsgdefaultimagenode_p.h"
 #include <private/qsgnode_p.h>
+#include <private/qsgrhiatlastexture_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -125,6 +126,22 @@ void QSGDefaultImageNode::setTexture(QSGTexture *texture)
         dirty |= DirtyGeometry;
     m_textureSize = texture->textureSize();
     markDirty(dirty);
+
+    // Atlas textures may move when the atlas is defragmented.
+    m_textureSubRect = texture->normalizedTextureSubRect();
+    if (m_isAtlasTexture && QSGRhiAtlasTexture::Manager::isDefragmentationEnabled())
+        setFlag(UsePreprocess);
+}
+
+void QSGDefaultImageNode::preprocess()
+{
+    QSGTexture *t = texture();
+    if (!t || !m_isAtlasTexture || t->normalizedTextureSubRect() == m_textureSubRect)
+        return;
+
+    m_textureSubRect = t->normalizedTextureSubRect();
+    rebuildGeometry(&m_geometry, t, m_rect, m_sourceRect, m_texCoordMode);
+    markDirty(DirtyGeometry | DirtyMaterial);
 }
 
 QSGTexture *QSGDefaultImageNode::texture() const
@@ -52,6 +52,8 @@ public:
     void setOwnsTexture(bool owns) override;
     bool ownsTexture() const override;
 
+    void preprocess() override;
+
 private:
     QSGGeometry m_geometry;
     QSGOpaqueTextureMaterial m_opaque_material;
@@ -59,6 +61,7 @@ private:
     QRectF m_rect;
     QRectF m_sourceRect;
     QSize m_textureSize;
+    QRectF m_textureSubRect;
     TextureCoordinatesTransformMode m_texCoordMode;
     uint m_isAtlasTexture : 1;
     uint m_ownsTexture : 1;
@@ -9,6 +9,8 @@
 
 #include <QtGui/QWindow>
 
+#include <algorithm>
+
 #include <private/qqmlglobal_p.h>
 #include <private/qsgdefaultrendercontext_p.h>
 #include <private/qsgtexture_p.h>
@@ -22,6 +24,13 @@ int qt_sg_envInt(const char *name, int defaultValue);
 static QElapsedTimer qsg_renderer_timer;
 
 DEFINE_BOOL_CONFIG_OPTION(qsgEnableCompressedAtlas, QSG_ENABLE_COMPRESSED_ATLAS)
+DEFINE_BOOL_CONFIG_OPTION(qsgEnableAtlasDefragmentation, QSG_ATLAS_DEFRAGMENT)
+
+// Textures moved to the new page per frame while defragmenting, to spread the
+// copies over several frames.
+static const int defragmentBatchSize = 32;
+// Fragmentation above which a failed allocation starts defragmentation.
+static const qreal defragmentThreshold = 0.5;
 
 namespace QSGRhiAtlasTexture
 {
@@ -29,6 +38,8 @@ namespace QSGRhiAtlasTexture
 Manager::Manager(QSGDefaultRenderContext *rc, const QSize &surfacePixelSize, QSurface *maybeSurface)
     : m_rc(rc)
     , m_rhi(rc->rhi())
+    , m_defragment_requested(false)
+    , m_created_textures(false)
 {
     const int maxSize = m_rhi->resourceLimit(QRhi::TextureSizeMax);
     // surfacePixelSize is just a hint that was passed in when initializing the
@@ -51,22 +62,51 @@ Manager::Manager(QSGDefaultRenderContext *rc, const QSize &surfacePixelSize, QSu
     m_atlas_size_limit = qt_sg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
 
-    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d", w, h);
+    if (qgetenv("QSG_ATLAS_ALLOCATOR") == "skyline")
+        m_allocator_strategy = QSGAreaAllocator::Skyline;
+
+    // More pages are added as the existing ones fill up, for as long as they
+    // stay within the budget. There is always room for one.
+    const qint64 pageBytes = qint64(w) * h * 4;
+    const qint64 budgetBytes = qint64(qt_sg_envInt("QSG_ATLAS_MEMORY_BUDGET", 64)) * 1024 * 1024;
+    m_max_pages = int(qBound(qint64(1), budgetBytes / pageBytes, qint64(64)));
+
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d, up to %d pages, %s allocator%s", w, h,
+            m_max_pages,
+            m_allocator_strategy == QSGAreaAllocator::Skyline ? "skyline" : "binary tree",
+            isDefragmentationEnabled() ? ", defragmentation enabled" : "");
 }
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == nullptr);
+    Q_ASSERT(m_pages.isEmpty());
     Q_ASSERT(m_atlases.isEmpty());
 }
 
+bool Manager::isDefragmentationEnabled()
+{
+    return qsgEnableAtlasDefragmentation();
+}
+
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = nullptr;
+    for (Atlas *page : std::as_const(m_pages)) {
+        page->invalidate();
+        page->deleteLater();
+    }
+    m_pages.clear();
+
+    if (m_defragment_source)
+        m_retired_atlases.append(m_defragment_source);
+    m_defragment_source = nullptr;
+    m_defragment_target = nullptr;
+    m_defragment_queue.clear();
+    m_defragment_requested = false;
+    for (Atlas *atlas : std::as_const(m_retired_atlases)) {
+        atlas->invalidate();
+        atlas->deleteLater();
     }
+    m_retired_atlases.clear();
 
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*>::iterator i = m_atlases.begin();
     while (i != m_atlases.end()) {
@@ -81,15 +121,166 @@ QSGTexture *Manager::create(const QImage &image, bool hasAlphaChannel)
 {
     Texture *t = nullptr;
     if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_rc, m_atlas_size);
-        t = m_atlas->create(image);
+        m_created_textures = true;
+
+        // First fit, so that the older pages fill up and the textures of a
+        // scene end up on as few pages, and in as few batches, as possible.
+        for (Atlas *page : std::as_const(m_pages)) {
+            t = page->create(image);
+            if (t)
+                break;
+        }
+        if (!t && m_pages.size() < m_max_pages) {
+            m_pages.append(new Atlas(m_rc, m_atlas_size, m_allocator_strategy));
+            qCDebug(QSG_LOG_INFO, "rhi texture atlas: added page %d of %d",
+                    int(m_pages.size()), m_max_pages);
+            t = m_pages.last()->create(image);
+        }
         if (t && !hasAlphaChannel && t->hasAlphaChannel())
             t->setHasAlphaChannel(false);
+
+        // The image would have fit if the free space of a page was in one piece.
+        if (!t && !m_defragment_source && isDefragmentationEnabled()
+                && mostFragmentedPage(QSize(image.width() + 2, image.height() + 2))) {
+            m_defragment_requested = true;
+        }
     }
     return t;
 }
 
+Atlas *Manager::mostFragmentedPage(const QSize &size) const
+{
+    const qreal pageArea = qreal(m_atlas_size.width()) * m_atlas_size.height();
+    Atlas *result = nullptr;
+    qreal resultFragmentation = defragmentThreshold;
+    for (Atlas *page : m_pages) {
+        if ((1 - page->occupancy()) * pageArea < qreal(size.width()) * size.height())
+            continue;
+        const qreal fragmentation = page->fragmentation();
+        if (fragmentation > resultFragmentation) {
+            result = page;
+            resultFragmentation = fragmentation;
+        }
+    }
+    return result;
+}
+
+/*
+    Called at the start of a frame, before the scene graph is rendered.
+
+    Releases pages that are no longer used, and repacks the textures of a
+    fragmented page into a fresh one, a few at a time and only in frames that
+    upload no new atlas textures. The contents are copied on the GPU, so the
+    images need not be retained. Nodes notice that a texture has moved by its
+    normalizedTextureSubRect() changing. Renderers notice it by generation()
+    changing, as batches may then hold textures from both pages.
+ */
+void Manager::beginFrame()
+{
+    for (auto it = m_retired_atlases.begin(); it != m_retired_atlases.end();) {
+        if ((*it)->textureCount() == 0) {
+            (*it)->invalidate();
+            (*it)->deleteLater();
+            it = m_retired_atlases.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Give back pages that have been emptied, keeping one around.
+    bool released = false;
+    for (qsizetype i = m_pages.size() - 1; i >= 0 && m_pages.size() > 1; --i) {
+        Atlas *page = m_pages.at(i);
+        if (page->textureCount() == 0 && page != m_defragment_target) {
+            page->invalidate();
+            page->deleteLater();
+            m_pages.removeAt(i);
+            released = true;
+        }
+    }
+    if (released) {
+        qCDebug(QSG_LOG_INFO, "rhi texture atlas: released empty pages, %d of %d left",
+                int(m_pages.size()), m_max_pages);
+    }
+
+    const bool idle = !m_created_textures;
+    m_created_textures = false;
+    if (!idle || !m_rhi->isRecordingFrame())
+        return;
+
+    if (!m_defragment_source) {
+        if (!m_defragment_requested)
+            return;
+        m_defragment_requested = false;
+        Atlas *page = mostFragmentedPage(QSize(1, 1));
+        if (!page)
+            return;
+        beginDefragmentation(page);
+    }
+
+    if (!m_defragment_target->ensureTexture())
+        return;
+
+    QRhiResourceUpdateBatch *resourceUpdates = nullptr;
+    int moved = 0;
+    while (moved < defragmentBatchSize && !m_defragment_queue.isEmpty()) {
+        Texture *t = m_defragment_queue.takeFirst();
+        if (!t)
+            continue; // deleted in the meantime
+        if (!resourceUpdates)
+            resourceUpdates = m_rhi->nextResourceUpdateBatch();
+        if (!m_defragment_source->moveTexture(t, m_defragment_target, resourceUpdates)) {
+            // The new page is full as well; keep what is left where it is.
+            m_defragment_queue.clear();
+            break;
+        }
+        ++moved;
+    }
+    if (resourceUpdates)
+        m_rc->currentFrameCommandBuffer()->resourceUpdate(resourceUpdates);
+    if (moved)
+        ++m_generation;
+
+    if (m_defragment_queue.isEmpty())
+        endDefragmentation();
+}
+
+void Manager::beginDefragmentation(Atlas *page)
+{
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas: defragmenting %d textures, occupancy %.2f, fragmentation %.2f",
+            page->textureCount(), page->occupancy(), page->fragmentation());
+
+    // The fresh page takes the place of the fragmented one, so this stays
+    // within the page budget once the old page is gone.
+    const qsizetype index = m_pages.indexOf(page);
+    Q_ASSERT(index >= 0);
+    m_defragment_source = page;
+    m_defragment_target = new Atlas(m_rc, m_atlas_size, m_allocator_strategy);
+    m_pages.replace(index, m_defragment_target);
+
+    // Placing the tallest textures first packs them the tightest.
+    QList<Texture *> textures = m_defragment_source->textures();
+    std::sort(textures.begin(), textures.end(), [](const Texture *a, const Texture *b) {
+        const QRect ra = a->atlasSubRect();
+        const QRect rb = b->atlasSubRect();
+        return ra.height() != rb.height() ? ra.height() > rb.height() : ra.width() > rb.width();
+    });
+    m_defragment_queue.reserve(textures.size());
+    for (Texture *t : std::as_const(textures))
+        m_defragment_queue.append(t);
+}
+
+void Manager::endDefragmentation()
+{
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas: defragmented, %d textures left behind, occupancy %.2f, fragmentation %.2f",
+            m_defragment_source->textureCount(), m_defragment_target->occupancy(),
+            m_defragment_target->fragmentation());
+
+    m_retired_atlases.append(m_defragment_source);
+    m_defragment_source = nullptr;
+    m_defragment_target = nullptr;
+}
+
 QSGTexture *Manager::create(const QSGCompressedTextureFactory *factory)
 {
     QSGTexture *t = nullptr;
@@ -115,10 +306,11 @@ QSGTexture *Manager::create(const QSGCompressedTextureFactory *factory)
     return t;
 }
 
-AtlasBase::AtlasBase(QSGDefaultRenderContext *rc, const QSize &size)
+AtlasBase::AtlasBase(QSGDefaultRenderContext *rc, const QSize &size,
+                     QSGAreaAllocator::Strategy strategy)
     : m_rc(rc)
     , m_rhi(rc->rhi())
-    , m_allocator(size)
+    , m_allocator(size, strategy)
     , m_size(size)
 {
 }
@@ -134,15 +326,22 @@ void AtlasBase::invalidate()
     m_texture = nullptr;
 }
 
-void AtlasBase::commitTextureOperations(QRhiResourceUpdateBatch *resourceUpdates)
+bool AtlasBase::ensureTexture()
 {
     if (!m_allocated) {
         m_allocated = true;
         if (!generateTexture()) {
             qWarning("QSGTextureAtlas: Failed to create texture");
-            return;
+            return false;
         }
     }
+    return m_texture != nullptr;
+}
+
+void AtlasBase::commitTextureOperations(QRhiResourceUpdateBatch *resourceUpdates)
+{
+    if (!ensureTexture())
+        return;
 
     for (TextureBase *t : m_pending_uploads)
         enqueueTextureUpload(t, resourceUpdates);
@@ -155,10 +354,25 @@ void AtlasBase::remove(TextureBase *t)
     QRect atlasRect = t->atlasSubRect();
     m_allocator.deallocate(atlasRect);
     m_pending_uploads.removeOne(t);
+    m_textures.remove(t);
+}
+
+qreal AtlasBase::occupancy() const
+{
+    return m_allocator.usedArea() / (qreal(m_size.width()) * m_size.height());
+}
+
+qreal AtlasBase::fragmentation() const
+{
+    const qint64 freeArea = qint64(m_size.width()) * m_size.height() - m_allocator.usedArea();
+    if (freeArea <= 0)
+        return 0;
+    return 1 - m_allocator.largestFreeArea() / qreal(freeArea);
 }
 
-Atlas::Atlas(QSGDefaultRenderContext *rc, const QSize &size)
-    : AtlasBase(rc, size)
+Atlas::Atlas(QSGDefaultRenderContext *rc, const QSize &size,
+             QSGAreaAllocator::Strategy strategy)
+    : AtlasBase(rc, size, strategy)
 {
     // use RGBA texture internally as that is the only one guaranteed to be always supported
     m_format = QRhiTexture::RGBA8;
@@ -187,6 +401,43 @@ Texture *Atlas::create(const QImage &image)
     return nullptr;
 }
 
+QList<Texture *> Atlas::textures() const
+{
+    QList<Texture *> result;
+    result.reserve(m_textures.size());
+    for (TextureBase *t : m_textures)
+        result.append(static_cast<Texture *>(t));
+    return result;
+}
+
+bool Atlas::moveTexture(Texture *t, Atlas *target, QRhiResourceUpdateBatch *resourceUpdates)
+{
+    Q_ASSERT(m_textures.contains(t));
+
+    const QRect from = t->atlasSubRect();
+    const QRect to = target->m_allocator.allocate(from.size());
+    if (!to.isValid())
+        return false;
+
+    if (m_pending_uploads.removeOne(t)) {
+        // Not uploaded yet, the image is still there to upload to the new place.
+        target->m_pending_uploads << t;
+    } else {
+        // The padding is copied along with the image.
+        QRhiTextureCopyDescription desc;
+        desc.setSourceTopLeft(from.topLeft());
+        desc.setDestinationTopLeft(to.topLeft());
+        desc.setPixelSize(from.size());
+        resourceUpdates->copyTexture(target->texture(), m_texture, desc);
+    }
+
+    m_allocator.deallocate(from);
+    m_textures.remove(t);
+    target->m_textures.insert(t);
+    t->moveTo(target, to);
+    return true;
+}
+
 bool Atlas::generateTexture()
 {
     m_texture = m_rhi->newTexture(m_format, m_size, 1, QRhiTexture::UsedAsTransferSource);
@@ -311,6 +562,7 @@ TextureBase::TextureBase(AtlasBase *atlas, const QRect &textureRect)
     , m_allocated_rect(textureRect)
     , m_atlas(atlas)
 {
+    m_atlas->m_textures.insert(this);
 }
 
 TextureBase::~TextureBase()
@@ -350,13 +602,7 @@ Texture::Texture(Atlas *atlas, const QRect &textureRect, const QImage &image)
     , m_image(image)
     , m_has_alpha(image.hasAlphaChannel())
 {
-    float w = atlas->size().width();
-    float h = atlas->size().height();
-    QRect nopad = atlasSubRectWithoutPadding();
-    m_texture_coords_rect = QRectF(nopad.x() / w,
-                                   nopad.y() / h,
-                                   nopad.width() / w,
-                                   nopad.height() / h);
+    updateTextureCoordinates();
 }
 
 Texture::~Texture()
@@ -365,6 +611,24 @@ Texture::~Texture()
         delete m_nonatlas_texture;
 }
 
+void Texture::moveTo(Atlas *atlas, const QRect &textureRect)
+{
+    m_atlas = atlas;
+    m_allocated_rect = textureRect;
+    updateTextureCoordinates();
+}
+
+void Texture::updateTextureCoordinates()
+{
+    float w = m_atlas->size().width();
+    float h = m_atlas->size().height();
+    QRect nopad = atlasSubRectWithoutPadding();
+    m_texture_coords_rect = QRectF(nopad.x() / w,
+                                   nopad.y() / h,
+                                   nopad.width() / w,
+                                   nopad.height() / h);
+}
+
 QSGTexture *Texture::removedFromAtlas(QRhiResourceUpdateBatch *resourceUpdates) const
 {
     if (!m_nonatlas_texture) {
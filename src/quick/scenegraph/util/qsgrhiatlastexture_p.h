@@ -16,6 +16,8 @@
 //
 
 #include <QtCore/QSize>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
 #include <QtQuick/private/qsgplaintexture_p.h>
 #include <QtQuick/private/qsgareaallocator_p.h>
 #include <QtGui/QSurface>
@@ -49,25 +51,53 @@ public:
     QSGTexture *create(const QSGCompressedTextureFactory *factory);
     void invalidate();
 
+    void beginFrame();
+
+    // Atlas textures may move to another atlas page while in use, which
+    // changes their normalizedTextureSubRect().
+    static bool isDefragmentationEnabled();
+
+    // Changes in every frame in which textures have moved to another page.
+    uint generation() const { return m_generation; }
+
 private:
+    Atlas *mostFragmentedPage(const QSize &size) const;
+    void beginDefragmentation(Atlas *page);
+    void endDefragmentation();
+
     QSGDefaultRenderContext *m_rc;
     QRhi *m_rhi;
-    Atlas *m_atlas = nullptr;
+    // pages taking new textures, added on demand up to m_max_pages
+    QList<Atlas *> m_pages;
     // set of atlases for different compressed formats
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*> m_atlases;
 
+    // the page being emptied into its replacement, and pages that could not
+    // be emptied completely and are kept until their last texture is gone
+    Atlas *m_defragment_source = nullptr;
+    Atlas *m_defragment_target = nullptr;
+    QList<QPointer<Texture>> m_defragment_queue;
+    QList<Atlas *> m_retired_atlases;
+
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    int m_max_pages = 1;
+    uint m_generation = 0;
+    QSGAreaAllocator::Strategy m_allocator_strategy = QSGAreaAllocator::BinaryTree;
+    uint m_defragment_requested : 1;
+    uint m_created_textures : 1;
 };
 
 class AtlasBase : public QObject
 {
     Q_OBJECT
 public:
-    AtlasBase(QSGDefaultRenderContext *rc, const QSize &size);
+    AtlasBase(QSGDefaultRenderContext *rc, const QSize &size,
+              QSGAreaAllocator::Strategy strategy = QSGAreaAllocator::BinaryTree);
     ~AtlasBase();
 
     void invalidate();
+    bool ensureTexture();
     void commitTextureOperations(QRhiResourceUpdateBatch *resourceUpdates);
     void remove(TextureBase *t);
 
@@ -76,6 +106,12 @@ public:
     QRhiTexture *texture() const { return m_texture; }
     QSize size() const { return m_size; }
 
+    // Fraction of the atlas that is allocated, and fraction of the free space
+    // that is not available to the largest possible allocation.
+    qreal occupancy() const;
+    qreal fragmentation() const;
+    int textureCount() const { return m_textures.size(); }
+
 protected:
     virtual bool generateTexture() = 0;
     virtual void enqueueTextureUpload(TextureBase *t, QRhiResourceUpdateBatch *resourceUpdates) = 0;
@@ -87,6 +123,7 @@ protected:
     QRhiTexture *m_texture = nullptr;
     QSize m_size;
     QVector<TextureBase *> m_pending_uploads;
+    QSet<TextureBase *> m_textures;
     friend class TextureBase;
     friend class TextureBasePrivate;
 
@@ -97,13 +134,16 @@ private:
 class Atlas : public AtlasBase
 {
 public:
-    Atlas(QSGDefaultRenderContext *rc, const QSize &size);
+    Atlas(QSGDefaultRenderContext *rc, const QSize &size,
+          QSGAreaAllocator::Strategy strategy = QSGAreaAllocator::BinaryTree);
     ~Atlas();
 
     bool generateTexture() override;
     void enqueueTextureUpload(TextureBase *t, QRhiResourceUpdateBatch *resourceUpdates) override;
 
     Texture *create(const QImage &image);
+    QList<Texture *> textures() const;
+    bool moveTexture(Texture *t, Atlas *target, QRhiResourceUpdateBatch *resourceUpdates);
 
     QRhiTexture::Format format() const { return m_format; }
 
@@ -155,7 +195,11 @@ public:
     void releaseImage() { m_image = QImage(); }
     const QImage &image() const { return m_image; }
 
+    void moveTo(Atlas *atlas, const QRect &textureRect);
+
 private:
+    void updateTextureCoordinates();
+
     QRectF m_texture_coords_rect;
     QImage m_image;
     mutable QSGPlainTexture *m_nonatlas_texture = nullptr;
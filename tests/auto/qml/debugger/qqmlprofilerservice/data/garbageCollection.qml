@@ -0,0 +1,17 @@
+import QtQml 2.0
+
+Timer {
+    interval: 1
+    running: true
+
+    onTriggered: {
+        var garbage = [];
+        for (var i = 0; i < 3; ++i) {
+            for (var j = 0; j < 1000; ++j)
+                garbage.push({ index: j });
+            garbage = [];
+            gc();
+        }
+        Qt.quit();
+    }
+}
@@ -0,0 +1,20 @@
+import QtQml 2.0
+
+Timer {
+    interval: 1
+    running: true
+
+    function pick(objects, i) {
+        return objects[i % objects.length];
+    }
+
+    onTriggered: {
+        // More shapes than a polymorphic lookup can hold.
+        var objects = [{ a: 1 }, { b: 2, a: 1 }, { c: 3, a: 1 }, { d: 4, a: 1 },
+                       { e: 5, a: 1 }, { f: 6, a: 1 }];
+        var sum = 0;
+        for (var i = 0; i < 100; ++i)
+            sum += pick(objects, i).a + interval;
+        Qt.quit();
+    }
+}
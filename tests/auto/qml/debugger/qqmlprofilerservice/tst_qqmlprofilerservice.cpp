@@ -10,7 +10,9 @@
 
 #include <QtTest/qtest.h>
 #include <QtTest/qsignalspy.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qlibraryinfo.h>
+#include <QtCore/qset.h>
 
 #include <QtGui/private/qguiapplication_p.h>
 #include <QtGui/qpa/qplatformintegration.h>
@@ -38,6 +40,8 @@ public:
     QVector<QQmlProfilerEvent> qmlMessages;
     QVector<QQmlProfilerEvent> javascriptMessages;
     QVector<QQmlProfilerEvent> jsHeapMessages;
+    QVector<QQmlProfilerEvent> gcMessages;
+    QVector<QQmlProfilerEvent> lookupMessages;
     QVector<QQmlProfilerEvent> asynchronousMessages;
     QVector<QQmlProfilerEvent> pixmapMessages;
 
@@ -124,7 +128,14 @@ void QQmlProfilerTestClient::addEvent(const QQmlProfilerEvent &event)
     case MemoryAllocation:
         jsHeapMessages.append(event);
         break;
+    case GarbageCollection:
+        gcMessages.append(event);
+        break;
+    case PropertyLookup:
+        lookupMessages.append(event);
+        break;
     case DebugMessage:
+    case Quick3DFrame:
         // Unhandled
         break;
     case MaximumMessage:
@@ -209,12 +220,15 @@ private slots:
     void flushInterval();
     void translationBinding();
     void memory();
+    void garbageCollection();
+    void propertyLookup();
     void compile();
     void multiEngine();
     void batchOverflow();
 
 private:
     bool m_recordFromStart = true;
+    quint64 m_requestedFeatures = std::numeric_limits<quint64>::max();
     bool m_flushInterval = false;
     bool m_isComplete = false;
 
@@ -306,6 +320,10 @@ void tst_QQmlProfilerService::checkJsHeap()
             used += amount;
             seen_large = true;
             break;
+        default:
+            QFAIL(qPrintable(QString::fromLatin1("Memory event with unknown detailType %1.")
+                             .arg(type.detailType())));
+            break;
         }
 
         QVERIFY(message.timestamp() >= lastTimestamp);
@@ -451,6 +469,7 @@ bool tst_QQmlProfilerService::verify(tst_QQmlProfilerService::MessageListType ty
 QList<QQmlDebugClient *> tst_QQmlProfilerService::createClients()
 {
     m_client.reset(new QQmlProfilerTestClient(m_connection));
+    m_client->client->setRequestedFeatures(m_requestedFeatures);
     m_client->client->setRecording(m_recordFromStart);
     m_client->client->setFlushInterval(m_flushInterval);
     QObject::connect(m_client->client.data(), &QQmlProfilerClient::complete,
@@ -503,6 +522,7 @@ void tst_QQmlProfilerService::cleanup()
     }
 
     m_client.reset();
+    m_requestedFeatures = std::numeric_limits<quint64>::max();
     QQmlDebugTest::cleanup();
 }
 
@@ -723,6 +743,59 @@ void tst_QQmlProfilerService::memory()
     QVERIFY(smallItems > 5);
 }
 
+void tst_QQmlProfilerService::garbageCollection()
+{
+    QCOMPARE(connectTo(true, "garbageCollection.qml"), ConnectSuccess);
+    checkProcessTerminated();
+
+    checkTraceReceived();
+    checkJsHeap();
+
+    // GC pauses are not memory events, they must not end up in the heap statistics.
+    QVERIFY(m_client);
+    QVERIFY(m_client->gcMessages.size() >= 3);
+    for (const auto &message : m_client->gcMessages) {
+        const QQmlProfilerEventType &type = m_client->types[message.typeIndex()];
+        QCOMPARE(type.detailType(), int(FullGarbageCollection));
+        QVERIFY(message.number<qint64>(0) > 0);
+    }
+}
+
+void tst_QQmlProfilerService::propertyLookup()
+{
+    // Lookups are only profiled if asked for explicitly.
+    m_requestedFeatures = (quint64(1) << ProfileJavaScript) | (quint64(1) << ProfileLookups);
+    QCOMPARE(connectTo(true, "propertyLookup.qml"), ConnectSuccess);
+    checkProcessTerminated();
+
+    checkTraceReceived();
+
+    QVERIFY(m_client);
+    QVERIFY(!m_client->lookupMessages.isEmpty());
+
+    QHash<QString, qint64> megamorphic;
+    QSet<QString> names;
+    for (const auto &message : m_client->lookupMessages) {
+        const QQmlProfilerEventType &type = m_client->types[message.typeIndex()];
+        QVERIFY(type.location().filename().endsWith("propertyLookup.qml"));
+        QVERIFY(type.location().line() > 0);
+        QVERIFY(message.number<qint64>(0) >= LookupHit);
+        QVERIFY(message.number<qint64>(0) < MaximumLookupResult);
+        QVERIFY(message.number<qint64>(1) > 0);
+        names.insert(type.data());
+        if (message.number<qint64>(0) == LookupMegamorphic)
+            megamorphic[type.data()] += message.number<qint64>(1);
+    }
+
+    // Once the lookup has given up on caching, every further access is megamorphic, not just
+    // the one that gave up.
+    QVERIFY2(megamorphic.value("a") > 90, qPrintable(QString::number(megamorphic.value("a"))));
+
+    // Loads and calls of properties of the QML context are profiled, too.
+    QVERIFY(names.contains("interval"));
+    QVERIFY(names.contains("pick"));
+}
+
 static bool hasCompileEvents(const QVector<QQmlProfilerEventType> &types)
 {
     for (const QQmlProfilerEventType &type : types) {
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <private/qv4alloca_p.h>
 #include <private/qjsvalue_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 #include <QScopeGuard>
 #include <QUrl>
 #include <QModelIndex>
@@ -105,6 +106,7 @@ private slots:
     void castWithMultipleInheritance();
     void collectGarbage();
     void collectGarbageNestedWrappersTwoEngines();
+    void garbageCollectionStatistics();
     void gcWithNestedDataStructure();
     void stacktrace();
     void numberParsing_data();
@@ -304,6 +306,8 @@ private slots:
     void callWithSpreadOnElement();
     void spreadNoOverflow();
 
+    void polymorphicLookups();
+
 public:
     Q_INVOKABLE QJSValue throwingCppMethod1();
     Q_INVOKABLE void throwingCppMethod2();
@@ -1893,6 +1897,36 @@ void tst_QJSEngine::collectGarbage()
     QVERIFY(ptr.isNull());
 }
 
+void tst_QJSEngine::garbageCollectionStatistics()
+{
+    QJSEngine eng;
+    eng.evaluate("var live = []; for (var i = 0; i < 1000; ++i) live.push({ index: i, name: 'x' + i });"
+                 "var huge = new Array(100000).fill(0);");
+    eng.collectGarbage();
+    eng.collectGarbage();
+
+    const QJSEngine::GarbageCollectionStatistics stats = eng.garbageCollectionStatistics();
+    QVERIFY(stats.collections >= 2);
+    QVERIFY(stats.totalMarkTime > 0);
+    QVERIFY(stats.totalSweepTime > 0);
+    QVERIFY(stats.longestPause > 0);
+
+    quint64 pauses = 0;
+    for (quint64 count : stats.pauseHistogram)
+        pauses += count;
+    QVERIFY(pauses >= stats.collections);
+
+    quint64 allocated = 0;
+    for (quint64 bytes : stats.allocatedBytesPerSizeClass)
+        allocated += bytes;
+    QVERIFY(allocated > 0);
+
+    QVERIFY(stats.hugeItemAllocations > 0);
+    QVERIFY(stats.liveHugeItems > 0);
+    QVERIFY(stats.heapSize >= stats.usedHeapSize);
+    QVERIFY(stats.usedHeapSize > 0);
+}
+
 class TestObjectContainer : public QObject
 {
     Q_OBJECT
@@ -6083,6 +6117,60 @@ void tst_QJSEngine::spreadNoOverflow()
     QCOMPARE(result.errorType(), QJSValue::RangeError);
 }
 
+void tst_QJSEngine::polymorphicLookups()
+{
+    QJSEngine engine;
+
+    const QJSValue result = engine.evaluate(uR"(
+        function getX(o) { return o.x; }
+        function setX(o, v) { o.x = v; }
+        const four = [{ x: 1 }, { a: 0, x: 2 }, { b: 0, x: 3 }, { c: 0, x: 4 }];
+        for (let i = 0; i < 10; ++i) {
+            for (const o of four)
+                setX(o, getX(o) + 1);
+        }
+
+        function getY(o) { return o.y; }
+        const six = [{ y: 1 }, { a: 0, y: 1 }, { b: 0, y: 1 }, { c: 0, y: 1 }, { d: 0, y: 1 },
+                     { e: 0, y: 1 }];
+        let total = 0;
+        for (let i = 0; i < 3; ++i) {
+            for (const o of six)
+                total += getY(o);
+        }
+
+        class A { f() { return 1; } }
+        class B { f() { return 2; } }
+        class C extends A { }
+        class D { get f() { return () => 4; } }
+        function callF(o) { return o.f(); }
+        const objects = [new A, new B, new C, new D];
+        let calls = 0;
+        for (let i = 0; i < 5; ++i) {
+            for (const o of objects)
+                calls += callF(o);
+        }
+
+        globalThis.keepAlive = getX;
+        [four.map(o => o.x).join(), total, calls];
+    )"_s);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.property(0).toString(), u"11,12,13,14"_s);
+    QCOMPARE(result.property(1).toInt(), 18);
+    QCOMPARE(result.property(2).toInt(), 40);
+
+    QV4::ExecutableCompilationUnit::LookupStatistics statistics;
+    for (const QV4::ExecutableCompilationUnit *unit : engine.handle()->compilationUnits) {
+        const auto unitStatistics = unit->lookupStatistics();
+        statistics.polymorphic += unitStatistics.polymorphic;
+        statistics.megamorphic += unitStatistics.megamorphic;
+    }
+    // o.x in getX and setX, and o.f in callF.
+    QVERIFY(statistics.polymorphic >= 3);
+    // o.y in getY.
+    QVERIFY(statistics.megamorphic >= 1);
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
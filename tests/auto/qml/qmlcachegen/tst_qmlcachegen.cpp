@@ -13,6 +13,7 @@
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qv4compileddata_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 #include <qtranslator.h>
 #include <qqmlscriptstring.h>
 #include <QString>
@@ -33,6 +34,7 @@ private slots:
     void initTestCase() override;
 
     void loadGeneratedFile();
+    void cacheBundle();
     void translationExpressionSupport();
     void signalHandlerParameters();
     void errorOnArgumentsInSignalHandler();
@@ -223,6 +225,67 @@ void tst_qmlcachegen::loadGeneratedFile()
     QVERIFY(unitData->flags & QV4::CompiledData::Unit::StaticData);
 }
 
+void tst_qmlcachegen::cacheBundle()
+{
+#if defined(QTEST_CROSS_COMPILED)
+    QSKIP("Cannot call qmlcachegen on cross-compiled target.");
+#endif
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const auto writeTempFile = [&tempDir](const QString &fileName, const char *contents) {
+        QFile f(tempDir.filePath(fileName));
+        const bool ok = f.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        Q_ASSERT(ok);
+        f.write(contents);
+        return f.fileName();
+    };
+
+    const QString mainPath = writeTempFile("Main.qml", "import QtQml\n"
+                                                       "import \"utils.js\" as Utils\n"
+                                                       "QtObject {\n"
+                                                       "    property int value: Utils.answer()\n"
+                                                       "    property QtObject child: Child {}\n"
+                                                       "}");
+    const QString childPath = writeTempFile("Child.qml", "import QtQml\n"
+                                                         "QtObject { property int value: 10 }");
+    const QString utilsPath = writeTempFile("utils.js", "function answer() { return 42; }");
+    const QString bundlePath = tempDir.filePath("qmlcache.qmlcb");
+
+    QProcess proc;
+    proc.setProcessChannelMode(QProcess::ForwardedChannels);
+    proc.setProgram(QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath)
+                    + QLatin1String("/qmlcachegen"));
+    proc.setArguments({ u"-o"_s, bundlePath, mainPath, childPath, utilsPath });
+    proc.start();
+    QVERIFY(proc.waitForFinished());
+    QCOMPARE(proc.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(proc.exitCode(), 0);
+
+    QVERIFY(QFile::exists(bundlePath));
+    QVERIFY(!QFile::exists(mainPath + QLatin1Char('c')));
+
+    QQmlEngine engine;
+    CleanlyLoadingComponent component(&engine, QUrl::fromLocalFile(mainPath));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QObject> obj(component.create());
+    QVERIFY(!obj.isNull());
+    QCOMPARE(obj->property("value").toInt(), 42);
+    QObject *child = obj->property("child").value<QObject *>();
+    QVERIFY(child);
+    QCOMPARE(child->property("value").toInt(), 10);
+
+    // Files compiled at run time are saved to the local disk cache, files
+    // loaded from the bundle are not.
+    if (qEnvironmentVariableIsSet("QML_DISABLE_DISK_CACHE"))
+        QSKIP("The disk cache is disabled, so there is no way to tell where units came from.");
+    for (const QString &path : { mainPath, childPath, utilsPath }) {
+        const QString cachePath = QV4::ExecutableCompilationUnit::localCacheFilePath(
+                    QUrl::fromLocalFile(path));
+        QVERIFY2(!QFile::exists(cachePath), qPrintable(path));
+    }
+}
+
 class QTestTranslator : public QTranslator
 {
 public:
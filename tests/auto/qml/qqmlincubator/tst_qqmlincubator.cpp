@@ -14,6 +14,7 @@
 #include <QQmlComponent>
 #include <QQmlIncubator>
 #include <private/qjsvalue_p.h>
+#include <private/qqmlengine_p.h>
 #include <private/qqmlincubator_p.h>
 #include <private/qqmlobjectcreator_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
@@ -47,6 +48,7 @@ private slots:
     void garbageCollection();
     void requiredProperties();
     void deleteInSetInitialState();
+    void incubateUntil();
 
 private:
     QQmlIncubationController controller;
@@ -1240,6 +1242,42 @@ void tst_qqmlincubator::deleteInSetInitialState()
     QCOMPARE(incubator.object(), nullptr); // object was deleted
 }
 
+void tst_qqmlincubator::incubateUntil()
+{
+    QQmlEngine engine;
+    QQmlIncubationController controller;
+    engine.setIncubationController(&controller);
+
+    QQmlComponent component(&engine);
+    component.setData("import QtQml\n"
+                      "QtObject {\n"
+                      "    property QtObject a: QtObject {}\n"
+                      "    property QtObject b: QtObject {}\n"
+                      "}", QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QQmlIncubator incubator;
+    component.create(incubator);
+    QCOMPARE(incubator.status(), QQmlIncubator::Loading);
+    QCOMPARE(controller.incubatingObjectCount(), 1);
+
+    // Even an expired deadline makes progress: all three objects are created,
+    // and counted, before the incubation is interrupted.
+    QQmlEnginePrivate *enginePriv = QQmlEnginePrivate::get(&engine);
+    const quint64 incubatedObjectCount = enginePriv->incubatedObjectCount;
+    controller.incubateUntil(QDeadlineTimer(0));
+    QCOMPARE(incubator.status(), QQmlIncubator::Loading);
+    QCOMPARE(enginePriv->incubatedObjectCount - incubatedObjectCount, quint64(3));
+
+    // Completing them does not count them again.
+    controller.incubateUntil(QDeadlineTimer(QDeadlineTimer::Forever));
+    QVERIFY(incubator.isReady());
+    QCOMPARE(enginePriv->incubatedObjectCount - incubatedObjectCount, quint64(3));
+    QCOMPARE(controller.incubatingObjectCount(), 0);
+    QVERIFY(incubator.object());
+    delete incubator.object();
+}
+
 QTEST_MAIN(tst_qqmlincubator)
 
 #include "tst_qqmlincubator.moc"
@@ -0,0 +1,16 @@
+import QtQuick
+
+QtObject {
+    property color color: "steelblue"
+    property url url: "images/icon.png"
+    property point point: "4,5"
+    property size size: "32x24"
+    property rect rect: "1,2,30x40"
+    property date date: "2024-01-15T10:30:00"
+    property vector3d vector: "1,2,3"
+
+    property QtObject child: QtObject {
+        property color color: "#80ff0000"
+        property url url: "child.qml"
+    }
+}
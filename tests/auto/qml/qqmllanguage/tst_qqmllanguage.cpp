@@ -29,6 +29,7 @@
 #include <private/qqmltype_p_p.h>
 #include <private/qv4debugging_p.h>
 #include <private/qqmlcomponentattached_p.h>
+#include <private/qqmlliteralplan_p.h>
 #include <QtQml/private/qqmlexpression_p.h>
 
 #include "testtypes.h"
@@ -415,6 +416,8 @@ private slots:
 
     void objectMethodClone();
 
+    void literalPlan();
+
 private:
     QQmlEngine engine;
     QStringList defaultImportPathList;
@@ -7986,6 +7989,49 @@ void tst_qqmllanguage::objectMethodClone()
     QTRY_COMPARE(o->property("doneClicks").toInt(), 2);
 }
 
+void tst_qqmllanguage::literalPlan()
+{
+    const bool wasEnabled = QQmlLiteralPlan::isEnabled();
+    const auto restore = qScopeGuard([&]() { QQmlLiteralPlan::setEnabled(wasEnabled); });
+
+    for (const bool planLiterals : { false, true }) {
+        QQmlLiteralPlan::setEnabled(planLiterals);
+
+        // A new engine, so that the compilation unit is not shared with the other run.
+        QQmlEngine engine;
+        QQmlComponent component(&engine, testFileUrl("literalPlan.qml"));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+        // The second object is created from the plan prepared for the first one.
+        for (int i = 0; i < 2; ++i) {
+            QScopedPointer<QObject> o(component.create());
+            QVERIFY(o);
+            QCOMPARE(o->property("color").value<QColor>(), QColor("steelblue"));
+            QCOMPARE(o->property("url").toUrl(), testFileUrl("images/icon.png"));
+            QCOMPARE(o->property("point").toPointF(), QPointF(4, 5));
+            QCOMPARE(o->property("size").toSizeF(), QSizeF(32, 24));
+            QCOMPARE(o->property("rect").toRectF(), QRectF(1, 2, 30, 40));
+            QCOMPARE(o->property("date").toDateTime(),
+                     QDateTime(QDate(2024, 1, 15), QTime(10, 30)));
+            QCOMPARE(o->property("vector").value<QVector3D>(), QVector3D(1, 2, 3));
+
+            QObject *child = o->property("child").value<QObject *>();
+            QVERIFY(child);
+            QCOMPARE(child->property("color").value<QColor>(), QColor::fromRgb(255, 0, 0, 128));
+            QCOMPARE(child->property("url").toUrl(), testFileUrl("child.qml"));
+        }
+
+        const QQmlLiteralPlan *plan
+                = QQmlComponentPrivate::get(&component)->compilationUnit->literalPlan.get();
+        if (planLiterals) {
+            QVERIFY(plan);
+            QCOMPARE(plan->count(), 9);
+        } else {
+            QVERIFY(!plan);
+        }
+    }
+}
+
 QTEST_MAIN(tst_qqmllanguage)
 
 #include "tst_qqmllanguage.moc"
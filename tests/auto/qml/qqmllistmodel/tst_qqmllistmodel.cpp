@@ -14,6 +14,7 @@
 #include <QtCore/qdebug.h>
 #include <QtCore/qtranslator.h>
 #include <QSignalSpy>
+#include <QtCore/qregularexpression.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
@@ -119,6 +120,8 @@ private slots:
     void objectOwnershipFlip();
     void enumsInListElement();
     void protectQObjectFromGC();
+    void columns_data();
+    void columns();
 };
 
 bool tst_qqmllistmodel::compareVariantList(const QVariantList &testList, QVariant object)
@@ -1931,6 +1934,86 @@ void tst_qqmllistmodel::protectQObjectFromGC()
     }
 }
 
+void tst_qqmllistmodel::columns_data()
+{
+    QTest::addColumn<bool>("dynamicRoles");
+    QTest::newRow("static roles") << false;
+    QTest::newRow("dynamic roles") << true;
+}
+
+void tst_qqmllistmodel::columns()
+{
+    QFETCH(bool, dynamicRoles);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(R"(
+    import QtQuick
+    ListModel {
+        property var costs
+        property real total
+        function run() {
+            for (let i = 0; i < 5; ++i)
+                append({"name": "item" + i, "cost": i});
+            costs = getColumn("cost");
+            total = costs.reduce((sum, cost) => sum + cost, 0);
+            setColumn("cost", costs.map(cost => cost * 2));
+            setColumn("fresh", [true, false, true, false, true]);
+        }
+    })", QUrl());
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    QQmlListModel *model = qobject_cast<QQmlListModel *>(root.data());
+    QVERIFY(model);
+    model->setDynamicRoles(dynamicRoles);
+
+    QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+    QMetaObject::invokeMethod(model, "run");
+
+    QCOMPARE(root->property("costs").value<QJSValue>().property("length").toInt(), 5);
+    QCOMPARE(root->property("total").toDouble(), 10.0);
+
+    // One notification per column, not one per item.
+    QCOMPARE(changedSpy.size(), 2);
+    const QModelIndex first = changedSpy.at(0).at(0).value<QModelIndex>();
+    const QModelIndex last = changedSpy.at(0).at(1).value<QModelIndex>();
+    QCOMPARE(first.row(), 1); // 0 * 2 == 0 doesn't change
+    QCOMPARE(last.row(), 4);
+
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(model->get(i).property("cost").toNumber(), 2.0 * i);
+        QCOMPARE(model->get(i).property("fresh").toBool(), i % 2 == 0);
+    }
+
+    QVERIFY(model->getColumn("doesNotExist").isUndefined());
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression("setColumn: array length 2 doesn't match count 5"));
+    model->setColumn("cost", engine.toScriptValue(QVariantList { 1, 2 }));
+
+    if (dynamicRoles)
+        return; // Dynamic roles can hold values of any type.
+
+    // A value of the wrong type rejects the whole column, rather than skipping that item.
+    changedSpy.clear();
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("setColumn: can't assign value at index 3 to role 'cost' of type Number"));
+    model->setColumn("cost", engine.toScriptValue(QVariantList { 1, 2, 3, QStringLiteral("x"), 5 }));
+    QCOMPARE(changedSpy.size(), 0);
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(model->get(i).property("cost").toNumber(), 2.0 * i);
+
+    // Clearing a role is a change, too.
+    model->setColumn("fresh", engine.evaluate("[true, null, true, false, undefined]"));
+    QCOMPARE(changedSpy.size(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changedSpy.at(0).at(1).value<QModelIndex>().row(), 4);
+    QCOMPARE(model->get(1).property("fresh").toBool(), false);
+    QCOMPARE(model->get(4).property("fresh").toBool(), false);
+}
+
 QTEST_MAIN(tst_qqmllistmodel)
 
 #include "tst_qqmllistmodel.moc"
@@ -15,9 +15,12 @@
 #include <QtQml/private/qqmltypeloader_p.h>
 #include <QtQml/private/qqmlirbuilder_p.h>
 #include <QtQml/private/qqmlirloader_p.h>
+#include <QtQml/private/qqmlloadmanifest_p.h>
 #include <QtQuickTestUtils/private/testhttpserver_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QQmlComponent>
+#include <QScopeGuard>
+#include <QTemporaryDir>
 
 class tst_QQMLTypeLoader : public QQmlDataTest
 {
@@ -47,6 +50,9 @@ private slots:
     void circularDependency();
     void declarativeCppAndQmlDir();
     void signalHandlersAreCompatible();
+    void loadManifest();
+    void parseOnWorkerThreads_data();
+    void parseOnWorkerThreads();
 
 private:
     void checkSingleton(const QString & dataDirectory);
@@ -724,6 +730,180 @@ void tst_QQMLTypeLoader::signalHandlersAreCompatible()
     QVERIFY(unitFromCachegen->url() != unitFromTypeCompiler->url());
 }
 
+void tst_QQMLTypeLoader::loadManifest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString manifestPath = dir.filePath(QStringLiteral("manifest"));
+    qputenv("QML_LOAD_MANIFEST", manifestPath.toLocal8Bit());
+    const auto cleanup = qScopeGuard([]() { qunsetenv("QML_LOAD_MANIFEST"); });
+
+    const auto load = [this]() {
+        QQmlEngine engine;
+        engine.addImportPath(testFile("imports"));
+        QQmlComponent component(&engine, testFileUrl("implicitimporttest.qml"));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    };
+
+    load();
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(QFile::exists(manifestPath));
+
+    QQmlLoadManifest manifest(manifestPath);
+    QVERIFY(manifest.load());
+    const QList<QQmlLoadManifest::Entry> entries = manifest.loadedEntries();
+    QVERIFY(!entries.isEmpty());
+    QCOMPARE(entries.first().kind, QQmlLoadManifest::Source);
+    QVERIFY(entries.first().filePath.endsWith(QLatin1String("/implicitimporttest.qml")));
+    QVERIFY(std::any_of(entries.begin(), entries.end(), [](const QQmlLoadManifest::Entry &entry) {
+        return entry.kind == QQmlLoadManifest::Qmldir
+                && entry.filePath.endsWith(QLatin1String("/modulewithimplicitimport/qmldir"));
+    }));
+
+    // The second run prefetches the same files and has nothing new to record.
+    const QDateTime modified = QFileInfo(manifestPath).lastModified();
+    load();
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(QFileInfo(manifestPath).lastModified(), modified);
+    QVERIFY(manifest.load());
+    QCOMPARE(manifest.loadedEntries(), entries);
+}
+
+void tst_QQMLTypeLoader::parseOnWorkerThreads_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+}
+
+void tst_QQMLTypeLoader::parseOnWorkerThreads()
+{
+    QFETCH(int, threads);
+
+    // Read when the engine's type loader is created.
+    qputenv("QML_TYPELOADER_THREADS", QByteArray::number(threads));
+    const auto resetThreads = qScopeGuard([] { qunsetenv("QML_TYPELOADER_THREADS"); });
+
+    // Fresh paths, so that everything is parsed from source rather than loaded
+    // from the disk cache. Each load gets a directory of its own, as the first
+    // one may populate the cache.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto writeFiles = [&dir](const QString &subDir, const QList<std::pair<QString, QByteArray>> &files) {
+        if (!QDir(dir.path()).mkpath(subDir))
+            return false;
+        for (const auto &[name, contents] : files) {
+            QFile f(dir.filePath(subDir + QLatin1Char('/') + name));
+            if (!f.open(QIODevice::WriteOnly) || f.write(contents) != contents.size())
+                return false;
+        }
+        return true;
+    };
+    const auto fileUrl = [&dir](const QString &subDir, const QString &name) {
+        return QUrl::fromLocalFile(dir.filePath(subDir + QLatin1Char('/') + name));
+    };
+
+    // Two types that import the same script, which imports another one.
+    const QList<std::pair<QString, QByteArray>> valid = {
+        { "helper.js", ".pragma library\nfunction twice(x) { return 2 * x; }\n" },
+        { "lib.js", ".import \"helper.js\" as Helper\nfunction value(x) { return Helper.twice(x) + 1; }\n" },
+        { "First.qml", "import QtQml\nimport \"lib.js\" as Lib\nQtObject { property int value: Lib.value(1) }\n" },
+        { "Second.qml", "import QtQml\nimport \"lib.js\" as Lib\nQtObject { property int value: Lib.value(2) }\n" },
+        { "main.qml", "import QtQml\nQtObject {\n"
+                      "    property QtObject first: First {}\n"
+                      "    property QtObject second: Second {}\n"
+                      "    property int sum: first.value + second.value\n"
+                      "}\n" },
+    };
+
+    // A synchronous load completes within the load call, no matter how many
+    // files are parsed on worker threads.
+    QVERIFY(writeFiles("sync", valid));
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, fileUrl("sync", "main.qml"));
+        QCOMPARE(component.status(), QQmlComponent::Ready);
+        QScopedPointer<QObject> o(component.create());
+        QVERIFY(o);
+        QCOMPARE(o->property("sum").toInt(), 8);
+    }
+
+    QVERIFY(writeFiles("async", valid));
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, fileUrl("async", "main.qml"), QQmlComponent::Asynchronous);
+        QTRY_COMPARE(component.status(), QQmlComponent::Ready);
+        QScopedPointer<QObject> o(component.create());
+        QVERIFY(o);
+        QCOMPARE(o->property("sum").toInt(), 8);
+    }
+
+    // Errors found while parsing are reported by the file that has them, and
+    // fail the files that depend on it.
+    QVERIFY(writeFiles("errors", {
+        { "Broken.qml", "import QtQml\nQtObject {\n    property int value: (1 +\n}\n" },
+        { "usesBroken.qml", "import QtQml\nQtObject { property QtObject broken: Broken {} }\n" },
+        { "broken.js", "function f( {\n" },
+        { "usesBrokenScript.qml", "import QtQml\nimport \"broken.js\" as Broken\nQtObject {}\n" },
+        { "importsMissing.js", ".import \"missing.js\" as Missing\nfunction f() { return 1; }\n" },
+        { "usesMissingImport.qml", "import QtQml\nimport \"importsMissing.js\" as Lib\nQtObject { property int value: Lib.f() }\n" },
+    }));
+    const auto verifyError = [&](const QString &file, const QString &failing) {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, fileUrl("errors", file), QQmlComponent::Asynchronous);
+        QTRY_COMPARE(component.status(), QQmlComponent::Error);
+        const QList<QQmlError> errors = component.errors();
+        const bool found = std::any_of(errors.cbegin(), errors.cend(), [&](const QQmlError &error) {
+            return error.url().fileName() == failing || error.description().contains(failing);
+        });
+        QVERIFY2(found, qPrintable(component.errorString()));
+    };
+    verifyError("usesBroken.qml", "Broken.qml");
+    if (QTest::currentTestFailed())
+        return;
+    verifyError("usesBrokenScript.qml", "broken.js");
+    if (QTest::currentTestFailed())
+        return;
+    verifyError("usesMissingImport.qml", "missing.js");
+    if (QTest::currentTestFailed())
+        return;
+
+    // A syntax error is reported with its position.
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, fileUrl("errors", "Broken.qml"));
+        QVERIFY(component.isError());
+        const QQmlError error = component.errors().first();
+        QCOMPARE(error.url(), fileUrl("errors", "Broken.qml"));
+        QVERIFY(error.line() >= 3);
+    }
+
+    // Types that depend on each other are detected as such, and do not keep
+    // the type loader waiting for each other.
+    QVERIFY(writeFiles("cycle", {
+        { "CycleA.qml", "import QtQml\nCycleB {}\n" },
+        { "CycleB.qml", "import QtQml\nCycleA {}\n" },
+        { "main.qml", valid.last().second },
+        { "First.qml", valid.at(2).second },
+        { "Second.qml", valid.at(3).second },
+        { "lib.js", valid.at(1).second },
+        { "helper.js", valid.at(0).second },
+    }));
+    {
+        QQmlEngine engine;
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cyclic dependency detected between (.*) and (.*)"));
+        QQmlComponent cycle(&engine, fileUrl("cycle", "CycleA.qml"));
+        QVERIFY(!cycle.isReady());
+        QVERIFY(!cycle.isLoading());
+
+        QQmlComponent component(&engine, fileUrl("cycle", "main.qml"));
+        QCOMPARE(component.status(), QQmlComponent::Ready);
+    }
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
@@ -0,0 +1,12 @@
+import QtQml
+
+QtObject {
+    function sum(n) {
+        let result = 0;
+        for (let i = 0; i < n; ++i)
+            result += i;
+        return result;
+    }
+
+    property int result: sum(100)
+}
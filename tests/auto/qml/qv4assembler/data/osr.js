@@ -0,0 +1,129 @@
+// Each function is called once and runs its loops far more often than QV4_JIT_LOOP_THRESHOLD,
+// so that the frame moves from the interpreter into the jitted code in the middle of a loop.
+
+function locals() {
+    let i = 0, d = 0.5, s = "", o = { n: 0 }, a = [], b = false, u, n = null, big = 2147483640;
+    for (; i < 100; ++i) {
+        d += 0.25;
+        s += i % 10;
+        o.n += i;
+        if (i % 7 === 0)
+            a.push(i);
+        b = !b;
+        if (i === 50)
+            u = "set";
+        big += 1;
+    }
+    return JSON.stringify([i, d, s, o.n, a, b, u, n, big]);
+}
+
+function captured() {
+    let sum = 0;
+    const fns = [];
+    for (let i = 0; i < 100; ++i) {
+        sum += i;
+        if (i % 25 === 0)
+            fns.push(() => sum + i);
+    }
+    return JSON.stringify([sum, fns.map(f => f())]);
+}
+
+function args(x, y) {
+    for (let i = 0; i < 100; ++i) {
+        x += y;
+        y = -y * 1.5;
+    }
+    return JSON.stringify([x, y, arguments.length]);
+}
+
+function exceptions() {
+    let caught = 0;
+    const log = [];
+    for (let i = 0; i < 100; ++i) {
+        try {
+            if (i % 10 === 3)
+                throw new Error("e" + i);
+            log.push(i & 1);
+        } catch (e) {
+            ++caught;
+            log.push(e.message);
+        } finally {
+            log.push("f");
+        }
+    }
+    return JSON.stringify([caught, log.length, log.slice(0, 12)]);
+}
+
+function throwsOut() {
+    for (let i = 0;; ++i) {
+        if (i === 77)
+            throw new RangeError("out at " + i);
+    }
+}
+
+function catchOutside() {
+    try {
+        throwsOut();
+    } catch (e) {
+        return e.name + ": " + e.message;
+    }
+    return "not thrown";
+}
+
+function breakContinue() {
+    const out = [];
+    outer: for (let i = 0; i < 20; ++i) {
+        for (let j = 0; j < 20; ++j) {
+            if (j === i)
+                continue outer;
+            if (i * j > 200)
+                break outer;
+            if ((i + j) % 3 === 0)
+                continue;
+            out.push(i * j);
+        }
+    }
+    let k = 0;
+    while (true) {
+        if (++k > 60)
+            break;
+    }
+    let m = 0;
+    do {
+        m += 3;
+    } while (m < 100);
+    return JSON.stringify([out.length, out.reduce((x, y) => x + y, 0), k, m]);
+}
+
+function nested() {
+    let total = 0;
+    for (let i = 0; i < 30; ++i) {
+        for (let j = 0; j < 30; ++j) {
+            for (let k = 0; k < 3; ++k)
+                total += (i ^ j ^ k) / 2;
+        }
+    }
+    return total;
+}
+
+function iterators() {
+    let sum = 0;
+    for (const v of [...Array(100).keys()])
+        sum += v;
+    const o = {};
+    for (let i = 0; i < 50; ++i)
+        o["k" + i] = i;
+    let keys = 0;
+    for (const k in o)
+        keys += o[k];
+    return JSON.stringify([sum, keys]);
+}
+
+console.log("locals: " + locals());
+console.log("captured: " + captured());
+console.log("args: " + args(1, 2, 3));
+console.log("exceptions: " + exceptions());
+console.log("catchOutside: " + catchOutside());
+console.log("breakContinue: " + breakContinue());
+console.log("nested: " + nested());
+console.log("iterators: " + iterators());
@@ -5,9 +5,12 @@
 #if QT_CONFIG(process)
 #include <QtCore/qprocess.h>
 #endif
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
+#include <QtQml/qjsengine.h>
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlapplicationengine.h>
+#include <QtQml/qqmlcomponent.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
 #include <private/qv4global_p.h>
@@ -28,6 +31,14 @@ private slots:
     void perfMapFile();
     void functionTable();
     void jitEnabled();
+    void optimizingTier();
+    void optimizingTierIntegerDivision();
+    void onStackReplacement();
+    void jitCodeCache();
+    void jitCodeCacheChecksum();
+
+private:
+    QTemporaryDir cacheDir;
 };
 
 tst_QV4Assembler::tst_QV4Assembler()
@@ -38,6 +49,10 @@ tst_QV4Assembler::tst_QV4Assembler()
 void tst_QV4Assembler::initTestCase()
 {
     qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    qputenv("QV4_JIT_OPTIMIZE_THRESHOLD", "1");
+    QVERIFY(cacheDir.isValid());
+    qputenv("QML_DISK_CACHE", "qmlc,jit");
+    qputenv("QML_DISK_CACHE_PATH", cacheDir.path().toLocal8Bit());
     QQmlDataTest::initTestCase();
 }
 
@@ -143,6 +158,177 @@ void tst_QV4Assembler::jitEnabled()
 #endif
 }
 
+void tst_QV4Assembler::optimizingTier()
+{
+    // The warm-up calls make the optimizing tier speculate on doubles. The guards then have to
+    // route everything else through the generic paths.
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(QStringLiteral(R"(
+        function arith(a, b) {
+            return [a + b, a - b, a * b, a / b, a < b, a <= b, a > b, a >= b].join();
+        }
+        for (let i = 0; i < 100; ++i)
+            arith(1.5, 0.5);
+        [arith(1.5, 0.5), arith(0.1, 0.2), arith(3, 4), arith(2147483647, 1), arith(1, 0),
+         arith(NaN, 1), arith("a", 1)];
+    )"));
+    QVERIFY(!result.isError());
+
+    const QStringList expected = {
+        QStringLiteral("2,1,0.75,3,false,false,true,true"),
+        QStringLiteral("0.30000000000000004,-0.1,0.020000000000000004,0.5,true,true,false,false"),
+        QStringLiteral("7,-1,12,0.75,true,true,false,false"),
+        QStringLiteral("2147483648,2147483646,2147483647,2147483647,false,false,true,true"),
+        QStringLiteral("1,1,0,Infinity,false,false,true,true"),
+        QStringLiteral("NaN,NaN,NaN,NaN,false,false,false,false"),
+        QStringLiteral("a1,NaN,NaN,NaN,false,false,false,false")
+    };
+    QCOMPARE(result.toVariant().toStringList(), expected);
+}
+
+void tst_QV4Assembler::optimizingTierIntegerDivision()
+{
+    // Divisions of integers with integral results are recorded as such. Once the function is
+    // optimized for them, fractions, -0, overflows and non-numbers still have to come out right.
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(QStringLiteral(R"(
+        function divide(a, b) { return a / b; }
+        for (let i = 1; i < 100; ++i)
+            divide(i * 6, 3);
+        [divide(12, 4), divide(7, 2), divide(0, -5), divide(-2147483648, -1), divide(1, 0),
+         divide(6, "3"), divide({}, 1)].map(v => Object.is(v, -0) ? "-0" : String(v));
+    )"));
+    QVERIFY(!result.isError());
+
+    const QStringList expected = {
+        QStringLiteral("3"), QStringLiteral("3.5"), QStringLiteral("-0"),
+        QStringLiteral("2147483648"), QStringLiteral("Infinity"), QStringLiteral("2"),
+        QStringLiteral("NaN")
+    };
+    QCOMPARE(result.toVariant().toStringList(), expected);
+}
+
+#if QT_CONFIG(process)
+static QByteArray runQmljs(const QString &file, const QList<QPair<QString, QString>> &variables,
+                           qint64 *pid)
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.remove("QV4_JIT_CALL_THRESHOLD");
+    environment.remove("QML_DISK_CACHE");
+    for (const auto &variable : variables)
+        environment.insert(variable.first, variable.second);
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.start(QLibraryInfo::path(QLibraryInfo::BinariesPath) + "/qmljs", { file });
+    if (!process.waitForStarted())
+        return QByteArray();
+    *pid = process.processId();
+    if (!process.waitForFinished() || process.exitCode() != 0)
+        return QByteArray();
+    return process.readAllStandardError();
+}
+#endif
+
+void tst_QV4Assembler::onStackReplacement()
+{
+#if !QT_CONFIG(process)
+    QSKIP("Depends on QProcess");
+#elif !QT_CONFIG(qml_jit)
+    QSKIP("Without the JIT there is nothing to move the loops into.");
+#else
+    // Run the same loops once in the interpreter only, and once in a way that only jits them
+    // through their loop headers, and compare what they compute.
+    const QString file = testFile("osr.js");
+    qint64 pid = 0;
+    const QByteArray interpreted = runQmljs(file, { { "QV4_FORCE_INTERPRETER", "1" } }, &pid);
+    QCOMPARE(interpreted.count('\n'), qsizetype(8));
+
+    const QByteArray jitted = runQmljs(file, {
+                                           { "QV4_JIT_CALL_THRESHOLD", "1000000" },
+                                           { "QV4_JIT_LOOP_THRESHOLD", "5" },
+                                           { "QV4_PROFILE_WRITE_PERF_MAP", "1" }
+                                       }, &pid);
+    QCOMPARE(jitted, interpreted);
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    // None of the functions is called often enough to be jitted on the call count.
+    QFile perfMap(QString::fromLatin1("/tmp/perf-%1.map").arg(pid));
+    QVERIFY(perfMap.open(QIODevice::ReadOnly));
+    QList<QByteArray> functions;
+    while (!perfMap.atEnd())
+        functions.append(perfMap.readLine().split(' ').last().trimmed());
+    for (const char *name : { "locals", "captured", "args", "throwsOut", "breakContinue",
+                              "nested" }) {
+        QVERIFY2(functions.contains(name), name);
+    }
+#endif
+#endif
+}
+
+static void runJitCodeCacheComponent(const QUrl &url)
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, url);
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    std::unique_ptr<QObject> object(component.create());
+    QVERIFY(object);
+    QCOMPARE(object->property("result").toInt(), 4950);
+
+    QVariant sum;
+    QVERIFY(QMetaObject::invokeMethod(object.get(), "sum", Q_RETURN_ARG(QVariant, sum),
+                                      Q_ARG(QVariant, 10)));
+    QCOMPARE(sum.toInt(), 45);
+}
+
+void tst_QV4Assembler::jitCodeCache()
+{
+#if !QT_CONFIG(qml_jit)
+    QSKIP("Without the JIT there is no code to cache.");
+#else
+    // The first engine writes the JIT code next to the .qmlc file, the second one runs it.
+    for (int run = 0; run < 2; ++run) {
+        runJitCodeCacheComponent(testFileUrl("jitCodeCache.qml"));
+        if (QTest::currentTestFailed())
+            return;
+    }
+
+    const QStringList jitFiles = QDir(cacheDir.path()).entryList({ QStringLiteral("*.qmljit") });
+    QCOMPARE(jitFiles.size(), 1);
+#endif
+}
+
+void tst_QV4Assembler::jitCodeCacheChecksum()
+{
+#if !QT_CONFIG(qml_jit)
+    QSKIP("Without the JIT there is no code to cache.");
+#else
+    runJitCodeCacheComponent(testFileUrl("jitCodeCache.qml"));
+    if (QTest::currentTestFailed())
+        return;
+
+    const QStringList jitFiles = QDir(cacheDir.path()).entryList({ QStringLiteral("*.qmljit") });
+    QCOMPARE(jitFiles.size(), 1);
+    QFile file(QDir(cacheDir.path()).filePath(jitFiles.first()));
+
+    // Flip a byte in the middle of the file, which is in the code of one of the functions.
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray corrupted = file.readAll();
+    file.close();
+    corrupted[corrupted.size() / 2] = ~corrupted.at(corrupted.size() / 2);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(corrupted), corrupted.size());
+    file.close();
+
+    // The file is rejected, so the functions are compiled again and the file is rewritten.
+    runJitCodeCacheComponent(testFileUrl("jitCodeCache.qml"));
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll() != corrupted);
+#endif
+}
+
 QTEST_MAIN(tst_QV4Assembler)
 
 #include "tst_qv4assembler.moc"
@@ -5,6 +5,7 @@
 #include <QQmlEngine>
 #include <QLoggingCategory>
 #include <QQmlComponent>
+#include <QJSEngine>
 
 #include <private/qv4mm_p.h>
 #include <private/qv4qobjectwrapper_p.h>
@@ -27,6 +28,7 @@ private slots:
     void accessParentOnDestruction();
     void cleanInternalClasses();
     void createObjectsOnDestruction();
+    void backgroundSweep();
 };
 
 tst_qv4mm::tst_qv4mm()
@@ -206,6 +208,54 @@ void tst_qv4mm::createObjectsOnDestruction()
     QCOMPARE(obj->property("ok").toBool(), true);
 }
 
+void tst_qv4mm::backgroundSweep()
+{
+#if !QT_CONFIG(thread)
+    QSKIP("Sweeping in the background needs threads.");
+#endif
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    if (mm->aggressiveGC || mm->gcStats || mm->gcCollectorStats)
+        QSKIP("The GC statistics and QV4_MM_AGGRESSIVE_GC always sweep synchronously.");
+
+    // Keep enough chunks alive for the allocation triggered collections to sweep in the
+    // background.
+    QJSValue result = engine.evaluate(QStringLiteral(R"(
+        var live = [];
+        for (var i = 0; i < 50000; ++i)
+            live.push({ index: i, name: "item" + i });
+    )"));
+    QVERIFY(!result.isError());
+    QVERIFY(mm->canSweepInBackground());
+
+    // Keep allocating while they sweep.
+    const uint backgroundSweeps = mm->statistics.backgroundSweeps;
+    result = engine.evaluate(QStringLiteral(R"(
+        var ok = true;
+        for (var round = 0; round < 10; ++round) {
+            for (var k = 0; k < 50000; ++k)
+                live[k] = { index: k, name: "item" + k, previous: live[k].name };
+            for (var m = 0; m < 50000; m += 97) {
+                if (live[m].index !== m || live[m].previous !== "item" + m)
+                    ok = false;
+            }
+        }
+        ok;
+    )"));
+
+    QVERIFY(!result.isError());
+    QVERIFY(result.toBool());
+    QVERIFY(mm->statistics.backgroundSweeps > backgroundSweeps);
+
+    // An explicit collection waits for any pending sweep and sweeps synchronously.
+    const uint sweepsBeforeRunGC = mm->statistics.backgroundSweeps;
+    mm->runGC();
+    QCOMPARE(mm->statistics.backgroundSweeps, sweepsBeforeRunGC);
+    QVERIFY(!mm->m_backgroundSweepRunning);
+    QVERIFY(!mm->blockAllocator.hasPendingSweep());
+    QVERIFY(!mm->icAllocator.hasPendingSweep());
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 
 #include <QtCore/QString>
+#include <QtCore/qscopeguard.h>
 #include <QtTest/QtTest>
 
 #include <QtQuick/qsgnode.h>
+#include <QtQuick/qquickgraphicsconfiguration.h>
 #include <QtQuick/private/qsgbatchrenderer_p.h>
 #include <QtQuick/private/qsgnodeupdater_p.h>
 #include <QtQuick/private/qsgrenderloop_p.h>
@@ -12,6 +14,7 @@
 
 #include <QtQuick/qsgsimplerectnode.h>
 #include <QtQuick/qsgsimpletexturenode.h>
+#include <QtQuick/qsgimagenode.h>
 #include <QtQuick/private/qsgplaintexture_p.h>
 
 #include <QtGui/private/qguiapplication_p.h>
@@ -81,8 +84,22 @@ private Q_SLOTS:
     void textureNodeRect_data();
     void textureNodeRect();
 
+    void vertexKernels_data();
+    void vertexKernels();
+
+    void parallelBatchUpload_data();
+    void parallelBatchUpload();
+    void retainedBatches_data();
+    void retainedBatches();
+    void atlasDefragmentation_data();
+    void atlasDefragmentation();
+
 private:
     void rhiTestData();
+    void nullRhiTestData();
+    bool renderOffscreen(QRhi *rhi, QSGBatchRenderer::Renderer *renderer,
+                         const QQuickGraphicsConfiguration &config);
+    QList<QByteArray> uploadedBatchData(QRhi *rhi, QSGBatchRenderer::Renderer *renderer);
 
     QSGDefaultRenderContext *renderContext = nullptr;
 
@@ -489,6 +506,485 @@ void NodesTest::textureNodeRect()
     renderContext->invalidate();
 }
 
+void NodesTest::vertexKernels_data()
+{
+    QTest::addColumn<int>("vertexCount");
+    QTest::addColumn<int>("vertexSize");
+
+    // Odd counts leave a tail for the scalar loop after the SIMD ones.
+    const int vertexSizes[] = { int(sizeof(QSGGeometry::Point2D)),
+                                int(sizeof(QSGGeometry::ColoredPoint2D)),
+                                int(sizeof(QSGGeometry::TexturedPoint2D)) };
+    for (int vertexSize : vertexSizes) {
+        for (int vertexCount : { 0, 1, 2, 3, 4, 5, 7, 16, 17 }) {
+            QTest::addRow("%d vertices of %d bytes", vertexCount, vertexSize)
+                    << vertexCount << vertexSize;
+        }
+    }
+}
+
+void NodesTest::vertexKernels()
+{
+    QFETCH(int, vertexCount);
+    QFETCH(int, vertexSize);
+
+    using QSGBatchRenderer::Pt;
+
+    // Each vertex starts with its position. The bytes after it must not change.
+    QByteArray original(vertexCount * vertexSize, Qt::Uninitialized);
+    for (int i = 0; i < original.size(); ++i)
+        original[i] = char(i * 7 + 3);
+    for (int i = 0; i < vertexCount; ++i) {
+        Pt *p = reinterpret_cast<Pt *>(original.data() + i * vertexSize);
+        p->set(i * 13.5f - 40.0f, 100.25f - i * 3.0f);
+    }
+
+    auto compareVertices = [&](const QByteArray &actual, const QByteArray &expected) {
+        for (int i = 0; i < vertexCount; ++i) {
+            const int offset = i * vertexSize;
+            const Pt *a = reinterpret_cast<const Pt *>(actual.constData() + offset);
+            const Pt *e = reinterpret_cast<const Pt *>(expected.constData() + offset);
+            // The scalar code may be compiled into fused multiply-adds, the SIMD code isn't.
+            QVERIFY2(qAbs(a->x - e->x) <= 1e-4f * qMax(1.0f, qAbs(e->x))
+                     && qAbs(a->y - e->y) <= 1e-4f * qMax(1.0f, qAbs(e->y)),
+                     qPrintable(QStringLiteral("vertex %1: (%2, %3) instead of (%4, %5)")
+                                .arg(i).arg(a->x).arg(a->y).arg(e->x).arg(e->y)));
+            QCOMPARE(actual.mid(offset + sizeof(Pt), vertexSize - sizeof(Pt)),
+                     expected.mid(offset + sizeof(Pt), vertexSize - sizeof(Pt)));
+        }
+    };
+
+    QByteArray translated = original;
+    QSGBatchRenderer::qsg_translateVertices(translated.data(), vertexCount, vertexSize,
+                                            12.5f, -7.25f);
+    QByteArray expected = original;
+    for (int i = 0; i < vertexCount; ++i) {
+        Pt *p = reinterpret_cast<Pt *>(expected.data() + i * vertexSize);
+        p->x += 12.5f;
+        p->y += -7.25f;
+    }
+    compareVertices(translated, expected);
+    if (QTest::currentTestFailed())
+        return;
+
+    QMatrix4x4 matrix;
+    matrix.translate(30.0f, -15.0f);
+    matrix.rotate(33.0f, 0.0f, 0.0f, 1.0f);
+    matrix.scale(1.5f, 0.75f);
+    QByteArray mapped = original;
+    QSGBatchRenderer::qsg_mapVertices(mapped.data(), vertexCount, vertexSize, matrix);
+    expected = original;
+    for (int i = 0; i < vertexCount; ++i)
+        reinterpret_cast<Pt *>(expected.data() + i * vertexSize)->map(matrix);
+    compareVertices(mapped, expected);
+}
+
+/* Renders one frame of \a renderer into an offscreen texture. Only the
+   preparation done on the CPU matters here, so the contents of the texture are
+   never looked at.
+ */
+bool NodesTest::renderOffscreen(QRhi *rhi, QSGBatchRenderer::Renderer *renderer,
+                                const QQuickGraphicsConfiguration &config)
+{
+    const QSize size(512, 512);
+    QScopedPointer<QRhiTexture> texture(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                        QRhiTexture::RenderTarget));
+    if (!texture->create())
+        return false;
+    QScopedPointer<QRhiRenderBuffer> depthStencil(
+            rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size));
+    if (!depthStencil->create())
+        return false;
+    QRhiTextureRenderTargetDescription description(texture.data());
+    description.setDepthStencilBuffer(depthStencil.data());
+    QScopedPointer<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget(description));
+    QScopedPointer<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rpDesc.data());
+    if (!rt->create())
+        return false;
+
+    QRhiCommandBuffer *cb = nullptr;
+    if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+        return false;
+    renderContext->prepareSync(1.0, cb, config);
+    renderer->setDeviceRect(size);
+    renderer->setViewportRect(size);
+    renderer->setProjectionMatrixToRect(QRectF(QPointF(), size));
+    renderContext->beginNextFrame(renderer, { rt.data(), rpDesc.data(), cb },
+                                  nullptr, nullptr, nullptr);
+    renderContext->renderNextFrame(renderer);
+    renderContext->endNextFrame(renderer);
+    renderer->setRenderTarget({});
+    return rhi->endOffscreenFrame() == QRhi::FrameOpSuccess;
+}
+
+/* Reads back the vertex and index data the last frame of \a renderer
+   uploaded, batch by batch.
+ */
+QList<QByteArray> NodesTest::uploadedBatchData(QRhi *rhi, QSGBatchRenderer::Renderer *renderer)
+{
+    const auto readBack = [rhi](const QSGBatchRenderer::Buffer &buffer) {
+        if (!buffer.buf || buffer.size == 0)
+            return QByteArray();
+        QRhiCommandBuffer *cb = nullptr;
+        if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return QByteArray();
+        QRhiBufferReadbackResult result;
+        QRhiResourceUpdateBatch *updates = rhi->nextResourceUpdateBatch();
+        updates->readBackBuffer(buffer.buf, 0, buffer.size, &result);
+        cb->resourceUpdate(updates);
+        rhi->endOffscreenFrame();
+        return result.data;
+    };
+
+    QList<QByteArray> data;
+    for (const auto *batches : { &renderer->m_opaqueBatches, &renderer->m_alphaBatches }) {
+        for (int i = 0; i < batches->size(); ++i) {
+            const QSGBatchRenderer::Batch *b = batches->at(i);
+            data << readBack(b->vbo) << readBack(b->ibo);
+        }
+    }
+    return data;
+}
+
+// For tests that look at what the renderer prepares on the CPU rather than at
+// what ends up on screen, one backend is enough. The Null backend keeps the
+// contents of buffers, so they can be read back.
+void NodesTest::nullRhiTestData()
+{
+    QTest::addColumn<QRhi::Implementation>("impl");
+    QTest::addColumn<QRhiInitParams *>("initParams");
+
+    QTest::newRow("Null") << QRhi::Null << static_cast<QRhiInitParams *>(&initParams.null);
+}
+
+void NodesTest::parallelBatchUpload_data()
+{
+    nullRhiTestData();
+}
+
+void NodesTest::parallelBatchUpload()
+{
+    INIT_RHI();
+    if (!rhi->isFeatureSupported(QRhi::ReadBackNonUniformBuffer))
+        QSKIP("Vertex and index buffers cannot be read back");
+
+    // Upload in parallel no matter how few batches there are.
+    qputenv("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD", "0");
+    const auto resetThreshold = qScopeGuard([] {
+        qunsetenv("QSG_RENDERER_PARALLEL_UPLOAD_THRESHOLD");
+    });
+
+    // Opaque and translucent rectangles, some of them rotated, so that there
+    // are merged batches of both kinds with transformed vertices.
+    QSGRootNode root;
+    QSGTransformNode *rotated = new QSGTransformNode;
+    QMatrix4x4 matrix;
+    matrix.translate(256, 0);
+    matrix.rotate(30, 0, 0, 1);
+    rotated->setMatrix(matrix);
+    root.appendChildNode(rotated);
+    const QColor colors[] = { Qt::red, Qt::green, Qt::blue,
+                              QColor(255, 255, 0, 128), QColor(0, 255, 255, 64) };
+    for (int i = 0; i < 256; ++i) {
+        QSGSimpleRectNode *rect = new QSGSimpleRectNode(
+                QRectF((i % 16) * 32, (i / 16) * 32, 16 + i % 9, 24 - i % 7), colors[i % 5]);
+        if (i % 3)
+            root.appendChildNode(rect);
+        else
+            rotated->appendChildNode(rect);
+    }
+
+    QQuickGraphicsConfiguration serialConfig;
+    QQuickGraphicsConfiguration parallelConfig;
+    parallelConfig.setParallelBatchUpload(true);
+
+    QSGBatchRenderer::Renderer serialRenderer(renderContext);
+    serialRenderer.setRootNode(&root);
+    QVERIFY(renderOffscreen(rhi.data(), &serialRenderer, serialConfig));
+    QVERIFY(!serialRenderer.m_uploadThreadPool);
+
+    QSGBatchRenderer::Renderer parallelRenderer(renderContext);
+    parallelRenderer.setRootNode(&root);
+    QVERIFY(renderOffscreen(rhi.data(), &parallelRenderer, parallelConfig));
+    QVERIFY(parallelRenderer.m_uploadThreadPool);
+
+    QCOMPARE(parallelRenderer.m_opaqueBatches.size(), serialRenderer.m_opaqueBatches.size());
+    QCOMPARE(parallelRenderer.m_alphaBatches.size(), serialRenderer.m_alphaBatches.size());
+    QVERIFY(serialRenderer.m_opaqueBatches.size() > 0);
+    QVERIFY(serialRenderer.m_alphaBatches.size() > 0);
+    const QList<QByteArray> serialData = uploadedBatchData(rhi.data(), &serialRenderer);
+    QCOMPARE(uploadedBatchData(rhi.data(), &parallelRenderer), serialData);
+
+    // Changing a few nodes re-uploads only some of the batches.
+    int childIndex = 0;
+    for (QSGNode *child = root.firstChild(); child; child = child->nextSibling(), ++childIndex) {
+        if (child->type() == QSGNode::GeometryNodeType && childIndex % 4 == 0)
+            static_cast<QSGSimpleRectNode *>(child)->setRect(childIndex, 0, 8, 8);
+    }
+    QVERIFY(renderOffscreen(rhi.data(), &serialRenderer, serialConfig));
+    QVERIFY(renderOffscreen(rhi.data(), &parallelRenderer, parallelConfig));
+    QCOMPARE(uploadedBatchData(rhi.data(), &parallelRenderer),
+             uploadedBatchData(rhi.data(), &serialRenderer));
+    QVERIFY(uploadedBatchData(rhi.data(), &serialRenderer) != serialData);
+
+    renderContext->invalidate();
+}
+
+static bool containsBatch(const QDataBuffer<QSGBatchRenderer::Batch *> &batches,
+                          const QSGBatchRenderer::Batch *batch)
+{
+    for (int i = 0; i < batches.size(); ++i) {
+        if (batches.at(i) == batch)
+            return true;
+    }
+    return false;
+}
+
+static int elementCount(const QSGBatchRenderer::Batch *batch)
+{
+    int count = 0;
+    for (QSGBatchRenderer::Element *e = batch->first; e; e = e->nextInBatch)
+        ++count;
+    return count;
+}
+
+void NodesTest::retainedBatches_data()
+{
+    nullRhiTestData();
+}
+
+void NodesTest::retainedBatches()
+{
+    INIT_RHI();
+
+    QSGRootNode root;
+    QList<QSGSimpleRectNode *> rects;
+    for (int i = 0; i < 8; ++i) {
+        rects.append(new QSGSimpleRectNode(QRectF(i * 40, 0, 32, 32), Qt::red));
+        root.appendChildNode(rects.last());
+    }
+    const QQuickGraphicsConfiguration config;
+
+    // By default, static and changing nodes are merged as before.
+    {
+        QSGBatchRenderer::Renderer renderer(renderContext);
+        renderer.setRootNode(&root);
+        for (int frame = 0; frame < 3; ++frame)
+            QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+        QCOMPARE(renderer.m_opaqueBatches.size(), 1);
+        rects.at(0)->setRect(0, 40, 32, 32);
+        QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+        QCOMPARE(renderer.m_opaqueBatches.size(), 1);
+        QCOMPARE(elementCount(renderer.m_opaqueBatches.at(0)), 8);
+        QVERIFY(!renderer.m_opaqueBatches.at(0)->retained);
+    }
+
+    qputenv("QSG_RENDERER_RETAIN_FRAME_THRESHOLD", "2");
+    const auto resetThreshold = qScopeGuard([] {
+        qunsetenv("QSG_RENDERER_RETAIN_FRAME_THRESHOLD");
+    });
+
+    // Without a depth buffer, the vertex data does not depend on the render
+    // order, so retained batches survive nodes being added.
+    QSGBatchRenderer::Renderer renderer(renderContext,
+                                        QSGRendererInterface::RenderMode2DNoDepthBuffer);
+    renderer.setRootNode(&root);
+
+    // Static nodes are only told apart from changing ones when a batch has to
+    // be uploaded again.
+    for (int frame = 0; frame < 3; ++frame)
+        QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QCOMPARE(renderer.m_opaqueBatches.size(), 1);
+    QVERIFY(!renderer.m_opaqueBatches.at(0)->retained);
+
+    rects.at(0)->setRect(0, 80, 32, 32);
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QCOMPARE(renderer.m_opaqueBatches.size(), 2);
+    QSGBatchRenderer::Batch *retained = nullptr;
+    QSGBatchRenderer::Batch *changing = nullptr;
+    for (int i = 0; i < renderer.m_opaqueBatches.size(); ++i) {
+        QSGBatchRenderer::Batch *b = renderer.m_opaqueBatches.at(i);
+        (b->retained ? retained : changing) = b;
+    }
+    QVERIFY(retained);
+    QVERIFY(changing);
+    QCOMPARE(elementCount(retained), 7);
+    QCOMPARE(elementCount(changing), 1);
+
+    // Changing the same node again only uploads its own batch.
+    rects.at(0)->setRect(0, 120, 32, 32);
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QCOMPARE(renderer.m_opaqueBatches.size(), 2);
+    QVERIFY(containsBatch(renderer.m_opaqueBatches, retained));
+    QVERIFY(containsBatch(renderer.m_opaqueBatches, changing));
+    QCOMPARE(renderer.lastFrameUploadBytes(), qint64(changing->vbo.size + changing->ibo.size));
+
+    // Adding a node rebuilds the batches. The static nodes end up in a batch
+    // just like the retained one, which is then reused with its buffers.
+    QSGSimpleRectNode *added = new QSGSimpleRectNode(QRectF(0, 160, 32, 32), Qt::red);
+    root.appendChildNode(added);
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QVERIFY(renderer.m_parkedBatches.isEmpty());
+    QCOMPARE(renderer.m_opaqueBatches.size(), 2);
+    QVERIFY(containsBatch(renderer.m_opaqueBatches, retained));
+    QVERIFY(!retained->needsUpload);
+    QCOMPARE(elementCount(retained), 7);
+    for (int i = 0; i < renderer.m_opaqueBatches.size(); ++i) {
+        const QSGBatchRenderer::Batch *b = renderer.m_opaqueBatches.at(i);
+        if (b != retained) {
+            QCOMPARE(elementCount(b), 2);
+            QCOMPARE(renderer.lastFrameUploadBytes(), qint64(b->vbo.size + b->ibo.size));
+        }
+    }
+
+    // A change in the number of vertices invalidates the batch right away.
+    // It is parked until the next frame shows whether it can be reused.
+    rects.at(1)->geometry()->allocate(6);
+    rects.at(1)->markDirty(QSGNode::DirtyGeometry);
+    QCOMPARE(renderer.m_parkedBatches.size(), 1);
+    QVERIFY(retained->parked);
+
+    // The changed node no longer belongs with the static ones, so the parked
+    // batch is not reused but recycled.
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QVERIFY(renderer.m_parkedBatches.isEmpty());
+    QVERIFY(!retained->parked);
+    QVERIFY(!containsBatch(renderer.m_opaqueBatches, retained));
+    QVERIFY(containsBatch(renderer.m_batchPool, retained));
+
+    retained = nullptr;
+    for (int i = 0; i < renderer.m_opaqueBatches.size(); ++i) {
+        if (renderer.m_opaqueBatches.at(i)->retained)
+            retained = renderer.m_opaqueBatches.at(i);
+    }
+    QVERIFY(retained);
+    QCOMPARE(elementCount(retained), 6);
+
+    // Removing a node drops the parked batches, as they may refer to it.
+    rects.at(2)->geometry()->allocate(6);
+    rects.at(2)->markDirty(QSGNode::DirtyGeometry);
+    QCOMPARE(renderer.m_parkedBatches.size(), 1);
+    delete rects.takeAt(3);
+    QVERIFY(renderer.m_parkedBatches.isEmpty());
+    QVERIFY(!retained->parked);
+
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QVERIFY(renderer.m_parkedBatches.isEmpty());
+    int renderedCount = 0;
+    for (int i = 0; i < renderer.m_opaqueBatches.size(); ++i)
+        renderedCount += elementCount(renderer.m_opaqueBatches.at(i));
+    QCOMPARE(renderedCount, 8);
+
+    renderContext->invalidate();
+}
+
+void NodesTest::atlasDefragmentation_data()
+{
+    nullRhiTestData();
+}
+
+void NodesTest::atlasDefragmentation()
+{
+    // One 512x512 atlas page, so that a fragmented page cannot be worked
+    // around by adding another one. The setting is read once, so this has to
+    // be the first test to use atlas textures.
+    qputenv("QSG_ATLAS_DEFRAGMENT", "1");
+    qputenv("QSG_ATLAS_MEMORY_BUDGET", "1");
+    const auto resetAtlas = qScopeGuard([] {
+        qunsetenv("QSG_ATLAS_DEFRAGMENT");
+        qunsetenv("QSG_ATLAS_MEMORY_BUDGET");
+    });
+
+    INIT_RHI();
+
+    // Fill the page with 64 images and release every fourth one, which
+    // leaves enough free space for a larger image, but not in one piece.
+    QImage image(62, 62, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    QList<QSGTexture *> textures;
+    for (int i = 0; i < 64; ++i) {
+        QSGTexture *t = renderContext->createTexture(image, QSGRenderContext::CreateTexture_Atlas);
+        QVERIFY(t->isAtlasTexture());
+        if (i % 4 == 0)
+            delete t;
+        else
+            textures.append(t);
+    }
+    QImage large(150, 150, QImage::Format_RGB32);
+    large.fill(Qt::blue);
+    QScopedPointer<QSGTexture> plain(renderContext->createTexture(large, QSGRenderContext::CreateTexture_Atlas));
+    QVERIFY(!plain->isAtlasTexture());
+
+    QSGRootNode root;
+    QHash<const QSGGeometryNode *, QSGTexture *> nodeTextures;
+    for (int i = 0; i < textures.size(); ++i) {
+        QSGImageNode *node = renderContext->sceneGraphContext()->createImageNode();
+        node->setTexture(textures.at(i));
+        node->setRect(QRectF((i % 8) * 64, (i / 8) * 64, 62, 62));
+        node->setSourceRect(QRectF(0, 0, 62, 62));
+        root.appendChildNode(node);
+        nodeTextures.insert(node, textures.at(i));
+    }
+
+    const qint64 oldPage = textures.first()->comparisonKey();
+    const auto pagesOf = [&textures]() {
+        QSet<qint64> pages;
+        for (const QSGTexture *t : std::as_const(textures))
+            pages.insert(t->comparisonKey());
+        return pages;
+    };
+    // Every batch has to be drawn from a single page.
+    const auto batchesUseOnePage = [&nodeTextures](QSGBatchRenderer::Renderer *renderer) {
+        for (const auto *batches : { &renderer->m_opaqueBatches, &renderer->m_alphaBatches }) {
+            for (int i = 0; i < batches->size(); ++i) {
+                QSet<qint64> pages;
+                for (QSGBatchRenderer::Element *e = batches->at(i)->first; e; e = e->nextInBatch)
+                    pages.insert(nodeTextures.value(e->node)->comparisonKey());
+                if (pages.size() > 1)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    QSGBatchRenderer::Renderer renderer(renderContext);
+    renderer.setRootNode(&root);
+    const QQuickGraphicsConfiguration config;
+
+    // Nothing moves in a frame that adds textures to the atlas.
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QCOMPARE(pagesOf(), QSet<qint64> { oldPage });
+    QCOMPARE(renderer.m_opaqueBatches.size(), 1);
+
+    // The next frame moves 32 of the 48 textures, the one after that the rest.
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    QCOMPARE(pagesOf().size(), 2);
+    QVERIFY(batchesUseOnePage(&renderer));
+    QVERIFY(renderer.m_opaqueBatches.size() >= 2);
+
+    QVERIFY(renderOffscreen(rhi.data(), &renderer, config));
+    const QSet<qint64> pages = pagesOf();
+    QCOMPARE(pages.size(), 1);
+    QVERIFY(!pages.contains(oldPage));
+    QVERIFY(batchesUseOnePage(&renderer));
+
+    // The moved textures have their geometry updated, and the free space is now
+    // in one piece.
+    for (auto it = nodeTextures.cbegin(); it != nodeTextures.cend(); ++it) {
+        const QRectF subRect = it.value()->normalizedTextureSubRect();
+        const auto *v = it.key()->geometry()->vertexDataAsTexturedPoint2D();
+        QCOMPARE(v[0].tx, float(subRect.left()));
+        QCOMPARE(v[0].ty, float(subRect.top()));
+    }
+    QScopedPointer<QSGTexture> fits(renderContext->createTexture(large, QSGRenderContext::CreateTexture_Atlas));
+    QVERIFY(fits->isAtlasTexture());
+
+    fits.reset();
+    qDeleteAll(textures);
+    renderContext->invalidate();
+}
+
 QTEST_MAIN(NodesTest);
 
 #include "tst_nodestest.moc"
@@ -9,8 +9,10 @@
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickView>
 #include <QtQuick/QQuickWindow>
+#include <QtQuick/QQuickFrameStatistics>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlComponent>
+#include <QtQuick/private/qquickframestatistics_p.h>
 #include <QtQuick/private/qquickrectangle_p.h>
 #include <QtQuick/private/qquickloader_p.h>
 #include <QtQuick/private/qquickmousearea_p.h>
@@ -547,6 +549,9 @@ private slots:
 
     void graphicsConfiguration();
 
+    void frameStatistics();
+    void incubatedObjectStatistics();
+
 private:
     QPointingDevice *touchDevice; // TODO make const after fixing QTBUG-107864
     const QPointingDevice *touchDeviceWithVelocity;
@@ -4057,6 +4062,7 @@ void tst_qquickwindow::graphicsConfiguration()
     QVERIFY(!config.isDebugMarkersEnabled());
     QVERIFY(!config.prefersSoftwareDevice());
     QVERIFY(config.isAutomaticPipelineCacheEnabled());
+    QVERIFY(!config.isParallelBatchUploadEnabled());
     QVERIFY(config.pipelineCacheSaveFile().isEmpty());
     QVERIFY(config.pipelineCacheLoadFile().isEmpty());
 
@@ -4078,11 +4084,112 @@ void tst_qquickwindow::graphicsConfiguration()
     QCOMPARE(config2.pipelineCacheSaveFile(), QLatin1String("save"));
     QCOMPARE(config2.pipelineCacheLoadFile(), QLatin1String("load"));
 
+    config.setParallelBatchUpload(true);
+    QVERIFY(config.isParallelBatchUploadEnabled());
+    QVERIFY(!config2.isParallelBatchUploadEnabled());
+    config2 = config;
+    QVERIFY(config2.isParallelBatchUploadEnabled());
+
 #if QT_CONFIG(vulkan)
     QCOMPARE(QQuickGraphicsConfiguration::preferredInstanceExtensions(), QRhiVulkanInitParams::preferredInstanceExtensions());
 #endif
 }
 
+void tst_qquickwindow::frameStatistics()
+{
+    QQuickWindow window;
+    window.setTitle(QTest::currentTestFunction());
+    window.resize(100, 100);
+
+    QQuickFrameStatistics *statistics = window.frameStatistics();
+    QVERIFY(statistics);
+    QCOMPARE(statistics->parent(), &window);
+    QCOMPARE(statistics->frameCount(), 0);
+    QCOMPARE(statistics->frameTime(), 0.0);
+    QCOMPARE(statistics->average(QQuickFrameStatistics::FrameTime), 0.0);
+    QCOMPARE(statistics->percentile(QQuickFrameStatistics::FrameTime, 95), 0.0);
+    QCOMPARE(statistics->historySize(), 120);
+
+    QSignalSpy updatedSpy(statistics, &QQuickFrameStatistics::updated);
+    QSignalSpy frameSwappedSpy(&window, &QQuickWindow::frameSwapped);
+
+    QQuickRectangle rect(window.contentItem());
+    rect.setSize(QSizeF(50, 50));
+    rect.setColor(Qt::red);
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_VERIFY(frameSwappedSpy.size() > 0);
+    QTRY_VERIFY(updatedSpy.size() > 0);
+
+    QVERIFY(statistics->frameCount() > 0);
+    QVERIFY(statistics->frameTime() >= 0);
+    QVERIFY(statistics->maximum(QQuickFrameStatistics::FrameTime) >= statistics->average(QQuickFrameStatistics::FrameTime));
+    if (window.rendererInterface()->graphicsApi() != QSGRendererInterface::Software)
+        QVERIFY(statistics->maximum(QQuickFrameStatistics::BatchCount) > 0);
+    else
+        QVERIFY(statistics->maximum(QQuickFrameStatistics::PaintedArea) > 0);
+
+    QSignalSpy historySpy(statistics, &QQuickFrameStatistics::historySizeChanged);
+    statistics->setHistorySize(4);
+    QCOMPARE(historySpy.size(), 1);
+    QCOMPARE(statistics->historySize(), 4);
+
+    statistics->reset();
+    QCOMPARE(statistics->frameCount(), 0);
+    QCOMPARE(statistics->average(QQuickFrameStatistics::FrameTime), 0.0);
+}
+
+void tst_qquickwindow::incubatedObjectStatistics()
+{
+    QQuickWindow window;
+    window.setTitle(QTest::currentTestFunction());
+    window.resize(100, 100);
+
+    QQmlEngine engine;
+    engine.setIncubationController(window.incubationController());
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick\n"
+                      "Item {\n"
+                      "    Rectangle {\n"
+                      "        width: 10; height: 10\n"
+                      "        NumberAnimation on x { from: 0; to: 50; duration: 500; loops: Animation.Infinite }\n"
+                      "    }\n"
+                      "    Loader {\n"
+                      "        asynchronous: true\n"
+                      "        active: false\n"
+                      "        sourceComponent: Item { Item {} Item {} Item {} }\n"
+                      "    }\n"
+                      "}", QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY(root);
+    root->setParentItem(window.contentItem());
+
+    QQuickFrameStatistics *statistics = window.frameStatistics();
+    statistics->setHistorySize(10000);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QQuickLoader *loader = root->findChild<QQuickLoader *>();
+    QVERIFY(loader);
+    loader->setActive(true);
+    QTRY_COMPARE(loader->status(), QQuickLoader::Ready);
+
+    // The objects are recorded with the frame that follows the time slice they
+    // were created in. The animation keeps the frames coming.
+    const auto incubatedObjects = [statistics]() {
+        int sum = 0;
+        const QList<qreal> history = QQuickFrameStatisticsPrivate::get(statistics)->history(
+                QQuickFrameStatistics::IncubatedObjects);
+        for (qreal objectCount : history)
+            sum += int(objectCount);
+        return sum;
+    };
+    QTRY_COMPARE(incubatedObjects(), 4);
+    QVERIFY(statistics->maximum(QQuickFrameStatistics::IncubatedObjects) > 0);
+}
+
 QTEST_MAIN(tst_qquickwindow)
 
 #include "tst_qquickwindow.moc"
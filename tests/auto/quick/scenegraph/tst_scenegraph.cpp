@@ -20,6 +20,8 @@
 #include <private/qsgrenderloop_p.h>
 #include <private/qsgrhisupport_p.h>
 #include <private/qsgplaintexture_p.h>
+#include <private/qsgareaallocator_p.h>
+#include <private/qsgframepacer_p.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/visualtestutils_p.h>
@@ -96,6 +98,10 @@ private slots:
     void createTextureFromImage();
     void withAdoptedRhi();
     void resizeTextureFromImage();
+    void atlasPages();
+    void areaAllocator_data();
+    void areaAllocator();
+    void framePacer();
 
 private:
     QQuickView *createView(const QString &file, QWindow *parent = nullptr, int x = -1, int y = -1, int w = -1, int h = -1);
@@ -783,6 +789,123 @@ void tst_SceneGraph::resizeTextureFromImage()
     TestOffscreenScene::cleanup();
 }
 
+void tst_SceneGraph::atlasPages()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    // 1024x1024 pages take 4 MB each, so the default budget of 64 MB is room
+    // for 16 of them. Four 510x510 images, 512x512 with their padding, fill a
+    // page.
+    qputenv("QSG_ATLAS_WIDTH", "1024");
+    qputenv("QSG_ATLAS_HEIGHT", "1024");
+    QLoggingCategory::setFilterRules(QStringLiteral("qt.scenegraph.general.debug=true"));
+    const auto reset = qScopeGuard([] {
+        qunsetenv("QSG_ATLAS_WIDTH");
+        qunsetenv("QSG_ATLAS_HEIGHT");
+        QLoggingCategory::setFilterRules(QString());
+    });
+    const int pageCount = 16;
+    const qint64 pageBytes = 1024 * 1024 * 4;
+
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml"))));
+        QVERIFY(scene->renderControl && scene->window && scene->rootItem);
+        QRhi *rhi = static_cast<QRhi *>(scene->window->rendererInterface()->getResource(scene->window, QSGRendererInterface::RhiResource));
+        QVERIFY(rhi);
+        if (rhi->resourceLimit(QRhi::TextureSizeMax) < 1024)
+            QSKIP("Skipping test due to the maximum texture size being too small");
+
+        const QSize size = scene->rootItem->size().toSize();
+        QScopedPointer<QRhiTexture> tex(rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+        QVERIFY(tex->create());
+        QScopedPointer<QRhiRenderBuffer> ds(rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+        QVERIFY(ds->create());
+        QRhiTextureRenderTargetDescription rtDesc(QRhiColorAttachment(tex.data()));
+        rtDesc.setDepthStencilBuffer(ds.data());
+        QScopedPointer<QRhiTextureRenderTarget> texRt(rhi->newTextureRenderTarget(rtDesc));
+        QScopedPointer<QRhiRenderPassDescriptor> rp(texRt->newCompatibleRenderPassDescriptor());
+        texRt->setRenderPassDescriptor(rp.data());
+        QVERIFY(texRt->create());
+        scene->window->setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(texRt.data()));
+
+        const auto renderFrame = [&scene] {
+            scene->renderControl->polishItems();
+            scene->renderControl->beginFrame();
+            scene->renderControl->sync();
+            scene->renderControl->render();
+            scene->renderControl->endFrame();
+        };
+        renderFrame();
+
+        // All images share the same data, so that this does not take another
+        // 64 MB of system memory.
+        QImage image(510, 510, QImage::Format_RGBA8888_Premultiplied);
+        image.fill(Qt::red);
+        ScopedList<QSGTexture *> textures;
+        const auto createTexture = [&scene, &image] {
+            return scene->window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas);
+        };
+        const auto pages = [&textures] {
+            QList<qint64> keys;
+            for (const QSGTexture *t : std::as_const(textures)) {
+                if (!keys.contains(t->comparisonKey()))
+                    keys.append(t->comparisonKey());
+            }
+            return keys;
+        };
+
+        // Images that do not fit go to a new page rather than into a texture
+        // of their own, for as long as the budget allows.
+        for (int i = 0; i < 4; ++i)
+            textures.append(createTexture());
+        QCOMPARE(pages().size(), 1);
+        QTest::ignoreMessage(QtDebugMsg, "rhi texture atlas: added page 2 of 16");
+        textures.append(createTexture());
+        QCOMPARE(pages().size(), 2);
+        QVERIFY(textures.last()->isAtlasTexture());
+        QVERIFY(!qobject_cast<QSGPlainTexture *>(textures.last()));
+
+        while (textures.size() < pageCount * 4) {
+            textures.append(createTexture());
+            QVERIFY(textures.last()->isAtlasTexture());
+        }
+        QCOMPARE(pages().size(), pageCount);
+        QVERIFY(pages().size() * pageBytes <= qint64(64) * 1024 * 1024);
+
+        // With the budget used up, the next one is a texture of its own.
+        QScopedPointer<QSGTexture> plain(createTexture());
+        QVERIFY(!plain->isAtlasTexture());
+        QVERIFY(qobject_cast<QSGPlainTexture *>(plain.data()));
+        QCOMPARE(pages().size(), pageCount);
+
+        // Pages that have been emptied are released at the start of the next
+        // frame, except for the last one left.
+        const qint64 firstPage = textures.first()->comparisonKey();
+        for (qsizetype i = textures.size() - 1; i >= 0; --i) {
+            if (textures.at(i)->comparisonKey() != firstPage)
+                delete textures.takeAt(i);
+        }
+        QCOMPARE(textures.size(), 4);
+        QTest::ignoreMessage(QtDebugMsg, "rhi texture atlas: released empty pages, 1 of 16 left");
+        renderFrame();
+
+        // That makes room in the budget for new pages.
+        QTest::ignoreMessage(QtDebugMsg, "rhi texture atlas: added page 2 of 16");
+        textures.append(createTexture());
+        QVERIFY(textures.last()->isAtlasTexture());
+        QCOMPARE(pages().size(), 2);
+
+        qDeleteAll(textures);
+        textures.clear();
+        plain.reset();
+        QTest::ignoreMessage(QtDebugMsg, "rhi texture atlas: released empty pages, 1 of 16 left");
+        renderFrame();
+    }
+
+    TestOffscreenScene::cleanup();
+}
+
 bool tst_SceneGraph::isRunningOnRhi()
 {
     static bool retval = false;
@@ -802,6 +925,155 @@ bool tst_SceneGraph::isRunningOnRhi()
     return retval;
 }
 
+void tst_SceneGraph::areaAllocator_data()
+{
+    QTest::addColumn<int>("strategy");
+
+    QTest::newRow("binarytree") << int(QSGAreaAllocator::BinaryTree);
+    QTest::newRow("skyline") << int(QSGAreaAllocator::Skyline);
+}
+
+void tst_SceneGraph::areaAllocator()
+{
+    QFETCH(int, strategy);
+
+    const QSize size(512, 512);
+    QSGAreaAllocator allocator(size, QSGAreaAllocator::Strategy(strategy));
+    QVERIFY(allocator.isEmpty());
+    QCOMPARE(allocator.largestFreeArea(), qint64(size.width()) * size.height());
+
+    // Allocate and release a mix of sizes, in a fixed pseudo random order.
+    QList<QRect> allocated;
+    quint32 seed = 1;
+    const auto next = [&seed](int bound) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % quint32(bound));
+    };
+    for (int i = 0; i < 5000; ++i) {
+        if (!allocated.isEmpty() && next(3) == 0) {
+            QVERIFY(allocator.deallocate(allocated.takeAt(next(allocated.size()))));
+            continue;
+        }
+        const QRect rect = allocator.allocate(QSize(2 + next(60), 2 + next(60)));
+        if (!rect.isValid())
+            continue;
+        QVERIFY(QRect(QPoint(0, 0), size).contains(rect));
+        for (const QRect &other : std::as_const(allocated))
+            QVERIFY2(!other.intersects(rect), qPrintable(QString::number(i)));
+        allocated.append(rect);
+    }
+
+    qint64 usedArea = 0;
+    for (const QRect &rect : std::as_const(allocated))
+        usedArea += qint64(rect.width()) * rect.height();
+    // The binary tree hands out its nodes whole when the request is a close fit.
+    QVERIFY(allocator.usedArea() >= usedArea);
+    QVERIFY(allocator.largestFreeArea() <= qint64(size.width()) * size.height() - allocator.usedArea());
+
+    for (const QRect &rect : std::as_const(allocated))
+        QVERIFY(allocator.deallocate(rect));
+    QVERIFY(allocator.isEmpty());
+    QCOMPARE(allocator.allocate(size), QRect(QPoint(0, 0), size));
+}
+
+void tst_SceneGraph::framePacer()
+{
+    const qint64 ms = 1000000;
+    qint64 now = 0;
+    QSGFramePacer pacer([&now]() { return now; });
+    pacer.setVSyncInterval(16 * ms);
+
+    // Nothing to go by before the first present.
+    QVERIFY(!pacer.predict().isValid());
+    QCOMPARE(pacer.remainingFrameBudget(), qint64(-1));
+
+    // A frame that was prepared without a prediction has no error.
+    pacer.beginFrame();
+    now = 4 * ms;
+    QCOMPARE(pacer.endFrame(0), qint64(0));
+    QCOMPARE(pacer.statistics().errorCount, 0);
+
+    // Presents are at 4, 20, 36 ms and so on. The next frame costs 4 ms like
+    // the last one, and is ready in time for 20 ms.
+    now = 6 * ms;
+    QSGFramePacer::Prediction prediction = pacer.predict();
+    QVERIFY(prediction.isValid());
+    QVERIFY(!prediction.frameInFlight);
+    QCOMPARE(prediction.nextVSync, 20 * ms);
+    QCOMPARE(prediction.presentTime, 20 * ms);
+    QVERIFY(!prediction.willMiss());
+    // It has to be synchronized 4 ms before that vsync.
+    QCOMPARE(pacer.remainingFrameBudget(), 10 * ms);
+
+    // Polishing comes before that, smoothed over the frames.
+    pacer.recordPolish(8 * ms);
+    QCOMPARE(pacer.remainingFrameBudget(), 8 * ms);
+    QCOMPARE(pacer.predict().presentTime, 20 * ms);
+
+    // While a frame is rendered, the next one can be synchronized once the
+    // render thread has presented it.
+    pacer.commitPrediction(prediction);
+    now = 8 * ms;
+    pacer.beginFrame();
+    now = 10 * ms;
+    prediction = pacer.predict();
+    QVERIFY(prediction.frameInFlight);
+    QCOMPARE(prediction.presentTime, 20 * ms);
+    QCOMPARE(pacer.remainingFrameBudget(), 8 * ms);
+
+    // Presented 1 ms early, after 10 ms of work and 1 ms of waiting. Just
+    // before that, there is no time left for anything but polishing.
+    now = 19 * ms;
+    QCOMPARE(pacer.remainingFrameBudget(), qint64(0));
+    QCOMPARE(pacer.endFrame(1 * ms), -1 * ms);
+    QSGFramePacer::Statistics statistics = pacer.statistics();
+    QCOMPARE(statistics.errorCount, 1);
+    QCOMPARE(statistics.errorSum, 1 * ms);
+    QCOMPARE(statistics.lateCount, 0);
+
+    // The latest frame cost counts in full, so the next frame, prepared while
+    // a frame is rendered, is expected to miss the next vsync at 35 ms and
+    // to be presented at 51 ms.
+    now = 21 * ms;
+    pacer.beginFrame();
+    now = 22 * ms;
+    prediction = pacer.predict();
+    QVERIFY(prediction.frameInFlight);
+    QCOMPARE(prediction.nextVSync, 35 * ms);
+    QCOMPARE(prediction.presentTime, 51 * ms);
+    QVERIFY(prediction.willMiss());
+    // The next frame is only taken once this one is presented at 35 ms.
+    QCOMPARE(pacer.remainingFrameBudget(), 11 * ms);
+    pacer.commitPrediction(prediction);
+
+    // The frame in flight was begun before the prediction was committed.
+    now = 40 * ms;
+    QCOMPARE(pacer.endFrame(0), qint64(0));
+    QCOMPARE(pacer.statistics().errorCount, 1);
+
+    // The next one is measured against it, and is more than half a vsync late.
+    now = 41 * ms;
+    pacer.beginFrame();
+    now = 60 * ms;
+    QCOMPARE(pacer.endFrame(0), 9 * ms);
+    statistics = pacer.statistics();
+    QCOMPARE(statistics.errorCount, 2);
+    QCOMPARE(statistics.errorSum, 10 * ms);
+    QCOMPARE(statistics.lateCount, 1);
+
+    pacer.recordDroppedFrame();
+    QCOMPARE(pacer.statistics().droppedCount, 1);
+
+    // A frame that is not presented after all is not measured.
+    pacer.commitPrediction(pacer.predict());
+    pacer.beginFrame();
+    QVERIFY(pacer.predict().frameInFlight);
+    pacer.cancelFrame();
+    QVERIFY(!pacer.predict().frameInFlight);
+    QCOMPARE(pacer.endFrame(0), qint64(0));
+    QCOMPARE(pacer.statistics().errorCount, 2);
+}
+
 #include "tst_scenegraph.moc"
 
 QTEST_MAIN(tst_SceneGraph)
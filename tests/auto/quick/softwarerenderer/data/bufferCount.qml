@@ -0,0 +1,20 @@
+import QtQuick
+
+Rectangle {
+    width: 320
+    height: 240
+    color: "white"
+
+    Repeater {
+        model: 6
+        Rectangle {
+            required property int index
+            objectName: "rect" + index
+            x: 10 + (index % 3) * 100
+            y: 10 + Math.floor(index / 3) * 110
+            width: 90
+            height: 100
+            color: "steelblue"
+        }
+    }
+}
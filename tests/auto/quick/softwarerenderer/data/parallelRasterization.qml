@@ -0,0 +1,64 @@
+import QtQuick
+
+Rectangle {
+    width: 640
+    height: 480
+    color: "white"
+
+    // Spans all tiles, and moves across the scene in the second frame
+    Rectangle {
+        objectName: "tall"
+        x: 20
+        y: 10
+        width: 120
+        height: 460
+        radius: 12
+        border.width: 3
+        border.color: "navy"
+        gradient: Gradient {
+            GradientStop { position: 0; color: "orange" }
+            GradientStop { position: 1; color: "purple" }
+        }
+    }
+
+    Item {
+        x: 150
+        y: 40
+        width: 260
+        height: 300
+        clip: true
+
+        Rectangle {
+            x: -50
+            y: -50
+            width: 400
+            height: 120
+            rotation: 30
+            antialiasing: true
+            color: "#8000a000"
+        }
+
+        Text {
+            objectName: "text"
+            y: 120
+            width: 260
+            wrapMode: Text.WordWrap
+            font.pixelSize: 24
+            text: "The quick brown fox jumps over the lazy dog, across several tiles."
+        }
+    }
+
+    Repeater {
+        model: 12
+        Rectangle {
+            required property int index
+            x: 420 + (index % 3) * 70
+            y: 10 + Math.floor(index / 3) * 115
+            width: 60
+            height: 100
+            radius: (index % 4) * 5
+            opacity: 0.5 + (index % 2) * 0.5
+            color: Qt.hsla(index / 12, 0.6, 0.5, 1)
+        }
+    }
+}
@@ -22,6 +22,9 @@ private slots:
     void initTestCase() override;
 
     void renderTarget();
+    void parallelRasterization();
+    void bufferCount_data();
+    void bufferCount();
 };
 
 tst_SoftwareRenderer::tst_SoftwareRenderer()
@@ -93,6 +96,193 @@ void tst_SoftwareRenderer::renderTarget()
              qPrintable(errorMessage));
 }
 
+// Compares all channels, allowing for small differences in antialiasing
+static bool compareAllChannels(const QImage &actual, const QImage &expected, QString *errorMessage)
+{
+    if (actual.size() != expected.size() || actual.format() != expected.format()) {
+        QDebug(errorMessage) << "Images differ:" << actual << expected;
+        return false;
+    }
+    const int tolerance = 2;
+    for (int y = 0; y < actual.height(); ++y) {
+        const QRgb *a = reinterpret_cast<const QRgb *>(actual.constScanLine(y));
+        const QRgb *e = reinterpret_cast<const QRgb *>(expected.constScanLine(y));
+        for (int x = 0; x < actual.width(); ++x) {
+            if (qAbs(qAlpha(a[x]) - qAlpha(e[x])) > tolerance
+                    || qAbs(qRed(a[x]) - qRed(e[x])) > tolerance
+                    || qAbs(qGreen(a[x]) - qGreen(e[x])) > tolerance
+                    || qAbs(qBlue(a[x]) - qBlue(e[x])) > tolerance) {
+                QDebug(errorMessage) << "Mismatch at:" << x << y << ':'
+                                     << Qt::hex << Qt::showbase << a[x] << e[x];
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void renderFrame(QQuickRenderControl *rc)
+{
+    rc->polishItems();
+    rc->beginFrame();
+    rc->sync();
+    rc->render();
+    rc->endFrame();
+}
+
+// Renders \a url into an image, then moves an item and changes a text that
+// span several tiles and renders again. Returns the image after each frame.
+static QList<QImage> renderFrames(const QUrl &url, int threadCount)
+{
+    // The renderer reads the variable when it is created, in the first sync()
+    qputenv("QSG_SOFTWARE_RENDER_THREADS", QByteArray::number(threadCount));
+    const auto resetThreadCount = qScopeGuard([] {
+        qunsetenv("QSG_SOFTWARE_RENDER_THREADS");
+    });
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, url);
+    QQuickRenderControl rc;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&rc));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(component.create()));
+    if (!root) {
+        qWarning() << component.errors();
+        return {};
+    }
+    root->setParentItem(window->contentItem());
+    window->setWidth(root->width());
+    window->setHeight(root->height());
+
+    QImage renderTarget(window->size(), QImage::Format_ARGB32_Premultiplied);
+    renderTarget.fill(Qt::red);
+    window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&renderTarget));
+
+    QList<QImage> frames;
+    renderFrame(&rc);
+    frames << renderTarget.copy();
+
+    root->findChild<QQuickItem *>("tall")->setX(300);
+    root->findChild<QQuickItem *>("text")->setProperty("text", QStringLiteral("Jackdaws love my big sphinx of quartz."));
+    renderFrame(&rc);
+    frames << renderTarget.copy();
+
+    return frames;
+}
+
+void tst_SoftwareRenderer::parallelRasterization()
+{
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Skipping complex rendering tests due to not running with software");
+
+    const QUrl url = testFileUrl("parallelRasterization.qml");
+    const QList<QImage> serialFrames = renderFrames(url, 1);
+    QCOMPARE(serialFrames.size(), 2);
+
+    // Both frames update enough of the scene to be painted in tiles
+    QLoggingCategory::setFilterRules(QStringLiteral("qt.scenegraph.softwarecontext.abstractrenderer.debug=true"));
+    const auto resetFilterRules = qScopeGuard([] {
+        QLoggingCategory::setFilterRules(QString());
+    });
+    const QRegularExpression tilesMessage(QStringLiteral("^painted \\d+ tiles of .* on 4 threads$"));
+    QTest::ignoreMessage(QtDebugMsg, tilesMessage);
+    QTest::ignoreMessage(QtDebugMsg, tilesMessage);
+    const QList<QImage> parallelFrames = renderFrames(url, 4);
+    QCOMPARE(parallelFrames.size(), 2);
+
+    for (int i = 0; i < serialFrames.size(); ++i) {
+        QString errorMessage;
+        QVERIFY2(compareAllChannels(parallelFrames.at(i), serialFrames.at(i), &errorMessage),
+                 qPrintable(QStringLiteral("frame %1: %2").arg(i).arg(errorMessage)));
+    }
+}
+
+void tst_SoftwareRenderer::bufferCount_data()
+{
+    QTest::addColumn<int>("bufferCount");
+
+    QTest::newRow("2 buffers") << 2;
+    QTest::newRow("3 buffers") << 3;
+}
+
+// Cycles through as many images as QSG_SOFTWARE_BUFFER_COUNT says, like a
+// backing store that swaps buffers, and changes one item per frame. Each image
+// must then catch up with the damage of the frames painted into the others.
+void tst_SoftwareRenderer::bufferCount()
+{
+    QFETCH(int, bufferCount);
+
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Skipping complex rendering tests due to not running with software");
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("bufferCount.qml"));
+
+    // The reference paints every frame into the same image, whose contents
+    // are preserved, as with a single buffer
+    QQuickRenderControl referenceControl;
+    QScopedPointer<QQuickWindow> referenceWindow(new QQuickWindow(&referenceControl));
+    QScopedPointer<QQuickItem> referenceRoot(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(referenceRoot, qPrintable(component.errorString()));
+    referenceRoot->setParentItem(referenceWindow->contentItem());
+    referenceWindow->setWidth(referenceRoot->width());
+    referenceWindow->setHeight(referenceRoot->height());
+    QImage reference(referenceWindow->size(), QImage::Format_ARGB32_Premultiplied);
+    referenceWindow->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&reference));
+    renderFrame(&referenceControl);
+
+    // The renderer reads the variable when it is created, in the first sync()
+    qputenv("QSG_SOFTWARE_BUFFER_COUNT", QByteArray::number(bufferCount));
+    const auto resetBufferCount = qScopeGuard([] {
+        qunsetenv("QSG_SOFTWARE_BUFFER_COUNT");
+    });
+
+    QQuickRenderControl control;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&control));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(root, qPrintable(component.errorString()));
+    root->setParentItem(window->contentItem());
+    window->setWidth(root->width());
+    window->setHeight(root->height());
+
+    // Stale contents would show up in magenta
+    QList<QImage> buffers;
+    for (int i = 0; i < bufferCount; ++i) {
+        buffers.append(QImage(window->size(), QImage::Format_ARGB32_Premultiplied));
+        buffers.last().fill(Qt::magenta);
+    }
+
+    const auto rects = [](QQuickItem *root) {
+        QList<QQuickItem *> result;
+        for (QQuickItem *child : root->childItems()) {
+            if (child->objectName().startsWith(QLatin1String("rect")))
+                result.append(child);
+        }
+        return result;
+    };
+    const QList<QQuickItem *> referenceRects = rects(referenceRoot.data());
+    const QList<QQuickItem *> bufferedRects = rects(root.data());
+    QCOMPARE(referenceRects.size(), 6);
+    QCOMPARE(bufferedRects.size(), 6);
+
+    for (int frame = 0; frame < 12; ++frame) {
+        if (frame > 0) {
+            for (QQuickItem *rect : { referenceRects.at(frame % 6), bufferedRects.at(frame % 6) }) {
+                rect->setX(rect->x() + 7);
+                rect->setProperty("color", QColor::fromHsv(frame * 30 % 360, 200, 220));
+            }
+            renderFrame(&referenceControl);
+        }
+
+        QImage &buffer = buffers[frame % bufferCount];
+        window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&buffer));
+        renderFrame(&control);
+
+        QString errorMessage;
+        QVERIFY2(compareAllChannels(buffer, reference, &errorMessage),
+                 qPrintable(QStringLiteral("frame %1: %2").arg(frame).arg(errorMessage)));
+    }
+}
+
 #include "tst_softwarerenderer.moc"
 
 QTEST_MAIN(tst_SoftwareRenderer)
@@ -12,7 +12,9 @@
 
 #include <QFile>
 #include <QDebug>
+#include <QScopeGuard>
 #include <QTextStream>
+#include <QThread>
 
 class tst_compilation : public QObject
 {
@@ -29,6 +31,9 @@ private slots:
     void bigimport_data();
     void bigimport();
 
+    void coldstart_data();
+    void coldstart();
+
 private:
     QQmlEngine engine;
 };
@@ -161,6 +166,87 @@ void tst_compilation::bigimport()
     }
 }
 
+void tst_compilation::coldstart_data()
+{
+    QTest::addColumn<int>("threads");
+
+    // 0 parses on the type loader thread only.
+    QTest::newRow("0 threads") << 0;
+    for (int threads = 1; threads <= QThread::idealThreadCount(); threads *= 2)
+        QTest::addRow("%d threads", threads) << threads;
+}
+
+void tst_compilation::coldstart()
+{
+    QFETCH(int, threads);
+
+    // Half of the types are instantiated by main.qml, each of them instantiates one of
+    // the other half. Every type imports one of a few JavaScript libraries.
+    const int typeCount = 400;
+    const int libraryCount = 10;
+
+    // Fresh paths, so that nothing can be loaded from the disk cache.
+    QTemporaryDir d;
+    QVERIFY(d.isValid());
+    QString p;
+    {
+        for (int i = 0; i < libraryCount; ++i) {
+            QFile f(d.filePath(QString::fromLatin1("lib%1.js").arg(i)));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write(".pragma library\n");
+            for (int j = 0; j < 20; ++j) {
+                f.write(qPrintable(QString::fromLatin1(
+                        "function f%1(x) { let s = %2; for (let k = 0; k < x; ++k) s += k * %1; "
+                        "return s > 100 ? String(s) : \"small\" + s; }\n").arg(j).arg(i)));
+            }
+        }
+
+        for (int i = 0; i < typeCount; ++i) {
+            QFile f(d.filePath(QString::fromLatin1("Type%1.qml").arg(i)));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("import QtQml\n");
+            f.write(qPrintable(QString::fromLatin1("import \"lib%1.js\" as Lib\n").arg(i % libraryCount)));
+            f.write("QtObject {\n");
+            f.write(qPrintable(QString::fromLatin1("    property int value: %1\n").arg(i)));
+            f.write("    property string label: \"Type\" + value + Lib.f1(value)\n");
+            f.write("    property real computed: { let s = 0; for (let k = 0; k < 10; ++k) s += Math.sqrt(k * value); return s; }\n");
+            f.write("    property var items: [ value, value * 2, { name: label, size: computed } ]\n");
+            f.write("    signal triggered(int code)\n");
+            f.write("    onTriggered: (code) => { value = code + Lib.f2(code).length }\n");
+            for (int j = 0; j < 10; ++j) {
+                f.write(qPrintable(QString::fromLatin1(
+                        "    function g%1(x: int): int { return x > %1 ? g%1(x - 1) + %1 : value; }\n").arg(j)));
+            }
+            if (i < typeCount / 2)
+                f.write(qPrintable(QString::fromLatin1("    property QtObject child: Type%1 {}\n").arg(i + typeCount / 2)));
+            f.write("}\n");
+        }
+
+        QFile main(d.filePath("main.qml"));
+        QVERIFY(main.open(QIODevice::WriteOnly));
+        p = QFileInfo(main).absoluteFilePath();
+        main.write("import QtQml\n");
+        main.write("QtObject {\n");
+        main.write("    property list<QtObject> types: [\n");
+        for (int i = 0; i < typeCount / 2; ++i)
+            main.write(qPrintable(QString::fromLatin1("        Type%1 {},\n").arg(i)));
+        main.write("    ]\n");
+        main.write("}\n");
+    }
+
+    // Read when the engine's type loader is created. Unset also when the
+    // benchmark fails, so that it does not leak into the other functions.
+    qputenv("QML_TYPELOADER_THREADS", QByteArray::number(threads));
+    const auto resetThreads = qScopeGuard([] { qunsetenv("QML_TYPELOADER_THREADS"); });
+    QBENCHMARK_ONCE {
+        QQmlEngine e;
+        QQmlComponent c(&e, QUrl::fromLocalFile(p));
+        QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+        QScopedPointer<QObject> o(c.create());
+        QVERIFY(o);
+    }
+}
+
 QTEST_MAIN(tst_compilation)
 
 #include "tst_compilation.moc"
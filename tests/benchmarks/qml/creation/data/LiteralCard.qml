@@ -0,0 +1,37 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 200
+    height: 80
+    color: "#f0f0f0"
+    border.color: "steelblue"
+
+    property color accent: "#ff8040"
+    property color shadow: "#40000000"
+    property url icon: "images/card.png"
+    property point offset: "4,4"
+    property size iconSize: "32x32"
+    property rect hitArea: "0,0,200x80"
+    property date created: "2024-01-15T10:30:00"
+
+    Rectangle {
+        x: 8
+        y: 8
+        width: 32
+        height: 32
+        color: "lightsteelblue"
+        border.color: "navy"
+    }
+
+    Rectangle {
+        x: 48
+        y: 8
+        width: 144
+        height: 64
+        color: "white"
+        border.color: "#c0c0c0"
+    }
+}
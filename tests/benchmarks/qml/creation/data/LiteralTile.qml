@@ -0,0 +1,24 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    width: 120
+    height: 120
+
+    property vector3d axis: "0,1,0"
+    property vector4d tint: "1,0.5,0.25,1"
+    property quaternion orientation: "1,0,0,0"
+    property url thumbnail: "images/tile.png"
+    property url fallback: "images/missing.png"
+    property rect bounds: "0,0,120x120"
+    property size minimum: "48x48"
+    property point anchor: "60,60"
+
+    Rectangle {
+        anchors.fill: parent
+        color: "#202830"
+        border.color: "#405060"
+    }
+}
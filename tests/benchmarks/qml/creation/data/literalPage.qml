@@ -0,0 +1,15 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Column {
+    Repeater {
+        model: 150
+        LiteralCard {}
+    }
+    Repeater {
+        model: 150
+        LiteralTile {}
+    }
+}
@@ -5,9 +5,11 @@
 #include <QQmlEngine>
 #include <QQmlComponent>
 #include <private/qqmlmetatype_p.h>
+#include <private/qqmlliteralplan_p.h>
 #include <QDebug>
 #include <QQuickItem>
 #include <QQmlContext>
+#include <QScopeGuard>
 #include <private/qobject_p.h>
 
 class tst_creation : public QObject
@@ -46,6 +48,9 @@ private slots:
     void anchors_creation();
     void anchors_heightChange();
 
+    void literals_qml_data();
+    void literals_qml();
+
 private:
     QQmlEngine engine;
 };
@@ -419,6 +424,31 @@ void tst_creation::anchors_heightChange()
     delete obj;
 }
 
+void tst_creation::literals_qml_data()
+{
+    QTest::addColumn<bool>("planLiterals");
+
+    QTest::newRow("sequential") << false;
+    QTest::newRow("planned") << true;
+}
+
+void tst_creation::literals_qml()
+{
+    QFETCH(bool, planLiterals);
+
+    const bool wasEnabled = QQmlLiteralPlan::isEnabled();
+    QQmlLiteralPlan::setEnabled(planLiterals);
+    const auto restore = qScopeGuard([&]() { QQmlLiteralPlan::setEnabled(wasEnabled); });
+
+    // The plan is kept with the compilation units, so each row needs its own engine.
+    QQmlEngine literalEngine;
+    QQmlComponent component(&literalEngine, TEST_FILE("literalPage.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    delete component.create();
+    QBENCHMARK { delete component.create(); }
+}
+
 QTEST_MAIN(tst_creation)
 
 #include "tst_creation.moc"
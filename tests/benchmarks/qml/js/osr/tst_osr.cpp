@@ -0,0 +1,72 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtQml/qjsengine.h>
+
+// Each of the scripts calls a function exactly once, so the call count threshold of the JIT
+// never triggers. Only moving the running frame into jitted code at a loop header speeds them up.
+// Run with QV4_JIT_LOOP_THRESHOLD set to a very large number to compare with the interpreter.
+class tst_osr : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void singleCallLoop_data();
+    void singleCallLoop();
+};
+
+void tst_osr::singleCallLoop_data()
+{
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("checksum") << QStringLiteral(
+            "(function() {\n"
+            "    var sum = 0;\n"
+            "    for (var i = 0; i < 10000000; ++i)\n"
+            "        sum = (sum + (i ^ (i >> 3))) & 0xffffff;\n"
+            "    return sum;\n"
+            "})()") << 791744.;
+
+    QTest::newRow("doubles") << QStringLiteral(
+            "(function() {\n"
+            "    var x = 0.5;\n"
+            "    var i = 0;\n"
+            "    do {\n"
+            "        x = x * 0.999999 + 0.25;\n"
+            "    } while (++i < 10000000);\n"
+            "    return x > 0 ? 1 : 0;\n"
+            "})()") << 1.;
+
+    QTest::newRow("import") << QStringLiteral(
+            "(function() {\n"
+            "    var rows = [];\n"
+            "    for (var i = 0; i < 1000000; ++i)\n"
+            "        rows.push({ id: i, value: i % 97 });\n"
+            "    var total = 0;\n"
+            "    for (var j = 0; j < rows.length; ++j)\n"
+            "        total += rows[j].value;\n"
+            "    return total === 47999055 ? 1 : 0;\n"
+            "})()") << 1.;
+}
+
+void tst_osr::singleCallLoop()
+{
+    QFETCH(QString, script);
+    QFETCH(double, expected);
+
+    QJSValue result;
+    QBENCHMARK {
+        // A new engine each time, so that the function is never jitted up front.
+        QJSEngine engine;
+        result = engine.evaluate(script);
+    }
+
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toNumber(), expected);
+}
+
+QTEST_MAIN(tst_osr)
+
+#include "tst_osr.moc"
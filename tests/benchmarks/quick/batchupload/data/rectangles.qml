@@ -0,0 +1,34 @@
+import QtQuick
+
+Item {
+    id: root
+    width: 800
+    height: 800
+
+    property int count: 1024
+
+    // Small groups stay below the batch root threshold of the renderer. Moving
+    // them changes the vertex data of the merged batch, which is uploaded again.
+    Repeater {
+        model: root.count / 16
+        Item {
+            objectName: "group"
+            x: (index % 40) * 20
+            y: Math.floor(index / 40) * 20
+            width: 16
+            height: 16
+
+            Repeater {
+                model: 16
+                Rectangle {
+                    x: (index % 4) * 4
+                    y: Math.floor(index / 4) * 4
+                    width: 3
+                    height: 3
+                    antialiasing: false
+                    color: Qt.rgba(index / 16, 0.5, 1 - index / 16, 1)
+                }
+            }
+        }
+    }
+}
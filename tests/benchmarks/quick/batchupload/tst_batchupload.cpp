@@ -0,0 +1,134 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickrendercontrol.h>
+#include <QtQuick/qquickrendertarget.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtGui/private/qrhi_p.h>
+#include <QtQuickTestUtils/private/qmlutils_p.h>
+
+// Measures how fast the batch renderer uploads merged batches whose vertices
+// have to be transformed again on every frame. The Null RHI backend keeps the
+// graphics driver out of the measurement.
+class tst_BatchUpload : public QQmlDataTest
+{
+    Q_OBJECT
+
+public:
+    tst_BatchUpload();
+
+private slots:
+    void initTestCase() override;
+    void upload_data();
+    void upload();
+};
+
+tst_BatchUpload::tst_BatchUpload()
+    : QQmlDataTest(QT_QMLTEST_DATADIR)
+{
+}
+
+void tst_BatchUpload::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Null);
+}
+
+void tst_BatchUpload::upload_data()
+{
+    QTest::addColumn<bool>("rotate");
+    QTest::addColumn<int>("rectangles");
+
+    for (int rectangles : { 1024, 8192 }) {
+        QTest::addRow("translate-%d", rectangles) << false << rectangles;
+        QTest::addRow("rotate-%d", rectangles) << true << rectangles;
+    }
+}
+
+void tst_BatchUpload::upload()
+{
+    QFETCH(bool, rotate);
+    QFETCH(int, rectangles);
+
+    QQuickRenderControl renderControl;
+    QQuickWindow window(&renderControl);
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("rectangles.qml"));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(
+            component.createWithInitialProperties({ { "count", rectangles } })));
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    window.contentItem()->setSize(root->size());
+    window.setGeometry(0, 0, root->width(), root->height());
+    root->setParentItem(window.contentItem());
+    QVERIFY(renderControl.initialize());
+
+    QRhi *rhi = renderControl.rhi();
+    QVERIFY(rhi);
+    QCOMPARE(rhi->backend(), QRhi::Null);
+
+    const QSize size = root->size().toSize();
+    QScopedPointer<QRhiTexture> texture(
+            rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiRenderBuffer> depthStencil(
+            rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+    QVERIFY(depthStencil->create());
+    QRhiTextureRenderTargetDescription description(QRhiColorAttachment(texture.data()));
+    description.setDepthStencilBuffer(depthStencil.data());
+    QScopedPointer<QRhiTextureRenderTarget> renderTarget(rhi->newTextureRenderTarget(description));
+    QScopedPointer<QRhiRenderPassDescriptor> renderPass(
+            renderTarget->newCompatibleRenderPassDescriptor());
+    renderTarget->setRenderPassDescriptor(renderPass.data());
+    QVERIFY(renderTarget->create());
+    window.setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(renderTarget.data()));
+
+    QList<QQuickItem *> groups;
+    const QList<QQuickItem *> children = root->childItems();
+    for (QQuickItem *child : children) {
+        if (child->objectName() == QLatin1String("group"))
+            groups.append(child);
+    }
+    QCOMPARE(groups.size(), rectangles / 16);
+
+    int frame = 0;
+    const auto renderFrame = [&]() {
+        ++frame;
+        for (QQuickItem *group : std::as_const(groups)) {
+            if (rotate)
+                group->setRotation(frame % 360);
+            else
+                group->setX(group->x() + ((frame & 1) ? 1 : -1));
+        }
+        renderControl.polishItems();
+        renderControl.beginFrame();
+        renderControl.sync();
+        renderControl.render();
+        renderControl.endFrame();
+    };
+
+    // The first frame builds the batches.
+    renderFrame();
+
+    qint64 frames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        renderFrame();
+        ++frames;
+    }
+    const double milliseconds = timer.nsecsElapsed() / 1000000.0;
+
+    // Each rectangle is a quad of four vertices.
+    const double vertices = 4.0 * rectangles * frames;
+    qInfo("%s: %.0f vertices/ms", QTest::currentDataTag(), vertices / milliseconds);
+}
+
+QTEST_MAIN(tst_BatchUpload)
+
+#include "tst_batchupload.moc"
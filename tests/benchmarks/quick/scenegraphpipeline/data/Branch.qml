@@ -0,0 +1,21 @@
+import QtQuick
+
+Rectangle {
+    id: node
+    property int depth: 0
+    property int frame: 0
+    width: 6
+    height: 6
+    color: Qt.hsla(depth / 12, 0.5, 0.5, 1)
+    x: 2 + (depth % 2 ? frame % 3 : 0)
+
+    Loader {
+        y: 8
+        Component.onCompleted: if (node.depth > 0) setSource("Branch.qml", { depth: node.depth - 1, frame: Qt.binding(() => node.frame) })
+    }
+    Loader {
+        x: 1 << node.depth
+        y: 8
+        Component.onCompleted: if (node.depth > 0) setSource("Branch.qml", { depth: node.depth - 1, frame: Qt.binding(() => node.frame) })
+    }
+}
@@ -0,0 +1,46 @@
+import QtQuick
+
+Rectangle {
+    id: root
+    width: 1280
+    height: 720
+    color: "white"
+
+    property int frame: 0
+
+    Grid {
+        columns: 20
+        spacing: 4
+        Repeater {
+            model: 20 * 11
+            Item {
+                width: 60
+                height: 60
+                clip: true
+                // Every fourth clip is rotated, which needs stencil clipping instead of scissoring.
+                rotation: index % 4 ? 0 : 15
+
+                Rectangle {
+                    x: -20 + (root.frame + index) % 40
+                    y: -10
+                    width: 80
+                    height: 80
+                    radius: 20
+                    color: index % 2 ? "steelblue" : "orange"
+
+                    Item {
+                        anchors.fill: parent
+                        anchors.margins: 10
+                        clip: true
+                        Rectangle {
+                            width: 100
+                            height: 30
+                            y: 20
+                            color: "black"
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,19 @@
+import QtQuick
+
+Rectangle {
+    id: root
+    width: 1280
+    height: 720
+    color: "white"
+
+    property int frame: 0
+
+    // A binary tree of 2047 items, 11 levels deep.
+    Branch {
+        x: 8
+        y: 8
+        depth: 10
+        frame: root.frame
+        rotation: root.frame % 2
+    }
+}
@@ -0,0 +1,30 @@
+import QtQuick
+
+Rectangle {
+    id: root
+    width: 1280
+    height: 720
+    color: "black"
+
+    property int frame: 0
+
+    Grid {
+        columns: 32
+        Repeater {
+            model: 32 * 18
+            Item {
+                width: 40
+                height: 40
+                Image {
+                    anchors.centerIn: parent
+                    source: "tile" + index % 4 + ".png"
+                    width: 32
+                    height: 32
+                    // Every other row pulses.
+                    scale: Math.floor(index / 32) % 2 ? 1 : 0.75 + 0.25 * Math.sin((root.frame + index) / 10)
+                    opacity: index % 3 ? 1 : 0.6
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+import QtQuick
+
+Rectangle {
+    id: root
+    width: 1280
+    height: 720
+    color: "white"
+
+    property int frame: 0
+
+    Flow {
+        anchors.fill: parent
+        anchors.margins: 8
+        spacing: 8
+        Repeater {
+            model: 60
+            Text {
+                width: 200
+                wrapMode: Text.WordWrap
+                font.pixelSize: 10 + index % 5
+                font.bold: index % 7 == 0
+                color: index % 3 ? "black" : "darkblue"
+                // Every fifth paragraph changes on every frame.
+                text: (index % 5 == 0 ? "Frame " + root.frame + ". " : "")
+                      + "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs. "
+                      + "Sphinx of black quartz, judge my vow. " + index
+            }
+        }
+    }
+}
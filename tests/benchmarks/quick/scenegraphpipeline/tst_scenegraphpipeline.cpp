@@ -0,0 +1,138 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtGui/qimage.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQuick/qquickframestatistics.h>
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickrendercontrol.h>
+#include <QtQuick/qquickrendertarget.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtGui/private/qrhi_p.h>
+#include <QtQuickTestUtils/private/qmlutils_p.h>
+
+// Runs the whole polish, sync and render pipeline offscreen for a corpus of
+// representative scenes and reports the CPU time of each phase together with
+// the renderer's statistics. With the Null RHI backend no GPU is involved;
+// built with SCENEGRAPHPIPELINE_SOFTWARE the software adaptation rasterizes
+// into a QImage instead. The backend is chosen once per process, hence the
+// two executables.
+class tst_SceneGraphPipeline : public QQmlDataTest
+{
+    Q_OBJECT
+
+public:
+    tst_SceneGraphPipeline();
+
+private slots:
+    void initTestCase() override;
+    void frame_data();
+    void frame();
+};
+
+tst_SceneGraphPipeline::tst_SceneGraphPipeline()
+    : QQmlDataTest(QT_QMLTEST_DATADIR)
+{
+}
+
+void tst_SceneGraphPipeline::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+#ifdef SCENEGRAPHPIPELINE_SOFTWARE
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+#else
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Null);
+#endif
+}
+
+void tst_SceneGraphPipeline::frame_data()
+{
+    QTest::addColumn<QString>("scene");
+
+    // Each scene has a frame property that it animates some of its content with.
+    QTest::newRow("textheavy") << QStringLiteral("textheavy.qml");
+    QTest::newRow("imagegrid") << QStringLiteral("imagegrid.qml");
+    QTest::newRow("deeptree") << QStringLiteral("deeptree.qml");
+    QTest::newRow("clipnodes") << QStringLiteral("clipnodes.qml");
+}
+
+void tst_SceneGraphPipeline::frame()
+{
+    QFETCH(QString, scene);
+
+    QQuickRenderControl renderControl;
+    QQuickWindow window(&renderControl);
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl(scene));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    window.contentItem()->setSize(root->size());
+    window.setGeometry(0, 0, root->width(), root->height());
+    root->setParentItem(window.contentItem());
+    QVERIFY(renderControl.initialize());
+
+    const QSize size = root->size().toSize();
+#ifdef SCENEGRAPHPIPELINE_SOFTWARE
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    window.setRenderTarget(QQuickRenderTarget::fromPaintDevice(&image));
+#else
+    QRhi *rhi = renderControl.rhi();
+    QVERIFY(rhi);
+    QCOMPARE(rhi->backend(), QRhi::Null);
+
+    QScopedPointer<QRhiTexture> texture(
+            rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiRenderBuffer> depthStencil(
+            rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+    QVERIFY(depthStencil->create());
+    QRhiTextureRenderTargetDescription description(QRhiColorAttachment(texture.data()));
+    description.setDepthStencilBuffer(depthStencil.data());
+    QScopedPointer<QRhiTextureRenderTarget> renderTarget(rhi->newTextureRenderTarget(description));
+    QScopedPointer<QRhiRenderPassDescriptor> renderPass(
+            renderTarget->newCompatibleRenderPassDescriptor());
+    renderTarget->setRenderPassDescriptor(renderPass.data());
+    QVERIFY(renderTarget->create());
+    window.setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(renderTarget.data()));
+#endif
+
+    int frame = 0;
+    const auto renderFrame = [&]() {
+        root->setProperty("frame", ++frame);
+        renderControl.polishItems();
+        renderControl.beginFrame();
+        renderControl.sync();
+        renderControl.render();
+        renderControl.endFrame();
+    };
+
+    // The first frames build the scene graph and load the images.
+    for (int i = 0; i < 3; ++i)
+        renderFrame();
+
+    QQuickFrameStatistics *statistics = window.frameStatistics();
+    statistics->setHistorySize(1000);
+    statistics->reset();
+    QBENCHMARK {
+        renderFrame();
+    }
+    QVERIFY(statistics->frameCount() > 0);
+
+    using Metric = QQuickFrameStatistics::Metric;
+    qInfo("%s: polish %.3f ms, sync %.3f ms, render %.3f ms, %.0f batches, %.0f bytes uploaded, "
+          "%.0f pixels painted per frame",
+          QTest::currentDataTag(),
+          statistics->average(Metric::PolishTime),
+          statistics->average(Metric::SyncTime),
+          statistics->average(Metric::RenderTime),
+          statistics->average(Metric::BatchCount),
+          statistics->average(Metric::UploadBytes),
+          statistics->average(Metric::PaintedArea));
+}
+
+QTEST_MAIN(tst_SceneGraphPipeline)
+
+#include "tst_scenegraphpipeline.moc"
@@ -0,0 +1,37 @@
+import QtQuick
+
+Rectangle {
+    id: root
+    width: 1920
+    height: 1080
+    color: "white"
+
+    // Cells with an index below animatedCells change on every frame.
+    property int animatedCells: 0
+    property int frame: 0
+
+    Grid {
+        columns: 24
+        Repeater {
+            model: 24 * 13
+            Rectangle {
+                readonly property bool animated: index < root.animatedCells
+                width: 80
+                height: 83
+                radius: 8
+                border.width: 2
+                border.color: "black"
+                gradient: Gradient {
+                    GradientStop { position: 0; color: "lightsteelblue" }
+                    GradientStop { position: 1; color: animated ? Qt.hsla((index + root.frame) % 36 / 36, 0.6, 0.5, 1) : "slategray" }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: animated ? root.frame % 1000 : index
+                    font.pixelSize: 20
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtGui/qimage.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickrendercontrol.h>
+#include <QtQuick/qquickrendertarget.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuickTestUtils/private/qmlutils_p.h>
+
+// Measures how fast the software adaptation repaints a 1920x1080 scene, when
+// all of it changes and when only one row of cells does, with the dirty region
+// painted on one thread or split into tiles painted in parallel.
+class tst_SoftwareRasterization : public QQmlDataTest
+{
+    Q_OBJECT
+
+public:
+    tst_SoftwareRasterization();
+
+private slots:
+    void initTestCase() override;
+    void repaint_data();
+    void repaint();
+};
+
+tst_SoftwareRasterization::tst_SoftwareRasterization()
+    : QQmlDataTest(QT_QMLTEST_DATADIR)
+{
+}
+
+void tst_SoftwareRasterization::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+}
+
+void tst_SoftwareRasterization::repaint_data()
+{
+    QTest::addColumn<int>("animatedCells");
+    QTest::addColumn<QByteArray>("threads");
+
+    const int allCells = 24 * 13;
+    const int oneRow = 24;
+    QTest::newRow("fullscreen-serial") << allCells << QByteArray("1");
+    QTest::newRow("fullscreen-parallel") << allCells << QByteArray();
+    QTest::newRow("partial-serial") << oneRow << QByteArray("1");
+    QTest::newRow("partial-parallel") << oneRow << QByteArray();
+}
+
+void tst_SoftwareRasterization::repaint()
+{
+    QFETCH(int, animatedCells);
+    QFETCH(QByteArray, threads);
+
+    // Read when the renderer is created on the first sync
+    if (threads.isEmpty())
+        qunsetenv("QSG_SOFTWARE_RENDER_THREADS");
+    else
+        qputenv("QSG_SOFTWARE_RENDER_THREADS", threads);
+
+    QQuickRenderControl renderControl;
+    QQuickWindow window(&renderControl);
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("cells.qml"));
+    QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem *>(
+            component.createWithInitialProperties({ { "animatedCells", animatedCells } })));
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    window.contentItem()->setSize(root->size());
+    window.setGeometry(0, 0, root->width(), root->height());
+    root->setParentItem(window.contentItem());
+    QVERIFY(renderControl.initialize());
+
+    QImage image(root->size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    window.setRenderTarget(QQuickRenderTarget::fromPaintDevice(&image));
+
+    int frame = 0;
+    const auto renderFrame = [&]() {
+        root->setProperty("frame", ++frame);
+        renderControl.polishItems();
+        renderControl.beginFrame();
+        renderControl.sync();
+        renderControl.render();
+        renderControl.endFrame();
+    };
+
+    // The first frame paints everything.
+    renderFrame();
+
+    qint64 frames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        renderFrame();
+        ++frames;
+    }
+    const double milliseconds = timer.nsecsElapsed() / 1000000.0;
+    qInfo("%s: %.2f ms/frame", QTest::currentDataTag(), milliseconds / frames);
+
+    qunsetenv("QSG_SOFTWARE_RENDER_THREADS");
+}
+
+QTEST_MAIN(tst_SoftwareRasterization)
+
+#include "tst_softwarerasterization.moc"
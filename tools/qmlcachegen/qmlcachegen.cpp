@@ -121,6 +121,7 @@ int main(int argc, char **argv)
     enum Output {
         GenerateCpp,
         GenerateCacheFile,
+        GenerateCacheBundle,
         GenerateLoader,
         GenerateLoaderStandAlone,
     } target = GenerateCacheFile;
@@ -138,10 +139,14 @@ int main(int argc, char **argv)
     if (target == GenerateLoader && parser.isSet(resourceNameOption))
         target = GenerateLoaderStandAlone;
 
+    if (outputFileName.endsWith(QLatin1String(".qmlcb")))
+        target = GenerateCacheBundle;
+
     const QStringList sources = parser.positionalArguments();
     if (sources.isEmpty()){
         parser.showHelp();
-    } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone)) {
+    } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone
+                                      && target != GenerateCacheBundle)) {
         fprintf(stderr, "%s\n", qPrintable(QStringLiteral("Too many input files specified: '") + sources.join(QStringLiteral("' '")) + QLatin1Char('\'')));
         return EXIT_FAILURE;
     }
@@ -175,6 +180,49 @@ int main(int argc, char **argv)
         }
         return EXIT_SUCCESS;
     }
+    if (target == GenerateCacheBundle) {
+        // The type loader finds the units by the file names of the sources,
+        // in the directory the bundle is installed to.
+        QList<QQmlJSBundledUnit> units;
+        for (const QString &source : sources) {
+            QByteArray data;
+            const QQmlJSSaveFunction saveFunction = [&data](
+                    const QV4::CompiledData::SaveableUnitPointer &unit,
+                    const QQmlJSAotFunctionMap &, QString *) {
+                return unit.saveToDisk<char>([&data](const char *unitData, quint32 size) {
+                    data = QByteArray(unitData, size);
+                    return true;
+                });
+            };
+
+            QQmlJSCompileError error;
+            if (source.endsWith(QLatin1String(".qml"))) {
+                if (!qCompileQmlFile(source, saveFunction, nullptr, &error,
+                                     /* storeSourceLocation */ false)) {
+                    error.augment(QStringLiteral("Error compiling qml file: ")).print();
+                    return EXIT_FAILURE;
+                }
+            } else if (source.endsWith(QLatin1String(".js")) || source.endsWith(QLatin1String(".mjs"))) {
+                if (!qCompileJSFile(source, source, saveFunction, &error)) {
+                    error.augment(QLatin1String("Error compiling js file: ")).print();
+                    return EXIT_FAILURE;
+                }
+            } else {
+                fprintf(stderr, "Ignoring %s input file as it is not QML source code - maybe remove from QML_FILES?\n", qPrintable(source));
+                continue;
+            }
+
+            units.append({ QFileInfo(source).fileName(), std::move(data) });
+        }
+
+        QString errorString;
+        if (!qSaveQmlJSUnitBundle(outputFileName, std::move(units), &errorString)) {
+            fprintf(stderr, "Error writing cache bundle: %s\n", qPrintable(errorString));
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     QString inputFileUrl = inputFile;
 
     QQmlJSSaveFunction saveFunction;
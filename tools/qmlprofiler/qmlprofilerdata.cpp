@@ -37,7 +37,10 @@ static const char *MESSAGE_STRINGS[] = {
     "PixmapCache",
     "SceneGraph",
     "MemoryAllocation",
-    "DebugMessage"
+    "DebugMessage",
+    "Quick3DFrame",
+    "PropertyLookup",
+    "GarbageCollection"
 };
 
 Q_STATIC_ASSERT(sizeof(MESSAGE_STRINGS) == MaximumMessage * sizeof(const char *));
@@ -186,6 +189,19 @@ void QmlProfilerData::addEventType(const QQmlProfilerEventType &type)
     case DebugMessage:
         displayName = QString::fromLatin1("DebugMessage:%1").arg(type.detailType());
         break;
+    case Quick3DFrame:
+        displayName = QString::fromLatin1("Quick3D:%1").arg(type.detailType());
+        break;
+    case PropertyLookup: {
+        const QString filePath = QUrl(type.location().filename()).path();
+        displayName = QLatin1String("PropertyLookup:")
+                + QStringView{filePath}.mid(filePath.lastIndexOf(QLatin1Char('/')) + 1)
+                + QLatin1Char(':') + QString::number(type.location().line());
+        break;
+    }
+    case GarbageCollection:
+        displayName = QString::fromLatin1("GarbageCollection:%1").arg(type.detailType());
+        break;
     case MaximumMessage: {
         const QQmlProfilerEventLocation eventLocation = type.location();
         // generate hash
@@ -435,6 +451,8 @@ bool QmlProfilerData::save(const QString &filename)
             stream.writeTextElement("sgEventType", eventData.detailType());
         else if (eventData.message() == MemoryAllocation)
             stream.writeTextElement("memoryEventType", eventData.detailType());
+        else if (eventData.message() == GarbageCollection)
+            stream.writeTextElement("gcEventType", eventData.detailType());
         stream.writeEndElement();
     }
     stream.writeEndElement(); // eventData
@@ -477,6 +495,11 @@ bool QmlProfilerData::save(const QString &filename)
             stream.writeAttribute("timing5", event, 4, false);
         } else if (type.message() == MemoryAllocation) {
             stream.writeAttribute("amount", event, 0);
+        } else if (type.message() == GarbageCollection) {
+            stream.writeAttribute("duration", event, 0);
+        } else if (type.message() == PropertyLookup) {
+            stream.writeAttribute("lookupResult", event, 0);
+            stream.writeAttribute("count", event, 1);
         }
         stream.writeEndElement();
     };